@@ -30,6 +30,14 @@
  *
  * #CallyActor implements the required ATK interfaces of #ClutterActor
  * exposing the common elements on each actor (position, extents, etc).
+ *
+ * When a child is added to, or removed from, an actor, #CallyActor
+ * emits the #AtkObject::children-changed signal with the index of the
+ * child, but it does not create the accessible of the child just to
+ * emit the signal: if the child has no accessible yet, the child
+ * argument of the signal is %NULL. Listeners should use
+ * atk_object_ref_accessible_child() with the index to retrieve the
+ * accessible of an added child.
  */
 
 /*
@@ -83,6 +91,8 @@
 #include "cally-actor.h"
 #include "cally-actor-private.h"
 
+#include "clutter-actor-private.h"
+
 typedef struct _CallyActorActionInfo CallyActorActionInfo;
 
 /*< private >
@@ -190,10 +200,17 @@ struct _CallyActorPrivate
   GQueue *action_queue;
   guint   action_idle_handler;
   GList  *action_list;
-
-  GList *children;
 };
 
+/* the accessible created for a ClutterActor, if any */
+static GQuark quark_accessible = 0;
+
+static inline AtkObject *
+cally_actor_peek_accessible (ClutterActor *actor)
+{
+  return g_object_get_qdata (G_OBJECT (actor), quark_accessible);
+}
+
 /**
  * cally_actor_new:
  * @actor: a #ClutterActor
@@ -224,15 +241,11 @@ static void
 cally_actor_initialize (AtkObject *obj,
                         gpointer   data)
 {
-  CallyActor        *self  = NULL;
-  CallyActorPrivate *priv  = NULL;
   ClutterActor     *actor = NULL;
   guint             handler_id;
 
   ATK_OBJECT_CLASS (cally_actor_parent_class)->initialize (obj, data);
 
-  self = CALLY_ACTOR(obj);
-  priv = self->priv;
   actor = CLUTTER_ACTOR (data);
 
   g_signal_connect (actor,
@@ -243,7 +256,10 @@ cally_actor_initialize (AtkObject *obj,
   g_object_set_data (G_OBJECT (obj), "atk-component-layer",
                      GINT_TO_POINTER (ATK_LAYER_MDI));
 
-  priv->children = clutter_actor_get_children (actor);
+  /* lets the accessible of the parent know whether the accessible
+   * of this actor exists, without creating it
+   */
+  g_object_set_qdata (G_OBJECT (actor), quark_accessible, obj);
 
   /*
    * We store the handler ids for these signals in case some objects
@@ -289,6 +305,8 @@ cally_actor_class_init (CallyActorClass *klass)
   class->get_attributes      = cally_actor_get_attributes;
 
   g_type_class_add_private (gobject_class, sizeof (CallyActorPrivate));
+
+  quark_accessible = g_quark_from_static_string ("cally-actor-accessible");
 }
 
 static void
@@ -302,8 +320,6 @@ cally_actor_init (CallyActor *cally_actor)
   priv->action_idle_handler = 0;
 
   priv->action_list = NULL;
-
-  priv->children = NULL;
 }
 
 
@@ -329,12 +345,6 @@ cally_actor_finalize (GObject *obj)
       g_queue_free (priv->action_queue);
     }
 
-  if (priv->children)
-    {
-      g_list_free (priv->children);
-      priv->children = NULL;
-    }
-
   G_OBJECT_CLASS (cally_actor_parent_class)->finalize (obj);
 }
 
@@ -378,13 +388,19 @@ cally_actor_get_index_in_parent (AtkObject *obj)
 {
   CallyActor *cally_actor = NULL;
   ClutterActor *actor = NULL;
-  ClutterActor *parent_actor = NULL;
-  ClutterActor *iter;
-  gint index = -1;
 
   g_return_val_if_fail (CALLY_IS_ACTOR (obj), -1);
 
-  if (obj->accessible_parent)
+  cally_actor = CALLY_ACTOR (obj);
+  actor = CALLY_GET_CLUTTER_ACTOR (cally_actor);
+
+  /* if the accessible parent is the one of the Clutter parent we can
+   * avoid querying all its children
+   */
+  if (obj->accessible_parent &&
+      !(actor != NULL &&
+        CALLY_IS_ACTOR (obj->accessible_parent) &&
+        CALLY_GET_CLUTTER_ACTOR (obj->accessible_parent) == clutter_actor_get_parent (actor)))
     {
       gint n_children, i;
       gboolean found = FALSE;
@@ -405,24 +421,10 @@ cally_actor_get_index_in_parent (AtkObject *obj)
       return -1;
     }
 
-  cally_actor = CALLY_ACTOR (obj);
-  actor = CALLY_GET_CLUTTER_ACTOR (cally_actor);
   if (actor == NULL) /* Object is defunct */
     return -1;
 
-  index = 0;
-  parent_actor = clutter_actor_get_parent (actor);
-  if (parent_actor == NULL)
-    return -1;
-
-  for (iter = clutter_actor_get_first_child (parent_actor);
-       iter != NULL && iter != actor;
-       iter = clutter_actor_get_next_sibling (iter))
-    {
-      index += 1;
-    }
-
-  return index;
+  return _clutter_actor_get_child_index (actor);
 }
 
 static AtkStateSet*
@@ -576,21 +578,21 @@ cally_actor_real_add_actor (ClutterActor *container,
                             gpointer      data)
 {
   AtkObject        *atk_parent = ATK_OBJECT (data);
-  AtkObject        *atk_child  = clutter_actor_get_accessible (actor);
-  CallyActor        *cally_actor = CALLY_ACTOR (atk_parent);
-  CallyActorPrivate *priv       = cally_actor->priv;
+  AtkObject        *atk_child  = NULL;
   gint              index;
 
   g_return_val_if_fail (CLUTTER_IS_CONTAINER (container), 0);
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), 0);
 
-  g_object_notify (G_OBJECT (atk_child), "accessible_parent");
-
-  g_list_free (priv->children);
-
-  priv->children = clutter_actor_get_children (CLUTTER_ACTOR (container));
+  /* we do not create the accessible of the child here; if there is
+   * none yet, the signal carries a NULL child, and the listeners can
+   * query it using the index
+   */
+  atk_child = cally_actor_peek_accessible (actor);
+  if (atk_child != NULL)
+    g_object_notify (G_OBJECT (atk_child), "accessible_parent");
 
-  index = g_list_index (priv->children, actor);
+  index = _clutter_actor_get_child_index (actor);
   g_signal_emit_by_name (atk_parent, "children_changed::add",
                          index, atk_child, NULL);
 
@@ -605,14 +607,13 @@ cally_actor_real_remove_actor (ClutterActor *container,
   AtkPropertyValues  values      = { NULL };
   AtkObject*         atk_parent  = NULL;
   AtkObject         *atk_child   = NULL;
-  CallyActorPrivate  *priv        = NULL;
   gint               index;
 
   g_return_val_if_fail (CLUTTER_IS_CONTAINER (container), 0);
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), 0);
 
   atk_parent = ATK_OBJECT (data);
-  atk_child = clutter_actor_get_accessible (actor);
+  atk_child = cally_actor_peek_accessible (actor);
 
   if (atk_child)
     {
@@ -627,13 +628,8 @@ cally_actor_real_remove_actor (ClutterActor *container,
       g_object_unref (atk_child);
     }
 
-  priv = CALLY_ACTOR (atk_parent)->priv;
-  index = g_list_index (priv->children, actor);
-  g_list_free (priv->children);
-
-  priv->children = clutter_actor_get_children (CLUTTER_ACTOR (container));
-
-  if (index >= 0 && index <= g_list_length (priv->children))
+  index = _clutter_actor_get_removed_child_index (actor);
+  if (index >= 0)
     g_signal_emit_by_name (atk_parent, "children_changed::remove",
                            index, atk_child, NULL);
 
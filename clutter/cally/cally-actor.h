@@ -92,9 +92,11 @@ struct _CallyActor
  * @focus_clutter: Signal handler for key-focus-in and key-focus-out
  *   signal on Clutter actor. This virtual functions is deprecated.
  * @add_actor: Signal handler for actor-added signal on
- *   ClutterContainer interface
- * @remove_actor: Signal handler for actor-added signal on
- *   ClutterContainer interface
+ *   ClutterContainer interface; emits #AtkObject::children-changed
+ *   with a %NULL child if the child has no accessible yet
+ * @remove_actor: Signal handler for actor-removed signal on
+ *   ClutterContainer interface; emits #AtkObject::children-changed
+ *   with a %NULL child if the child has no accessible
  *
  * The <structname>CallyActorClass</structname> structure contains
  * only private data
@@ -237,6 +237,8 @@ ClutterTransition *             _clutter_actor_get_transition
 gboolean                        _clutter_actor_foreach_child                            (ClutterActor *self,
                                                                                          ClutterForeachCallback callback,
                                                                                          gpointer user_data);
+gint                            _clutter_actor_get_child_index                          (ClutterActor *self);
+gint                            _clutter_actor_get_removed_child_index                  (ClutterActor *self);
 void                            _clutter_actor_traverse                                 (ClutterActor *actor,
                                                                                          ClutterActorTraverseFlags flags,
                                                                                          ClutterTraverseCallback before_children_callback,
@@ -286,6 +288,8 @@ void                            _clutter_actor_finish_queue_redraw
 gboolean                        _clutter_actor_set_default_paint_volume                 (ClutterActor       *self,
                                                                                          GType               check_gtype,
                                                                                          ClutterPaintVolume *volume);
+void                            _clutter_actor_set_has_paint_box                        (ClutterActor       *self,
+                                                                                         gboolean            has_paint_box);
 
 const gchar *                   _clutter_actor_get_debug_name                           (ClutterActor *self);
 
@@ -293,6 +297,11 @@ void                            _clutter_actor_push_clone_paint
 void                            _clutter_actor_pop_clone_paint                          (void);
 
 guint32                         _clutter_actor_get_pick_id                              (ClutterActor *self);
+gboolean                        _clutter_actor_pick_geometry                            (ClutterActor     *stage,
+                                                                                         ClutterPickMode   mode,
+                                                                                         gint              x,
+                                                                                         gint              y,
+                                                                                         ClutterActor    **hit);
 
 void                            _clutter_actor_shader_pre_paint                         (ClutterActor *actor,
                                                                                          gboolean      repeat);
@@ -309,6 +318,14 @@ void                            _clutter_actor_detach_clone
                                                                                          ClutterActor *clone);
 void                            _clutter_actor_queue_redraw_on_clones                   (ClutterActor *actor);
 void                            _clutter_actor_queue_relayout_on_clones                 (ClutterActor *actor);
+void                            _clutter_actor_allocate_relayout_root                   (ClutterActor *self);
+
+gboolean                        _clutter_actor_compute_transition_value                 (ClutterActor    *self,
+                                                                                         GParamSpec      *pspec,
+                                                                                         ClutterInterval *interval,
+                                                                                         gdouble          progress);
+void                            _clutter_actor_begin_transition_notify_batch            (void);
+void                            _clutter_actor_end_transition_notify_batch              (void);
 
 G_END_DECLS
 
@@ -666,6 +666,12 @@ struct _ClutterActorPrivate
   ClutterActorBox allocation;
   ClutterAllocationFlags allocation_flags;
 
+  /* the box and flags passed to clutter_actor_allocate() by the parent,
+   * used to allocate a relayout root on its own
+   */
+  ClutterActorBox parent_allocation;
+  ClutterAllocationFlags parent_allocation_flags;
+
   /* clip, in actor coordinates */
   ClutterRect clip;
 
@@ -690,6 +696,25 @@ struct _ClutterActorPrivate
 
   gint n_children;
 
+  /* the children in paint order, kept alongside the sibling pointers
+   * once an actor has enough children to make walking the list for
+   * index and depth lookups too expensive
+   */
+  GSequence *children_index;
+
+  /* the number of adjacent children not sorted by depth; the index
+   * can only be bisected by depth if this is 0
+   */
+  gint n_depth_inversions;
+
+  /* our position inside the children_index of the parent */
+  GSequenceIter *index_iter;
+
+  /* our position inside the parent we were last removed from, for
+   * the handlers of ClutterContainer::actor-removed
+   */
+  gint removed_index;
+
   /* tracks whenever the children of an actor are changed; the
    * age is incremented by 1 whenever an actor is added or
    * removed. the age is not incremented when the first or the
@@ -713,6 +738,43 @@ struct _ClutterActorPrivate
    */
   ClutterTextDirection text_direction;
 
+  /* the cached transformation from the actor's coordinate space to
+   * the stage's coordinate space; see clutter_actor_ensure_stage_transform()
+   */
+  CoglMatrix stage_transform;
+  guint stage_transform_generation;
+  guint stage_transform_parent_generation;
+  guint stage_transform_epoch;
+  ClutterActor *stage_transform_root;
+
+  /* set from clutter_actor_paint_box_serial every time our
+   * transformation changes; see clutter_actor_get_paint_box_generation()
+   */
+  guint paint_box_serial;
+
+  /* the generation of the transformation used for the paint box stored
+   * by the stage, and our own generation the last time all our mapped
+   * children stored a paint box; see clutter_actor_real_paint()
+   */
+  guint paint_box_generation;
+  guint children_paint_box_generation;
+
+  /* our position among the children of our parent the last time the
+   * parent painted all of them; see clutter_actor_real_paint()
+   */
+  guint paint_order;
+
+  /* the number of our children that are mapped, and the number of our
+   * children that have a paint box stored by the stage
+   */
+  gint n_mapped_children;
+  gint n_children_paint_boxes;
+
+  /* the number of descendants overriding ClutterActorClass.get_paint_volume,
+   * whose paint box may not cover their allocation
+   */
+  gint n_custom_paint_volumes;
+
   /* a counter used to toggle the CLUTTER_INTERNAL_CHILD flag */
   gint internal_child;
 
@@ -733,6 +795,12 @@ struct _ClutterActorPrivate
   ClutterScalingFilter mag_filter;
   ClutterContentRepeat content_repeat;
 
+  /* the paint node tree built for the last paint, retained until
+   * the actor queues a redraw or its size changes; the tree depends
+   * on the paint opacity, so we store the one used to build it */
+  ClutterPaintNode *paint_node_cache;
+  guint8 paint_node_cache_opacity;
+
   /* used when painting, to update the paint volume */
   ClutterEffect *current_effect;
 
@@ -798,6 +866,8 @@ struct _ClutterActorPrivate
   guint last_paint_volume_valid     : 1;
   guint in_clone_paint              : 1;
   guint transform_valid             : 1;
+  guint stage_transform_valid       : 1;
+  guint in_transition_notify_batch  : 1;
   /* This is TRUE if anything has queued a redraw since we were last
      painted. In this case effect_to_redraw will point to an effect
      the redraw was queued from or it will be NULL if the redraw was
@@ -811,6 +881,10 @@ struct _ClutterActorPrivate
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
   guint was_painted                 : 1;
+  guint relayout_root               : 1;
+  guint parent_allocation_valid     : 1;
+  guint has_paint_box               : 1;
+  guint children_redraw_queued      : 1;
 };
 
 enum
@@ -1008,6 +1082,8 @@ static ClutterPaintVolume *_clutter_actor_get_paint_volume_mutable (ClutterActor
 
 static guint8   clutter_actor_get_paint_opacity_internal        (ClutterActor *self);
 
+static void clutter_actor_invalidate_paint_node (ClutterActor *self);
+
 static inline void clutter_actor_set_background_color_internal (ClutterActor *self,
                                                                 const ClutterColor *color);
 
@@ -1015,6 +1091,11 @@ static void on_layout_manager_changed (ClutterLayoutManager *manager,
                                        ClutterActor         *self);
 
 static inline void clutter_actor_queue_compute_expand (ClutterActor *self);
+static inline void clutter_actor_invalidate_transform (ClutterActor *self);
+static gboolean clutter_actor_real_get_paint_volume (ClutterActor       *self,
+                                                     ClutterPaintVolume *volume);
+static gboolean clutter_actor_has_valid_paint_box (ClutterActor *self);
+static inline gboolean clutter_actor_has_custom_paint_volume (ClutterActor *self);
 
 static inline void clutter_actor_set_margin_internal (ClutterActor *self,
                                                       gfloat        margin,
@@ -1025,6 +1106,23 @@ static void clutter_actor_set_transform_internal (ClutterActor        *self,
 static void clutter_actor_set_child_transform_internal (ClutterActor        *self,
                                                         const ClutterMatrix *transform);
 
+/* incremented every time the transformation of an actor changes, or
+ * an actor changes parent; a cached stage transformation computed
+ * during the same epoch is valid without checking the ancestors
+ */
+static guint clutter_actor_transform_epoch = 1;
+
+/* the last generation assigned to a cached stage transformation; 0
+ * means "not cached", and 1 is used for the stage itself
+ */
+static guint clutter_actor_transform_serial = 1;
+
+/* the last serial assigned to the transformation of an actor, used to
+ * check the paint boxes stored by the stage; see
+ * clutter_actor_get_paint_box_generation()
+ */
+static guint clutter_actor_paint_box_serial = 1;
+
 static GQuark quark_actor_layout_info = 0;
 static GQuark quark_actor_transform_info = 0;
 static GQuark quark_actor_animation_info = 0;
@@ -1430,6 +1528,9 @@ clutter_actor_real_map (ClutterActor *self)
 
   CLUTTER_ACTOR_SET_FLAGS (self, CLUTTER_ACTOR_MAPPED);
 
+  if (priv->parent != NULL)
+    priv->parent->priv->n_mapped_children += 1;
+
   stage = _clutter_actor_get_stage_internal (self);
   priv->pick_id = _clutter_stage_acquire_pick_id (CLUTTER_STAGE (stage), self);
 
@@ -1507,12 +1608,19 @@ clutter_actor_real_unmap (ClutterActor *self)
 
   CLUTTER_ACTOR_UNSET_FLAGS (self, CLUTTER_ACTOR_MAPPED);
 
+  if (priv->parent != NULL)
+    priv->parent->priv->n_mapped_children -= 1;
+
   /* clear the contents of the last paint volume, so that hiding + moving +
    * showing will not result in the wrong area being repainted
    */
   _clutter_paint_volume_init_static (&priv->last_paint_volume, NULL);
   priv->last_paint_volume_valid = TRUE;
 
+  /* don't keep the resources used to paint the actor while it's
+   * hidden */
+  clutter_actor_invalidate_paint_node (self);
+
   /* notify on parent mapped after potentially unmapping
    * children, so apps see a bottom-up notification.
    */
@@ -1526,7 +1634,10 @@ clutter_actor_real_unmap (ClutterActor *self)
       stage = CLUTTER_STAGE (_clutter_actor_get_stage_internal (self));
 
       if (stage != NULL)
-        _clutter_stage_release_pick_id (stage, priv->pick_id);
+        {
+          _clutter_stage_release_pick_id (stage, priv->pick_id);
+          _clutter_stage_remove_actor_paint_box (stage, self);
+        }
 
       priv->pick_id = -1;
 
@@ -2060,6 +2171,291 @@ clutter_actor_should_pick_paint (ClutterActor *self)
   return FALSE;
 }
 
+/* Checks whether @point, in window coordinates, falls inside the
+ * quadrilateral described by the projected @verts; the vertices are
+ * in the order returned by clutter_actor_get_abs_allocation_vertices(),
+ * so we walk them as 0, 1, 3, 2 to go around the quad.
+ */
+static gboolean
+point_in_projected_quad (const ClutterVertex verts[],
+                         float               x,
+                         float               y)
+{
+  static const int quad_order[] = { 0, 1, 3, 2 };
+  gboolean has_positive = FALSE, has_negative = FALSE;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      const ClutterVertex *a = &verts[quad_order[i]];
+      const ClutterVertex *b = &verts[quad_order[(i + 1) % 4]];
+      float cross;
+
+      cross = (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+
+      if (cross > 0.f)
+        has_positive = TRUE;
+      else if (cross < 0.f)
+        has_negative = TRUE;
+
+      /* the winding depends on whether the actor has been flipped
+       * by its transformation, so we only care that the point is
+       * on the same side of every edge
+       */
+      if (has_positive && has_negative)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+box_contains_window_point (const CoglMatrix *modelview,
+                           const CoglMatrix *projection,
+                           const float      *viewport,
+                           float             x1,
+                           float             y1,
+                           float             x2,
+                           float             y2,
+                           float             x,
+                           float             y)
+{
+  ClutterVertex box_vertices[4], verts[4];
+
+  box_vertices[0].x = x1;
+  box_vertices[0].y = y1;
+  box_vertices[0].z = 0;
+  box_vertices[1].x = x2;
+  box_vertices[1].y = y1;
+  box_vertices[1].z = 0;
+  box_vertices[2].x = x1;
+  box_vertices[2].y = y2;
+  box_vertices[2].z = 0;
+  box_vertices[3].x = x2;
+  box_vertices[3].y = y2;
+  box_vertices[3].z = 0;
+
+  _clutter_util_fully_transform_vertices (modelview, projection, viewport,
+                                          box_vertices, verts,
+                                          4);
+
+  return point_in_projected_quad (verts, x, y);
+}
+
+typedef struct {
+  ClutterPickMode mode;
+  CoglMatrix projection;
+  float viewport[4];
+  float x, y;
+
+  /* the paint boxes stored by the stage, and the actors whose
+   * paint box contains the point */
+  ClutterSpatialIndex *paint_boxes;
+  GHashTable *candidates;
+} PickGeometryData;
+
+/* Mirrors the pick paint sequence of clutter_actor_paint() and
+ * clutter_actor_real_pick(), returning the topmost actor under the
+ * point described by @data in @hit; returns %FALSE if the sub-tree
+ * contains an actor that paints its own pick silhouette, in which
+ * case the result is meaningless and the caller should render a
+ * pick buffer instead.
+ */
+static gboolean
+clutter_actor_pick_geometry_recursive (ClutterActor           *self,
+                                       const CoglMatrix       *parent_modelview,
+                                       const PickGeometryData *data,
+                                       ClutterActor          **hit)
+{
+  ClutterActorPrivate *priv = self->priv;
+  CoglMatrix modelview;
+  ClutterActor *iter;
+  float width, height;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
+      !CLUTTER_ACTOR_IS_MAPPED (self))
+    return TRUE;
+
+  /* the paint box covers the allocation of the actor and its children,
+   * so if we know it and the point is outside of it, we can skip the
+   * whole sub-tree; an actor overriding get_paint_volume() may report a
+   * paint box smaller than its allocation, e.g. the ink rectangle of an
+   * empty ClutterText, so we cannot skip it, or any of its parents */
+  if (data->paint_boxes != NULL &&
+      priv->n_custom_paint_volumes == 0 &&
+      !clutter_actor_has_custom_paint_volume (self) &&
+      g_hash_table_lookup (data->candidates, self) == NULL &&
+      clutter_actor_has_valid_paint_box (self))
+    return TRUE;
+
+  if (CLUTTER_ACTOR_GET_CLASS (self)->pick != clutter_actor_real_pick)
+    return FALSE;
+
+  if (priv->effects != NULL)
+    {
+      const GList *l;
+
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          ClutterEffect *effect = l->data;
+
+          if (clutter_actor_meta_get_enabled (CLUTTER_ACTOR_META (effect)) &&
+              _clutter_effect_has_custom_pick (effect))
+            return FALSE;
+        }
+    }
+
+  modelview = *parent_modelview;
+  if (priv->enable_model_view_transform)
+    _clutter_actor_apply_modelview_transform (self, &modelview);
+
+  width = priv->allocation.x2 - priv->allocation.x1;
+  height = priv->allocation.y2 - priv->allocation.y1;
+
+  if (priv->has_clip)
+    {
+      if (!box_contains_window_point (&modelview,
+                                      &data->projection,
+                                      data->viewport,
+                                      priv->clip.origin.x,
+                                      priv->clip.origin.y,
+                                      priv->clip.origin.x + priv->clip.size.width,
+                                      priv->clip.origin.y + priv->clip.size.height,
+                                      data->x, data->y))
+        return TRUE;
+    }
+  else if (priv->clip_to_allocation)
+    {
+      if (!box_contains_window_point (&modelview,
+                                      &data->projection,
+                                      data->viewport,
+                                      0, 0, width, height,
+                                      data->x, data->y))
+        return TRUE;
+    }
+
+  /* children are painted after the actor, so they are on top of it;
+   * we walk them backwards to find the last painted one first
+   */
+  for (iter = priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    {
+      if (!clutter_actor_pick_geometry_recursive (iter, &modelview, data, hit))
+        return FALSE;
+
+      if (*hit != NULL)
+        return TRUE;
+    }
+
+  if ((data->mode == CLUTTER_PICK_ALL || CLUTTER_ACTOR_IS_REACTIVE (self)) &&
+      box_contains_window_point (&modelview,
+                                 &data->projection,
+                                 data->viewport,
+                                 0, 0, width, height,
+                                 data->x, data->y))
+    *hit = self;
+
+  return TRUE;
+}
+
+static void
+add_pick_candidate (gpointer               item,
+                    const ClutterActorBox *box,
+                    gpointer               user_data)
+{
+  g_hash_table_insert (user_data, item, item);
+}
+
+/*< private >
+ * _clutter_actor_pick_geometry:
+ * @stage: a #ClutterStage
+ * @mode: the #ClutterPickMode
+ * @x: X coordinate of the point, in window coordinates
+ * @y: Y coordinate of the point, in window coordinates
+ * @hit: (out): return location for the picked actor
+ *
+ * Picks the actor at (@x, @y) by testing the transformed allocation
+ * boxes of the children of @stage against the point, in paint order
+ * and honouring clips, without rendering anything. The sub-trees whose
+ * paint box, as stored by the stage, does not contain the point are
+ * skipped entirely.
+ *
+ * The result is the same actor that a pick render would find for
+ * every actor using the default #ClutterActorClass.pick implementation;
+ * if any actor on the path overrides it, or has an enabled
+ * #ClutterEffect overriding #ClutterEffectClass.pick, this function
+ * returns %FALSE and @hit is left untouched.
+ *
+ * Return value: %TRUE if the pick was resolved geometrically
+ */
+gboolean
+_clutter_actor_pick_geometry (ClutterActor     *stage,
+                              ClutterPickMode   mode,
+                              gint              x,
+                              gint              y,
+                              ClutterActor    **hit)
+{
+  PickGeometryData data;
+  CoglMatrix modelview;
+  ClutterActor *iter, *res = NULL;
+  gboolean retval = TRUE;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  data.mode = mode;
+  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage),
+                                        &data.projection);
+  _clutter_stage_get_viewport (CLUTTER_STAGE (stage),
+                               &data.viewport[0],
+                               &data.viewport[1],
+                               &data.viewport[2],
+                               &data.viewport[3]);
+
+  /* we test against the center of the pixel, which is what the
+   * rasterizer does when filling the pick buffer
+   */
+  data.x = x + 0.5f;
+  data.y = y + 0.5f;
+
+  data.paint_boxes = _clutter_stage_get_paint_box_index (CLUTTER_STAGE (stage));
+  data.candidates = NULL;
+
+  if (data.paint_boxes != NULL)
+    {
+      data.candidates = g_hash_table_new (NULL, NULL);
+      _clutter_spatial_index_query_point (data.paint_boxes,
+                                          data.x, data.y,
+                                          add_pick_candidate,
+                                          data.candidates);
+    }
+
+  cogl_matrix_init_identity (&modelview);
+  _clutter_actor_apply_modelview_transform (stage, &modelview);
+
+  for (iter = stage->priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    {
+      retval = clutter_actor_pick_geometry_recursive (iter, &modelview,
+                                                      &data,
+                                                      &res);
+      if (!retval || res != NULL)
+        break;
+    }
+
+  if (data.candidates != NULL)
+    g_hash_table_destroy (data.candidates);
+
+  /* the stage's pick id is handled by the clear color */
+  if (retval)
+    *hit = res != NULL ? res : stage;
+
+  return retval;
+}
+
 static void
 clutter_actor_real_get_preferred_width (ClutterActor *self,
                                         gfloat        for_height,
@@ -2273,7 +2669,15 @@ clutter_actor_set_allocation_internal (ClutterActor           *self,
       CLUTTER_NOTE (LAYOUT, "Allocation for '%s' changed",
                     _clutter_actor_get_debug_name (self));
 
-      priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
+
+      /* the paint nodes are in actor coordinates, so they only
+       * depend on the size of the allocation */
+      if (clutter_actor_box_get_width (&old_alloc) !=
+          clutter_actor_box_get_width (box) ||
+          clutter_actor_box_get_height (&old_alloc) !=
+          clutter_actor_box_get_height (box))
+        clutter_actor_invalidate_paint_node (self);
 
       g_object_notify_by_pspec (obj, obj_props[PROP_ALLOCATION]);
 
@@ -2489,11 +2893,103 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
   parent = clutter_actor_get_parent (self);
   if (parent != NULL)
     {
+      parent->priv->children_redraw_queued = TRUE;
+
       /* this will go up recursively */
       _clutter_actor_signal_queue_redraw (parent, origin);
     }
 }
 
+/*< private >
+ * clutter_actor_is_relayout_root:
+ * @self: a #ClutterActor
+ *
+ * Checks whether the relayouts queued by the children of @self can
+ * stop at @self, instead of going up to the stage.
+ *
+ * This is the case if @self has been explicitly marked as a relayout
+ * root, or if its size has been fixed, since the size request of
+ * @self does not depend on its children, and thus the layout of its
+ * ancestors is not going to change.
+ *
+ * Return value: %TRUE if @self is a relayout root
+ */
+static inline gboolean
+clutter_actor_is_relayout_root (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  /* we can only reuse an allocation that was already assigned */
+  if (!priv->parent_allocation_valid || priv->parent == NULL)
+    return FALSE;
+
+  /* the expand flags are computed from the children, and they are
+   * used by the layout of the parent
+   */
+  if (priv->needs_compute_expand)
+    return FALSE;
+
+  if (priv->relayout_root)
+    return TRUE;
+
+  return priv->min_width_set && priv->natural_width_set &&
+         priv->min_height_set && priv->natural_height_set;
+}
+
+static gboolean
+clutter_actor_queue_relayout_root (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return TRUE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  priv->needs_width_request  = TRUE;
+  priv->needs_height_request = TRUE;
+  priv->needs_allocation     = TRUE;
+
+  memset (priv->width_requests, 0,
+          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+  memset (priv->height_requests, 0,
+          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+
+  _clutter_actor_queue_relayout_on_clones (self);
+
+  _clutter_stage_queue_relayout_root (CLUTTER_STAGE (stage), self);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_allocate_relayout_root:
+ * @self: a #ClutterActor
+ *
+ * Allocates a relayout root using the box assigned to it by its
+ * parent during the last allocation.
+ */
+void
+_clutter_actor_allocate_relayout_root (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  /* the parent allocated the root in the meantime */
+  if (!priv->needs_allocation || !priv->parent_allocation_valid)
+    return;
+
+  CLUTTER_NOTE (LAYOUT, "Allocating relayout root '%s'",
+                _clutter_actor_get_debug_name (self));
+
+  clutter_actor_allocate (self,
+                          &priv->parent_allocation,
+                          priv->parent_allocation_flags &
+                          ~CLUTTER_ABSOLUTE_ORIGIN_CHANGED);
+}
+
 static void
 clutter_actor_real_queue_relayout (ClutterActor *self)
 {
@@ -2513,9 +3009,15 @@ clutter_actor_real_queue_relayout (ClutterActor *self)
   memset (priv->height_requests, 0,
           N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
 
-  /* We need to go all the way up the hierarchy */
+  /* We need to go all the way up the hierarchy, unless we find a
+   * relayout root on the way
+   */
   if (priv->parent != NULL)
-    _clutter_actor_queue_only_relayout (priv->parent);
+    {
+      if (!clutter_actor_is_relayout_root (priv->parent) ||
+          !clutter_actor_queue_relayout_root (priv->parent))
+        _clutter_actor_queue_only_relayout (priv->parent);
+    }
 }
 
 /**
@@ -2659,8 +3161,6 @@ clutter_actor_apply_transform_to_point (ClutterActor        *self,
  * instead.</para></note>
  *
  */
-/* XXX: We should consider caching the stage relative modelview along with
- * the actor itself */
 static void
 _clutter_actor_get_relative_transformation_matrix (ClutterActor *self,
                                                    ClutterActor *ancestor,
@@ -2955,6 +3455,101 @@ _clutter_actor_apply_modelview_transform (ClutterActor  *self,
   CLUTTER_ACTOR_GET_CLASS (self)->apply_transform (self, matrix);
 }
 
+static inline void
+clutter_actor_invalidate_transform (ClutterActor *self)
+{
+  self->priv->transform_valid = FALSE;
+  self->priv->stage_transform_valid = FALSE;
+  self->priv->paint_box_serial = ++clutter_actor_paint_box_serial;
+
+  /* the cached stage transformations of the children are checked
+   * lazily, through the generation of the parent's transformation
+   */
+  clutter_actor_transform_epoch += 1;
+}
+
+/*< private >
+ * clutter_actor_ensure_stage_transform:
+ * @self: a #ClutterActor
+ *
+ * Ensures that the transformation from the coordinate space of @self
+ * to the coordinate space of its stage is cached inside
+ * priv->stage_transform.
+ *
+ * The cached transformation is valid as long as the generation of
+ * the parent's transformation is the same that was used to compute
+ * it; if no transformation changed since the last check, the cache
+ * is valid without walking the ancestors at all.
+ *
+ * Only the actors using the default ClutterActorClass.apply_transform
+ * implementation, and whose ancestors do the same, can be cached, as
+ * we cannot track the state used by an overridden implementation.
+ *
+ * Return value: the generation of the cached transformation, or 0 if
+ *   the transformation of @self cannot be cached
+ */
+static guint
+clutter_actor_ensure_stage_transform (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *parent = priv->parent;
+  guint parent_generation;
+
+  if (priv->stage_transform_valid &&
+      priv->stage_transform_epoch == clutter_actor_transform_epoch)
+    return priv->stage_transform_generation;
+
+  if (parent == NULL ||
+      CLUTTER_ACTOR_IS_TOPLEVEL (self) ||
+      CLUTTER_ACTOR_GET_CLASS (self)->apply_transform != clutter_actor_real_apply_transform)
+    {
+      priv->stage_transform_valid = FALSE;
+      return 0;
+    }
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (parent))
+    parent_generation = 1;
+  else
+    parent_generation = clutter_actor_ensure_stage_transform (parent);
+
+  if (parent_generation == 0)
+    {
+      priv->stage_transform_valid = FALSE;
+      return 0;
+    }
+
+  if (priv->stage_transform_valid &&
+      priv->stage_transform_parent_generation == parent_generation)
+    {
+      priv->stage_transform_epoch = clutter_actor_transform_epoch;
+      return priv->stage_transform_generation;
+    }
+
+  if (parent_generation == 1)
+    {
+      cogl_matrix_init_identity (&priv->stage_transform);
+      priv->stage_transform_root = parent;
+    }
+  else
+    {
+      priv->stage_transform = parent->priv->stage_transform;
+      priv->stage_transform_root = parent->priv->stage_transform_root;
+    }
+
+  clutter_actor_real_apply_transform (self, &priv->stage_transform);
+
+  clutter_actor_transform_serial += 1;
+  if (G_UNLIKELY (clutter_actor_transform_serial < 2))
+    clutter_actor_transform_serial = 2;
+
+  priv->stage_transform_generation = clutter_actor_transform_serial;
+  priv->stage_transform_parent_generation = parent_generation;
+  priv->stage_transform_epoch = clutter_actor_transform_epoch;
+  priv->stage_transform_valid = TRUE;
+
+  return priv->stage_transform_generation;
+}
+
 /*
  * clutter_actor_apply_relative_transformation_matrix:
  * @self: The actor whose coordinate space you want to transform from.
@@ -2996,6 +3591,20 @@ _clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
   if (self == ancestor)
     return;
 
+  /* the common case is a transformation to the stage, or to the
+   * eye coordinates, which we can take from the cache */
+  if ((ancestor == NULL || CLUTTER_ACTOR_IS_TOPLEVEL (ancestor)) &&
+      clutter_actor_ensure_stage_transform (self) != 0 &&
+      (ancestor == NULL || ancestor == self->priv->stage_transform_root))
+    {
+      if (ancestor == NULL)
+        _clutter_actor_apply_modelview_transform (self->priv->stage_transform_root,
+                                                  matrix);
+
+      cogl_matrix_multiply (matrix, matrix, &self->priv->stage_transform);
+      return;
+    }
+
   parent = clutter_actor_get_parent (self);
 
   if (parent != NULL)
@@ -3217,11 +3826,179 @@ cull_actor (ClutterActor *self, ClutterCullResult *result_out)
   return TRUE;
 }
 
-static void
-_clutter_actor_update_last_paint_volume (ClutterActor *self)
+static inline gboolean
+clutter_actor_has_custom_paint_volume (ClutterActor *self)
 {
-  ClutterActorPrivate *priv = self->priv;
-  const ClutterPaintVolume *pv;
+  return CLUTTER_ACTOR_GET_CLASS (self)->get_paint_volume !=
+         clutter_actor_real_get_paint_volume;
+}
+
+/* Returns the generation of the transformation of a child of an actor
+ * whose generation is @parent_generation.
+ */
+static inline guint
+clutter_actor_get_child_paint_box_generation (ClutterActor *child,
+                                              guint         parent_generation)
+{
+  if (parent_generation == 0 ||
+      CLUTTER_ACTOR_GET_CLASS (child)->apply_transform != clutter_actor_real_apply_transform)
+    return 0;
+
+  return MAX (parent_generation, child->priv->paint_box_serial);
+}
+
+/* Returns the generation of the transformation the paint box of the
+ * actor depends on, or 0 if we cannot tell when it changes.
+ *
+ * The generation is the most recent serial assigned to the actor or to
+ * one of its ancestors, so it changes whenever the transformation of
+ * any of them changes, or when the actor is moved to another parent;
+ * the stage discards all the paint boxes when its own transformation
+ * changes. Overridden implementations of apply_transform() may depend
+ * on state we cannot track, so their actors and their children do not
+ * have a generation.
+ */
+static guint
+clutter_actor_get_paint_box_generation (ClutterActor *self)
+{
+  ClutterActor *parent = self->priv->parent;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return 1;
+
+  if (parent == NULL)
+    return 0;
+
+  return clutter_actor_get_child_paint_box_generation (self,
+                                                       clutter_actor_get_paint_box_generation (parent));
+}
+
+/*< private >
+ * _clutter_actor_set_has_paint_box:
+ * @self: a #ClutterActor
+ * @has_paint_box: whether the stage stores a paint box for @self
+ *
+ * Called by the stage whenever it stores or discards the paint box
+ * of @self.
+ */
+void
+_clutter_actor_set_has_paint_box (ClutterActor *self,
+                                  gboolean      has_paint_box)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  has_paint_box = !!has_paint_box;
+
+  if (priv->has_paint_box == has_paint_box)
+    return;
+
+  priv->has_paint_box = has_paint_box;
+
+  if (priv->parent != NULL)
+    priv->parent->priv->n_children_paint_boxes += has_paint_box ? 1 : -1;
+}
+
+/* Checks whether the paint box stored by the stage for the actor is
+ * still valid for the transformation @generation, discarding it
+ * otherwise.
+ *
+ * The stage discards the paint boxes of an actor and its parents when
+ * the actor queues a redraw, but not the ones of its children, so we
+ * also check that the transformation of the actor did not change
+ * since the paint box was stored.
+ */
+static gboolean
+clutter_actor_check_paint_box (ClutterActor *self,
+                               guint         generation)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (!priv->has_paint_box)
+    return FALSE;
+
+  if (generation != 0 && generation == priv->paint_box_generation)
+    return TRUE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage != NULL)
+    _clutter_stage_remove_actor_paint_box (CLUTTER_STAGE (stage), self);
+
+  return FALSE;
+}
+
+static gboolean
+clutter_actor_has_valid_paint_box (ClutterActor *self)
+{
+  if (!self->priv->has_paint_box)
+    return FALSE;
+
+  return clutter_actor_check_paint_box (self,
+                                        clutter_actor_get_paint_box_generation (self));
+}
+
+/* Returns the stage of the actor if the paint boxes stored by the
+ * stage can be compared with the clip of the current paint.
+ */
+static ClutterActor *
+get_paint_box_stage (ClutterActor *self)
+{
+  ClutterActor *stage;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  (CLUTTER_DEBUG_DISABLE_CULLING | CLUTTER_DEBUG_REDRAWS)))
+    return NULL;
+
+  if (_clutter_context_get_pick_mode () != CLUTTER_PICK_NONE ||
+      in_clone_paint ())
+    return NULL;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return NULL;
+
+  /* the clip does not apply when painting inside an offscreen buffer */
+  if (cogl_get_draw_framebuffer () !=
+      _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (stage)))
+    return NULL;
+
+  return stage;
+}
+
+/* Returns TRUE if the paint box of the actor, as stored by the stage
+ * the last time the actor was painted, lies outside the current clip;
+ * since the paint box includes the children of the actor, and it is
+ * discarded whenever the actor or one of its relatives queues a redraw,
+ * we can skip the whole sub-tree without visiting it.
+ */
+static gboolean
+paint_box_is_clipped (ClutterActor *self)
+{
+  ClutterActorBox box;
+  ClutterActor *stage;
+
+  stage = get_paint_box_stage (self);
+  if (stage == NULL || stage == self)
+    return FALSE;
+
+  if (!clutter_actor_has_valid_paint_box (self))
+    return FALSE;
+
+  if (!_clutter_stage_get_actor_paint_box (CLUTTER_STAGE (stage), self, &box))
+    return FALSE;
+
+  return _clutter_stage_paint_box_is_clipped (CLUTTER_STAGE (stage), &box);
+}
+
+static void
+_clutter_actor_update_last_paint_volume (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  const ClutterPaintVolume *pv;
+  ClutterActor *stage;
+  guint generation;
+
+  stage = _clutter_actor_get_stage_internal (self);
 
   if (priv->last_paint_volume_valid)
     {
@@ -3235,6 +4012,10 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
       CLUTTER_NOTE (CLIPPING, "Bail from update_last_paint_volume (%s): "
                     "Actor failed to report a paint volume",
                     _clutter_actor_get_debug_name (self));
+
+      if (stage != NULL)
+        _clutter_stage_remove_actor_paint_box (CLUTTER_STAGE (stage), self);
+
       return;
     }
 
@@ -3244,6 +4025,22 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
                                             NULL); /* eye coordinates */
 
   priv->last_paint_volume_valid = TRUE;
+
+  if (stage == NULL)
+    return;
+
+  /* we only store a paint box if we can tell when it becomes stale */
+  generation = clutter_actor_get_paint_box_generation (self);
+  if (generation == 0 ||
+      (priv->has_paint_box && priv->paint_box_generation != generation))
+    _clutter_stage_remove_actor_paint_box (CLUTTER_STAGE (stage), self);
+
+  if (generation != 0)
+    {
+      _clutter_stage_update_actor_paint_box (CLUTTER_STAGE (stage), self,
+                                             &priv->last_paint_volume);
+      priv->paint_box_generation = generation;
+    }
 }
 
 guint32
@@ -3352,16 +4149,132 @@ add_or_remove_flatten_effect (ClutterActor *self)
     }
 }
 
+/* the number of children above which clutter_actor_real_paint() tries
+ * to query the paint boxes of the children inside the current clip */
+#define CLIPPED_CHILDREN_THRESHOLD      32
+
+static void
+add_clipped_child (gpointer               item,
+                   const ClutterActorBox *box,
+                   gpointer               user_data)
+{
+  GPtrArray *children = user_data;
+  ClutterActor *child = item;
+
+  if (child->priv->parent == g_ptr_array_index (children, 0))
+    g_ptr_array_add (children, child);
+}
+
+static gint
+compare_child_paint_order (gconstpointer a,
+                           gconstpointer b)
+{
+  ClutterActor *child_a = *(ClutterActor * const *) a;
+  ClutterActor *child_b = *(ClutterActor * const *) b;
+
+  if (child_a->priv->paint_order < child_b->priv->paint_order)
+    return -1;
+
+  if (child_a->priv->paint_order > child_b->priv->paint_order)
+    return 1;
+
+  return 0;
+}
+
+/* Paints the children of an actor with many children by querying the
+ * paint boxes stored by the stage for the ones inside the current clip,
+ * instead of visiting all of them; this is only possible if all the
+ * mapped children have a valid paint box, which we know if none of them
+ * discarded its paint box, no child was added, removed or restacked,
+ * and our transformation did not change since all of them stored one.
+ *
+ * The children we skip are not going to reach clutter_actor_paint(),
+ * which is where their pending redraw state is reset, so if any child
+ * queued a redraw since the last time we painted all of them we also
+ * need to paint them the usual way.
+ *
+ * Returns FALSE if the children need to be painted the usual way.
+ */
+static gboolean
+clutter_actor_paint_clipped_children (ClutterActor *actor,
+                                      guint         generation)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  GPtrArray *children;
+  ClutterActor *stage;
+  gboolean retval;
+  guint i;
+
+  if (priv->n_children < CLIPPED_CHILDREN_THRESHOLD ||
+      priv->children_redraw_queued ||
+      generation == 0 ||
+      generation != priv->children_paint_box_generation ||
+      priv->n_children_paint_boxes != priv->n_mapped_children)
+    return FALSE;
+
+  stage = get_paint_box_stage (actor);
+  if (stage == NULL)
+    return FALSE;
+
+  /* the first element is the parent, for add_clipped_child() */
+  children = g_ptr_array_new ();
+  g_ptr_array_add (children, actor);
+
+  _clutter_stage_query_paint_boxes (CLUTTER_STAGE (stage),
+                                    add_clipped_child,
+                                    children);
+
+  retval = TRUE;
+  for (i = 1; i < children->len; i++)
+    {
+      ClutterActor *child = g_ptr_array_index (children, i);
+      guint child_generation;
+
+      child_generation =
+        clutter_actor_get_child_paint_box_generation (child, generation);
+
+      if (!clutter_actor_check_paint_box (child, child_generation))
+        {
+          retval = FALSE;
+          break;
+        }
+    }
+
+  if (retval)
+    {
+      g_ptr_array_remove_index (children, 0);
+      g_ptr_array_sort (children, compare_child_paint_order);
+
+      for (i = 0; i < children->len; i++)
+        clutter_actor_paint (g_ptr_array_index (children, i));
+    }
+
+  g_ptr_array_unref (children);
+
+  return retval;
+}
+
 static void
 clutter_actor_real_paint (ClutterActor *actor)
 {
   ClutterActorPrivate *priv = actor->priv;
   ClutterActor *iter;
+  guint generation;
+  guint paint_order;
 
-  for (iter = priv->first_child;
+  generation = priv->n_children >= CLIPPED_CHILDREN_THRESHOLD
+             ? clutter_actor_get_paint_box_generation (actor)
+             : 0;
+
+  if (clutter_actor_paint_clipped_children (actor, generation))
+    return;
+
+  for (iter = priv->first_child, paint_order = 0;
        iter != NULL;
-       iter = iter->priv->next_sibling)
+       iter = iter->priv->next_sibling, paint_order++)
     {
+      iter->priv->paint_order = paint_order;
+
       CLUTTER_NOTE (PAINT, "Painting %s, child of %s, at { %.2f, %.2f - %.2f x %.2f }",
                     _clutter_actor_get_debug_name (iter),
                     _clutter_actor_get_debug_name (actor),
@@ -3372,16 +4285,31 @@ clutter_actor_real_paint (ClutterActor *actor)
 
       clutter_actor_paint (iter);
     }
+
+  /* all the mapped children store a paint box after being painted,
+   * unless they cannot report a paint volume */
+  priv->children_paint_box_generation = generation;
+  priv->children_redraw_queued = FALSE;
 }
 
-static gboolean
-clutter_actor_paint_node (ClutterActor     *actor,
-                          ClutterPaintNode *root)
+static void
+clutter_actor_invalidate_paint_node (ClutterActor *self)
 {
-  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorPrivate *priv = self->priv;
 
-  if (root == NULL)
-    return FALSE;
+  if (priv->paint_node_cache != NULL)
+    {
+      clutter_paint_node_unref (priv->paint_node_cache);
+      priv->paint_node_cache = NULL;
+    }
+}
+
+static void
+clutter_actor_build_paint_node (ClutterActor     *actor,
+                                ClutterPaintNode *root,
+                                guint8            paint_opacity)
+{
+  ClutterActorPrivate *priv = actor->priv;
 
   if (priv->bg_color_set &&
       !clutter_color_equal (&priv->bg_color, CLUTTER_COLOR_Transparent))
@@ -3396,7 +4324,7 @@ clutter_actor_paint_node (ClutterActor     *actor,
       box.y2 = clutter_actor_box_get_height (&priv->allocation);
 
       bg_color = priv->bg_color;
-      bg_color.alpha = clutter_actor_get_paint_opacity_internal (actor)
+      bg_color.alpha = paint_opacity
                      * priv->bg_color.alpha
                      / 255;
 
@@ -3412,6 +4340,54 @@ clutter_actor_paint_node (ClutterActor     *actor,
 
   if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
     CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
+}
+
+/* the paint node tree of an actor is retained across frames, and
+ * it's only built again if the actor queued a redraw, changed size,
+ * or is being painted with a different opacity
+ */
+static gboolean
+clutter_actor_paint_node (ClutterActor *actor)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterPaintNode *root;
+  guint8 paint_opacity;
+
+  CLUTTER_STATIC_COUNTER (paint_node_retained_counter,
+                          "Retained paint node trees",
+                          "Increments each time an actor paints the "
+                          "paint node tree built for a previous frame",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (paint_node_rebuilt_counter,
+                          "Rebuilt paint node trees",
+                          "Increments each time an actor builds its "
+                          "paint node tree",
+                          0 /* no application private data */);
+
+  paint_opacity = clutter_actor_get_paint_opacity_internal (actor);
+
+  if (priv->paint_node_cache != NULL &&
+      priv->paint_node_cache_opacity != paint_opacity)
+    clutter_actor_invalidate_paint_node (actor);
+
+  if (priv->paint_node_cache == NULL)
+    {
+      root = _clutter_dummy_node_new (actor);
+      clutter_paint_node_set_name (root, "Root");
+
+      clutter_actor_build_paint_node (actor, root, paint_opacity);
+
+      priv->paint_node_cache = root;
+      priv->paint_node_cache_opacity = paint_opacity;
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, paint_node_rebuilt_counter);
+    }
+  else
+    {
+      root = priv->paint_node_cache;
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, paint_node_retained_counter);
+    }
 
   if (clutter_paint_node_get_n_children (root) == 0)
     return FALSE;
@@ -3492,6 +4468,17 @@ clutter_actor_paint (ClutterActor *self)
   if (!CLUTTER_ACTOR_IS_MAPPED (self))
     return;
 
+  /* skip the actor and its children if they were outside the clip the
+   * last time we painted them, and nothing changed since */
+  if (pick_mode == CLUTTER_PICK_NONE &&
+      !in_clone_paint () &&
+      paint_box_is_clipped (self))
+    {
+      /* like culling, this counts as a complete paint */
+      priv->is_dirty = FALSE;
+      return;
+    }
+
   /* mark that we are in the paint process */
   CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 
@@ -3690,21 +4677,15 @@ clutter_actor_continue_paint (ClutterActor *self)
     {
       if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
         {
-          ClutterPaintNode *dummy;
-
           /* XXX - this will go away in 2.0, when we can get rid of this
            * stuff and switch to a pure retained render tree of PaintNodes
            * for the entire frame, starting from the Stage; the paint()
            * virtual function can then be called directly.
-           */
-          dummy = _clutter_dummy_node_new (self);
-          clutter_paint_node_set_name (dummy, "Root");
-
-          /* XXX - for 1.12, we use the return value of paint_node() to
+           *
+           * XXX - for 1.12, we use the return value of paint_node() to
            * decide whether we should emit the ::paint signal.
            */
-          clutter_actor_paint_node (self, dummy);
-          clutter_paint_node_unref (dummy);
+          clutter_actor_paint_node (self);
 
           CLUTTER_ACTOR_GET_CLASS (self)->paint (self);
 
@@ -3808,15 +4789,243 @@ invalidate_queue_redraw_entry (ClutterActor *self,
                                int           depth,
                                gpointer      user_data)
 {
-  ClutterActorPrivate *priv = self->priv;
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->queue_redraw_entry != NULL)
+    {
+      _clutter_stage_queue_redraw_entry_invalidate (priv->queue_redraw_entry);
+      priv->queue_redraw_entry = NULL;
+    }
+
+  return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
+}
+
+/* the number of children above which we keep an index of them */
+#define CHILDREN_INDEX_THRESHOLD        32
+
+static inline float
+get_child_depth (ClutterActor *child)
+{
+  return _clutter_actor_get_transform_info_or_defaults (child)->z_position;
+}
+
+static inline gint
+count_depth_inversion (ClutterActor *first,
+                       ClutterActor *second)
+{
+  if (first == NULL || second == NULL)
+    return 0;
+
+  return get_child_depth (first) > get_child_depth (second) ? 1 : 0;
+}
+
+/*< private >
+ * clutter_actor_ensure_children_index:
+ * @self: a #ClutterActor
+ *
+ * Creates the index of the children of @self, if @self has enough
+ * children to need one.
+ */
+static void
+clutter_actor_ensure_children_index (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *iter;
+
+  if (priv->children_index != NULL ||
+      priv->n_children < CHILDREN_INDEX_THRESHOLD)
+    return;
+
+  priv->children_index = g_sequence_new (NULL);
+  priv->n_depth_inversions = 0;
+
+  for (iter = priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    {
+      iter->priv->index_iter = g_sequence_append (priv->children_index, iter);
+      priv->n_depth_inversions +=
+        count_depth_inversion (iter->priv->prev_sibling, iter);
+    }
+}
+
+/*< private >
+ * children_index_insert:
+ * @self: a #ClutterActor
+ * @child: a child of @self, already linked to its siblings
+ *
+ * Adds @child to the index of the children of @self, if any.
+ */
+static inline void
+children_index_insert (ClutterActor *self,
+                       ClutterActor *child)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *prev_sibling, *next_sibling;
+
+  if (priv->children_index == NULL)
+    return;
+
+  prev_sibling = child->priv->prev_sibling;
+  next_sibling = child->priv->next_sibling;
+
+  if (next_sibling != NULL)
+    child->priv->index_iter =
+      g_sequence_insert_before (next_sibling->priv->index_iter, child);
+  else
+    child->priv->index_iter = g_sequence_append (priv->children_index, child);
+
+  priv->n_depth_inversions -= count_depth_inversion (prev_sibling, next_sibling);
+  priv->n_depth_inversions += count_depth_inversion (prev_sibling, child)
+                            + count_depth_inversion (child, next_sibling);
+}
+
+/*< private >
+ * children_index_remove:
+ * @self: a #ClutterActor
+ * @child: a child of @self, still linked to its siblings
+ *
+ * Removes @child from the index of the children of @self, if any.
+ */
+static inline void
+children_index_remove (ClutterActor *self,
+                       ClutterActor *child)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *prev_sibling, *next_sibling;
+
+  if (child->priv->index_iter == NULL)
+    return;
+
+  prev_sibling = child->priv->prev_sibling;
+  next_sibling = child->priv->next_sibling;
+
+  priv->n_depth_inversions -= count_depth_inversion (prev_sibling, child)
+                            + count_depth_inversion (child, next_sibling);
+  priv->n_depth_inversions += count_depth_inversion (prev_sibling, next_sibling);
+
+  g_sequence_remove (child->priv->index_iter);
+  child->priv->index_iter = NULL;
+
+  /* the last child is being removed */
+  if (priv->n_children == 1)
+    {
+      g_sequence_free (priv->children_index);
+      priv->children_index = NULL;
+      priv->n_depth_inversions = 0;
+    }
+}
+
+/*< private >
+ * get_child_at_index:
+ * @self: a #ClutterActor
+ * @index_: a position inside the list of children of @self
+ *
+ * Retrieves the child of @self at @index_, or %NULL if @index_ is
+ * past the last child.
+ */
+static inline ClutterActor *
+get_child_at_index (ClutterActor *self,
+                    gint          index_)
+{
+  ClutterActor *iter;
+  int i;
+
+  if (self->priv->children_index != NULL &&
+      index_ >= 0 &&
+      index_ < self->priv->n_children)
+    {
+      GSequenceIter *seq_iter;
+
+      seq_iter = g_sequence_get_iter_at_pos (self->priv->children_index,
+                                             index_);
+
+      return g_sequence_get (seq_iter);
+    }
+
+  for (iter = self->priv->first_child, i = 0;
+       iter != NULL && i < index_;
+       iter = iter->priv->next_sibling, i += 1)
+    ;
+
+  return iter;
+}
+
+/*< private >
+ * _clutter_actor_get_child_index:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the position of @self inside the list of children of
+ * its parent.
+ *
+ * Return value: the index of @self, or -1 if @self has no parent
+ */
+gint
+_clutter_actor_get_child_index (ClutterActor *self)
+{
+  ClutterActor *iter;
+  gint i;
+
+  if (self->priv->parent == NULL)
+    return -1;
+
+  if (self->priv->index_iter != NULL)
+    return g_sequence_iter_get_position (self->priv->index_iter);
+
+  for (iter = self->priv->prev_sibling, i = 0;
+       iter != NULL;
+       iter = iter->priv->prev_sibling, i += 1)
+    ;
+
+  return i;
+}
+
+/*< private >
+ * _clutter_actor_get_removed_child_index:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the position that @self had inside the list of children
+ * of the parent it was last removed from; this is only meaningful
+ * inside a handler of the #ClutterContainer::actor-removed signal.
+ *
+ * Return value: the former index of @self, or -1
+ */
+gint
+_clutter_actor_get_removed_child_index (ClutterActor *self)
+{
+  return self->priv->removed_index;
+}
+
+/* keeps the counters used to check the paint boxes of the children
+ * in sync when @child is linked to (@delta = 1), or unlinked from
+ * (@delta = -1), @self
+ */
+static void
+children_paint_box_state_update (ClutterActor *self,
+                                 ClutterActor *child,
+                                 gint          delta)
+{
+  ClutterActor *iter;
+  gint n_custom;
 
-  if (priv->queue_redraw_entry != NULL)
-    {
-      _clutter_stage_queue_redraw_entry_invalidate (priv->queue_redraw_entry);
-      priv->queue_redraw_entry = NULL;
-    }
+  /* the paint order of the children changed */
+  self->priv->children_paint_box_generation = 0;
 
-  return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
+  if (CLUTTER_ACTOR_IS_MAPPED (child))
+    self->priv->n_mapped_children += delta;
+
+  if (child->priv->has_paint_box)
+    self->priv->n_children_paint_boxes += delta;
+
+  n_custom = child->priv->n_custom_paint_volumes;
+  if (clutter_actor_has_custom_paint_volume (child))
+    n_custom += 1;
+
+  if (n_custom == 0)
+    return;
+
+  for (iter = self; iter != NULL; iter = iter->priv->parent)
+    iter->priv->n_custom_paint_volumes += delta * n_custom;
 }
 
 static inline void
@@ -3825,6 +5034,9 @@ remove_child (ClutterActor *self,
 {
   ClutterActor *prev_sibling, *next_sibling;
 
+  children_paint_box_state_update (self, child, -1);
+  children_index_remove (self, child);
+
   prev_sibling = child->priv->prev_sibling;
   next_sibling = child->priv->next_sibling;
 
@@ -3943,10 +5155,29 @@ clutter_actor_remove_child_internal (ClutterActor                 *self,
   old_first = self->priv->first_child;
   old_last = self->priv->last_child;
 
+  if (emit_actor_removed)
+    child->priv->removed_index = _clutter_actor_get_child_index (child);
+
+  /* the paint box of the child is stored by our stage, which the
+   * child cannot reach anymore after being removed */
+  if (child->priv->has_paint_box)
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage != NULL)
+        _clutter_stage_remove_actor_paint_box (CLUTTER_STAGE (stage), child);
+    }
+
   remove_child (self, child);
 
   self->priv->n_children -= 1;
 
+  /* the allocation was assigned by the old parent */
+  child->priv->parent_allocation_valid = FALSE;
+
+  /* the transformation depends on the :child-transform of the parent */
+  clutter_actor_invalidate_transform (child);
+
   self->priv->age += 1;
 
   /* if the child that got removed was visible and set to
@@ -4089,7 +5320,7 @@ clutter_actor_set_pivot_point_internal (ClutterActor       *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot = *pivot;
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT]);
 
@@ -4105,7 +5336,7 @@ clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot_z = pivot_z;
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT_Z]);
 
@@ -4139,7 +5370,7 @@ clutter_actor_set_translation_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
   g_object_notify_by_pspec (obj, pspec);
 }
@@ -4271,7 +5502,7 @@ clutter_actor_set_rotation_angle_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -4396,7 +5627,7 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
   g_object_notify_by_pspec (obj, pspec);
 }
@@ -5236,6 +6467,8 @@ clutter_actor_dispose (GObject *object)
       g_clear_object (&priv->content);
     }
 
+  clutter_actor_invalidate_paint_node (self);
+
   if (priv->clones != NULL)
     {
       g_hash_table_unref (priv->clones);
@@ -5261,6 +6494,9 @@ clutter_actor_finalize (GObject *object)
 
   g_free (priv->name);
 
+  if (priv->children_index != NULL)
+    g_sequence_free (priv->children_index);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   g_free (priv->debug_name);
 #endif
@@ -7404,6 +8640,7 @@ clutter_actor_init (ClutterActor *self)
 
   priv->id = _clutter_context_acquire_id (self);
   priv->pick_id = -1;
+  priv->removed_index = -1;
 
   priv->opacity = 255;
 
@@ -7686,6 +8923,12 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* whatever changed might be reflected by the paint nodes, so we need
+   * to build them again; we do this before bailing out for unmapped
+   * actors, as the change must not be lost once they get mapped */
+  if (effect == NULL)
+    clutter_actor_invalidate_paint_node (self);
+
   /* we can ignore unmapped actors, unless they have at least one
    * mapped clone or they are inside a cloned branch of the scene
    * graph, as unmapped actors will simply be left unpainted.
@@ -7980,6 +9223,52 @@ clutter_actor_queue_relayout (ClutterActor *self)
   clutter_actor_queue_redraw (self);
 }
 
+/**
+ * clutter_actor_set_relayout_root:
+ * @self: a #ClutterActor
+ * @relayout_root: whether @self is a relayout root
+ *
+ * Sets whether @self should be considered a relayout root.
+ *
+ * The relayouts queued by the children of a relayout root do not
+ * propagate past it; the relayout root is allocated again using the
+ * same allocation it received from its parent the last time, which
+ * avoids recomputing the layout of the whole scene graph.
+ *
+ * You should only mark an actor as a relayout root if its preferred
+ * size does not depend on the preferred size of its children. Actors
+ * with a fixed size, for instance set using clutter_actor_set_size(),
+ * are automatically considered relayout roots.
+ *
+ *
+ */
+void
+clutter_actor_set_relayout_root (ClutterActor *self,
+                                 gboolean      relayout_root)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  self->priv->relayout_root = !!relayout_root;
+}
+
+/**
+ * clutter_actor_get_relayout_root:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the value set using clutter_actor_set_relayout_root().
+ *
+ * Return value: %TRUE if @self has been marked as a relayout root
+ *
+ *
+ */
+gboolean
+clutter_actor_get_relayout_root (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->relayout_root;
+}
+
 /**
  * clutter_actor_get_preferred_size:
  * @self: a #ClutterActor
@@ -8810,6 +10099,13 @@ clutter_actor_allocate (ClutterActor           *self,
 
   priv = self->priv;
 
+  /* store the allocation assigned by the parent, in case we need to
+   * allocate the actor again as a relayout root
+   */
+  priv->parent_allocation = *box;
+  priv->parent_allocation_flags = flags;
+  priv->parent_allocation_valid = TRUE;
+
   old_allocation = priv->allocation;
   real_allocation = *box;
 
@@ -10543,9 +11839,24 @@ clutter_actor_set_z_position_internal (ClutterActor *self,
 
   if (memcmp (&info->z_position, &z_position, sizeof (float)) != 0)
     {
+      ClutterActor *parent = self->priv->parent;
+
+      /* keep track of whether the children of the parent are still
+       * sorted by depth
+       */
+      if (self->priv->index_iter != NULL)
+        parent->priv->n_depth_inversions -=
+          count_depth_inversion (self->priv->prev_sibling, self)
+          + count_depth_inversion (self, self->priv->next_sibling);
+
       info->z_position = z_position;
 
-      self->priv->transform_valid = FALSE;
+      if (self->priv->index_iter != NULL)
+        parent->priv->n_depth_inversions +=
+          count_depth_inversion (self->priv->prev_sibling, self)
+          + count_depth_inversion (self, self->priv->next_sibling);
+
+      clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
@@ -10876,7 +12187,9 @@ clutter_actor_get_children (ClutterActor *self)
  *
  * This sadly makes the insertion not O(1), but we can keep the
  * list sorted so that the painters algorithm we use for painting
- * the children will work correctly.
+ * the children will work correctly. If the children are indexed
+ * and still sorted by depth, the insertion point is found by
+ * bisecting the index instead of walking the list.
  */
 static void
 insert_child_at_depth (ClutterActor *self,
@@ -10906,17 +12219,50 @@ insert_child_at_depth (ClutterActor *self,
   /* Find the right place to insert the child so that it will still be
      sorted and the child will be after all of the actors at the same
      dept */
-  for (iter = self->priv->first_child;
-       iter != NULL;
-       iter = iter->priv->next_sibling)
+  if (self->priv->children_index != NULL &&
+      self->priv->n_depth_inversions == 0)
     {
-      float iter_depth;
+      gint lower, upper;
+
+      /* the children are sorted, so we can bisect them; the common
+       * case of children at the same depth is appended right away
+       */
+      if (get_child_depth (self->priv->last_child) <= child_depth)
+        lower = upper = self->priv->n_children;
+      else
+        {
+          lower = 0;
+          upper = self->priv->n_children - 1;
+        }
 
-      iter_depth =
-        _clutter_actor_get_transform_info_or_defaults (iter)->z_position;
+      while (lower < upper)
+        {
+          gint pivot = lower + (upper - lower) / 2;
 
-      if (iter_depth > child_depth)
-        break;
+          if (get_child_depth (get_child_at_index (self, pivot)) > child_depth)
+            upper = pivot;
+          else
+            lower = pivot + 1;
+        }
+
+      iter = lower < self->priv->n_children
+           ? get_child_at_index (self, lower)
+           : NULL;
+    }
+  else
+    {
+      for (iter = self->priv->first_child;
+           iter != NULL;
+           iter = iter->priv->next_sibling)
+        {
+          float iter_depth;
+
+          iter_depth =
+            _clutter_actor_get_transform_info_or_defaults (iter)->z_position;
+
+          if (iter_depth > child_depth)
+            break;
+        }
     }
 
   if (iter != NULL)
@@ -10981,28 +12327,16 @@ insert_child_at_index (ClutterActor *self,
     }
   else
     {
-      ClutterActor *iter;
-      int i;
-
-      for (iter = self->priv->first_child, i = 0;
-           iter != NULL;
-           iter = iter->priv->next_sibling, i += 1)
-        {
-          if (index_ == i)
-            {
-              ClutterActor *tmp = iter->priv->prev_sibling;
-
-              child->priv->prev_sibling = tmp;
-              child->priv->next_sibling = iter;
+      ClutterActor *iter = get_child_at_index (self, index_);
+      ClutterActor *tmp = iter->priv->prev_sibling;
 
-              iter->priv->prev_sibling = child;
+      child->priv->prev_sibling = tmp;
+      child->priv->next_sibling = iter;
 
-              if (tmp != NULL)
-                tmp->priv->next_sibling = child;
+      iter->priv->prev_sibling = child;
 
-              break;
-            }
-        }
+      if (tmp != NULL)
+        tmp->priv->next_sibling = child;
     }
 
   if (child->priv->prev_sibling == NULL)
@@ -11219,11 +12553,19 @@ clutter_actor_add_child_internal (ClutterActor              *self,
   child->priv->next_sibling = NULL;
   child->priv->prev_sibling = NULL;
 
+  /* the insertion functions use the index, if available */
+  clutter_actor_ensure_children_index (self);
+
   /* delegate the actual insertion */
   add_func (self, child, data);
 
   g_assert (child->priv->parent == self);
 
+  children_index_insert (self, child);
+  children_paint_box_state_update (self, child, 1);
+
+  clutter_actor_invalidate_transform (child);
+
   self->priv->n_children += 1;
 
   self->priv->age += 1;
@@ -12782,6 +14124,300 @@ clutter_animatable_iface_init (ClutterAnimatableIface *iface)
   iface->set_final_state = clutter_actor_set_final_state;
 }
 
+/* the actors whose notifications have been frozen while advancing
+ * the transitions, see _clutter_actor_begin_transition_notify_batch()
+ */
+static GPtrArray *transition_notify_batch = NULL;
+static guint transition_notify_batch_depth = 0;
+
+/*< private >
+ * _clutter_actor_begin_transition_notify_batch:
+ *
+ * Starts batching the property notifications emitted by the typed
+ * transitions of actors; each actor will have its notifications
+ * frozen the first time one of its transitions advances, and thawed
+ * by _clutter_actor_end_transition_notify_batch().
+ *
+ * Calls to this function can be nested.
+ */
+void
+_clutter_actor_begin_transition_notify_batch (void)
+{
+  if (transition_notify_batch == NULL)
+    transition_notify_batch = g_ptr_array_new ();
+
+  transition_notify_batch_depth += 1;
+}
+
+/*< private >
+ * _clutter_actor_end_transition_notify_batch:
+ *
+ * Ends a batch started by _clutter_actor_begin_transition_notify_batch(),
+ * emitting the notifications queued on each actor.
+ */
+void
+_clutter_actor_end_transition_notify_batch (void)
+{
+  GPtrArray *actors;
+  guint i;
+
+  g_assert (transition_notify_batch_depth > 0);
+
+  transition_notify_batch_depth -= 1;
+  if (transition_notify_batch_depth > 0)
+    return;
+
+  /* the notification handlers may start a new batch */
+  actors = transition_notify_batch;
+  transition_notify_batch = NULL;
+
+  for (i = 0; i < actors->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (actors, i);
+
+      actor->priv->in_transition_notify_batch = FALSE;
+
+      g_object_thaw_notify (G_OBJECT (actor));
+      g_object_unref (actor);
+    }
+
+  g_ptr_array_free (actors, TRUE);
+}
+
+/*< private >
+ * _clutter_actor_compute_transition_value:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of the animated property
+ * @interval: the #ClutterInterval of the transition
+ * @progress: the progress of the transition
+ *
+ * Interpolates and sets the value of one of the animatable properties
+ * of #ClutterActor without going through #GValue, #ClutterAnimatable
+ * and the #GParamSpec look ups.
+ *
+ * This is used by #ClutterPropertyTransition as a fast path for the
+ * float, double, opacity, color, point, size and matrix properties.
+ *
+ * Return value: %TRUE if the property was set, and %FALSE if the
+ *   caller should use the generic code path
+ */
+gboolean
+_clutter_actor_compute_transition_value (ClutterActor    *self,
+                                         GParamSpec      *pspec,
+                                         ClutterInterval *interval,
+                                         gdouble          progress)
+{
+  ClutterAnimatableIface *iface;
+  const GValue *initial, *final;
+  GObject *obj = G_OBJECT (self);
+  gboolean batched;
+
+  /* properties overridden by sub-classes, or belonging to the
+   * actions, constraints and effects, are not handled here
+   */
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR ||
+      (pspec->flags & CLUTTER_PARAM_ANIMATABLE) == 0)
+    return FALSE;
+
+  /* the interpolation must be the one of ClutterInterval */
+  if (G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL ||
+      clutter_interval_get_value_type (interval) != G_PARAM_SPEC_VALUE_TYPE (pspec) ||
+      _clutter_has_custom_progress_functions ())
+    return FALSE;
+
+  /* and a sub-class must not have re-implemented ClutterAnimatable */
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->interpolate_value != NULL ||
+      iface->set_final_state != clutter_actor_set_final_state)
+    return FALSE;
+
+  initial = clutter_interval_peek_initial_value (interval);
+  final = clutter_interval_peek_final_value (interval);
+
+#define INTERPOLATE(a,b)        (((b) - (a)) * progress + (a))
+
+  /* while the master clock advances the timelines we batch the
+   * notifications, and emit them once all the transitions have
+   * been advanced
+   */
+  batched = transition_notify_batch_depth > 0;
+  if (batched)
+    {
+      if (!self->priv->in_transition_notify_batch)
+        {
+          self->priv->in_transition_notify_batch = TRUE;
+
+          g_object_freeze_notify (obj);
+          g_ptr_array_add (transition_notify_batch, g_object_ref (self));
+        }
+    }
+  else
+    g_object_freeze_notify (obj);
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_Z_POSITION:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      {
+        gdouble ia = g_value_get_float (initial);
+        gdouble ib = g_value_get_float (final);
+        float value = INTERPOLATE (ia, ib);
+
+        switch (pspec->param_id)
+          {
+          case PROP_X:
+            clutter_actor_set_x_internal (self, value);
+            break;
+
+          case PROP_Y:
+            clutter_actor_set_y_internal (self, value);
+            break;
+
+          case PROP_WIDTH:
+            clutter_actor_set_width_internal (self, value);
+            break;
+
+          case PROP_HEIGHT:
+            clutter_actor_set_height_internal (self, value);
+            break;
+
+          case PROP_Z_POSITION:
+            clutter_actor_set_z_position_internal (self, value);
+            break;
+
+          case PROP_PIVOT_POINT_Z:
+            clutter_actor_set_pivot_point_z_internal (self, value);
+            break;
+
+          case PROP_TRANSLATION_X:
+          case PROP_TRANSLATION_Y:
+          case PROP_TRANSLATION_Z:
+            clutter_actor_set_translation_internal (self, value, pspec);
+            break;
+
+          default:
+            clutter_actor_set_margin_internal (self, value, pspec);
+            break;
+          }
+      }
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      {
+        gdouble ia = g_value_get_double (initial);
+        gdouble ib = g_value_get_double (final);
+        gdouble value = INTERPOLATE (ia, ib);
+
+        if (pspec->param_id == PROP_SCALE_X ||
+            pspec->param_id == PROP_SCALE_Y ||
+            pspec->param_id == PROP_SCALE_Z)
+          clutter_actor_set_scale_factor_internal (self, value, pspec);
+        else
+          clutter_actor_set_rotation_angle_internal (self, value, pspec);
+      }
+      break;
+
+    case PROP_OPACITY:
+      {
+        guint ia = g_value_get_uint (initial);
+        guint ib = g_value_get_uint (final);
+        guint value = INTERPOLATE ((gdouble) ia, ib);
+
+        clutter_actor_set_opacity_internal (self, value);
+      }
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      {
+        ClutterColor value = { 0, };
+
+        clutter_color_interpolate (clutter_value_get_color (initial),
+                                   clutter_value_get_color (final),
+                                   progress,
+                                   &value);
+        clutter_actor_set_background_color_internal (self, &value);
+      }
+      break;
+
+    case PROP_POSITION:
+    case PROP_PIVOT_POINT:
+      {
+        const ClutterPoint *ia = g_value_get_boxed (initial);
+        const ClutterPoint *ib = g_value_get_boxed (final);
+        ClutterPoint value;
+
+        value.x = INTERPOLATE (ia->x, ib->x);
+        value.y = INTERPOLATE (ia->y, ib->y);
+
+        if (pspec->param_id == PROP_POSITION)
+          clutter_actor_set_position_internal (self, &value);
+        else
+          clutter_actor_set_pivot_point_internal (self, &value);
+      }
+      break;
+
+    case PROP_SIZE:
+      {
+        const ClutterSize *ia = g_value_get_boxed (initial);
+        const ClutterSize *ib = g_value_get_boxed (final);
+        ClutterSize value;
+
+        value.width = INTERPOLATE (ia->width, ib->width);
+        value.height = INTERPOLATE (ia->height, ib->height);
+
+        clutter_actor_set_size_internal (self, &value);
+      }
+      break;
+
+    case PROP_TRANSFORM:
+    case PROP_CHILD_TRANSFORM:
+      {
+        ClutterMatrix value;
+
+        _clutter_util_matrix_interpolate (g_value_get_boxed (initial),
+                                          g_value_get_boxed (final),
+                                          progress,
+                                          &value);
+
+        if (pspec->param_id == PROP_TRANSFORM)
+          clutter_actor_set_transform_internal (self, &value);
+        else
+          clutter_actor_set_child_transform_internal (self, &value);
+      }
+      break;
+
+    default:
+      /* nothing was set, so we can thaw right away */
+      if (!batched)
+        g_object_thaw_notify (obj);
+
+      return FALSE;
+    }
+
+#undef INTERPOLATE
+
+  if (!batched)
+    g_object_thaw_notify (obj);
+
+  return TRUE;
+}
+
 /**
  * clutter_actor_transform_stage_point:
  * @self: A #ClutterActor
@@ -13699,7 +15335,7 @@ clutter_actor_set_transform_internal (ClutterActor        *self,
   info->transform = *transform;
   info->transform_set = !cogl_matrix_is_identity (&info->transform);
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -15017,18 +16653,10 @@ ClutterActor *
 clutter_actor_get_child_at_index (ClutterActor *self,
                                   gint          index_)
 {
-  ClutterActor *iter;
-  int i;
-
   g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
   g_return_val_if_fail (index_ <= self->priv->n_children, NULL);
 
-  for (iter = self->priv->first_child, i = 0;
-       iter != NULL && i < index_;
-       iter = iter->priv->next_sibling, i += 1)
-    ;
-
-  return iter;
+  return get_child_at_index (self, index_);
 }
 
 /*< private >
@@ -17777,10 +19405,10 @@ clutter_actor_set_child_transform_internal (ClutterActor        *self,
   /* if it's the identity matrix, we need to toggle the boolean flag */
   info->child_transform_set = !cogl_matrix_is_identity (transform);
 
-  /* we need to reset the transform_valid flag on each child */
+  /* we need to invalidate the transformation of each child */
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, &child))
-    child->priv->transform_valid = FALSE;
+    clutter_actor_invalidate_transform (child);
 
   clutter_actor_queue_redraw (self);
 
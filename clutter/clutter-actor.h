@@ -315,6 +315,9 @@ void                            clutter_actor_queue_redraw
 void                            clutter_actor_queue_redraw_with_clip            (ClutterActor                *self,
                                                                                  const cairo_rectangle_int_t *clip);
 void                            clutter_actor_queue_relayout                    (ClutterActor                *self);
+void                            clutter_actor_set_relayout_root                 (ClutterActor                *self,
+                                                                                 gboolean                     relayout_root);
+gboolean                        clutter_actor_get_relayout_root                 (ClutterActor                *self);
 void                            clutter_actor_destroy                           (ClutterActor                *self);
 void                            clutter_actor_set_name                          (ClutterActor                *self,
                                                                                  const gchar                 *name);
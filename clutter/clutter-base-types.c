@@ -1186,14 +1186,23 @@ clutter_matrix_copy (gpointer data)
   return cogl_matrix_copy (data);
 }
 
-static gboolean
-clutter_matrix_progress (const GValue *a,
-                         const GValue *b,
-                         gdouble       progress,
-                         GValue       *retval)
+/*< private >
+ * _clutter_util_matrix_interpolate:
+ * @matrix1: the initial matrix
+ * @matrix2: the final matrix
+ * @progress: the interpolation progress
+ * @res: (out caller-allocates): return location for the interpolated
+ *   matrix
+ *
+ * Interpolates between @matrix1 and @matrix2 by decomposing them,
+ * and interpolating each component separately.
+ */
+void
+_clutter_util_matrix_interpolate (const ClutterMatrix *matrix1,
+                                  const ClutterMatrix *matrix2,
+                                  gdouble              progress,
+                                  ClutterMatrix       *res)
 {
-  const ClutterMatrix *matrix1 = g_value_get_boxed (a);
-  const ClutterMatrix *matrix2 = g_value_get_boxed (b);
   ClutterVertex scale1 = CLUTTER_VERTEX_INIT (1.f, 1.f, 1.f);
   float shear1[3] = { 0.f, 0.f, 0.f };
   ClutterVertex rotate1 = CLUTTER_VERTEX_INIT_ZERO;
@@ -1209,9 +1218,8 @@ clutter_matrix_progress (const GValue *a,
   ClutterVertex rotate_res = CLUTTER_VERTEX_INIT_ZERO;
   ClutterVertex translate_res = CLUTTER_VERTEX_INIT_ZERO;
   ClutterVertex4 perspective_res = { 0.f, 0.f, 0.f, 0.f };
-  ClutterMatrix res;
 
-  clutter_matrix_init_identity (&res);
+  clutter_matrix_init_identity (res);
 
   _clutter_util_matrix_decompose (matrix1,
                                   &scale1, shear1, &rotate1, &translate1,
@@ -1222,37 +1230,51 @@ clutter_matrix_progress (const GValue *a,
 
   /* perspective */
   _clutter_util_vertex4_interpolate (&perspective1, &perspective2, progress, &perspective_res);
-  res.wx = perspective_res.x;
-  res.wy = perspective_res.y;
-  res.wz = perspective_res.z;
-  res.ww = perspective_res.w;
+  res->wx = perspective_res.x;
+  res->wy = perspective_res.y;
+  res->wz = perspective_res.z;
+  res->ww = perspective_res.w;
 
   /* translation */
   clutter_vertex_interpolate (&translate1, &translate2, progress, &translate_res);
-  cogl_matrix_translate (&res, translate_res.x, translate_res.y, translate_res.z);
+  cogl_matrix_translate (res, translate_res.x, translate_res.y, translate_res.z);
 
   /* rotation */
   clutter_vertex_interpolate (&rotate1, &rotate2, progress, &rotate_res);
-  cogl_matrix_rotate (&res, rotate_res.x, 1.0f, 0.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.y, 0.0f, 1.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.z, 0.0f, 0.0f, 1.0f);
+  cogl_matrix_rotate (res, rotate_res.x, 1.0f, 0.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.y, 0.0f, 1.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.z, 0.0f, 0.0f, 1.0f);
 
   /* skew */
   shear_res = shear1[2] + (shear2[2] - shear1[2]) * progress; /* YZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_yz (&res, shear_res);
+    _clutter_util_matrix_skew_yz (res, shear_res);
 
   shear_res = shear1[1] + (shear2[1] - shear1[1]) * progress; /* XZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xz (&res, shear_res);
+    _clutter_util_matrix_skew_xz (res, shear_res);
 
   shear_res = shear1[0] + (shear2[0] - shear1[0]) * progress; /* XY */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xy (&res, shear_res);
+    _clutter_util_matrix_skew_xy (res, shear_res);
 
   /* scale */
   clutter_vertex_interpolate (&scale1, &scale2, progress, &scale_res);
-  cogl_matrix_scale (&res, scale_res.x, scale_res.y, scale_res.z);
+  cogl_matrix_scale (res, scale_res.x, scale_res.y, scale_res.z);
+}
+
+static gboolean
+clutter_matrix_progress (const GValue *a,
+                         const GValue *b,
+                         gdouble       progress,
+                         GValue       *retval)
+{
+  ClutterMatrix res;
+
+  _clutter_util_matrix_interpolate (g_value_get_boxed (a),
+                                    g_value_get_boxed (b),
+                                    progress,
+                                    &res);
 
   g_value_set_boxed (retval, &res);
 
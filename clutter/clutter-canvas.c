@@ -36,6 +36,17 @@
  * that can be used to draw. #ClutterCanvas will emit the #ClutterCanvas::draw
  * signal when invalidated using clutter_content_invalidate().
  *
+ * If only a portion of the canvas changed, you can use
+ * clutter_canvas_invalidate_rect() instead; the #ClutterCanvas::draw
+ * signal will be emitted with a clip already applied to the #cairo_t
+ * context, and only the changed portion of the canvas will be uploaded
+ * and redrawn.
+ *
+ * If drawing the contents of the canvas is expensive, you can set the
+ * #ClutterCanvas:async-draw property to %TRUE; the #ClutterCanvas::draw
+ * signal will then be emitted inside a worker thread, and the previous
+ * contents of the canvas will be displayed until the new ones are ready.
+ *
  * <informalexample id="canvas-example">
  *   <programlisting>
  * <xi:include xmlns:xi="http://www.w3.org/2001/XInclude" parse="text" href="../../../../examples/canvas.c">
@@ -51,6 +62,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <cogl/cogl.h>
 #include <cairo-gobject.h>
 
@@ -62,10 +75,12 @@
 #include "clutter-cairo.h"
 #include "clutter-color.h"
 #include "clutter-content-private.h"
+#include "clutter-debug.h"
 #include "clutter-marshal.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
+#include "clutter-profile.h"
 
 struct _ClutterCanvasPrivate
 {
@@ -75,14 +90,46 @@ struct _ClutterCanvasPrivate
   int height;
 
   CoglBitmap *buffer;
+
+  /* the texture created from the buffer; kept around so that
+   * partial invalidations only need to upload the changed area */
+  CoglTexture *texture;
+
+  /* the draw currently running inside the worker threads, if any */
+  struct _CanvasDrawJob *draw_job;
+
+  /* the statistics of the draws done inside the worker threads */
+  ClutterCanvasDrawStats draw_stats;
+
+  guint async_draw : 1;
+  guint async_draw_pending : 1;
 };
 
+typedef struct _CanvasDrawJob
+{
+  ClutterCanvas *canvas;
+
+  int width;
+  int height;
+
+  cairo_surface_t *surface;
+
+  /* the time the draw was requested, to measure the latency */
+  gint64 start_time;
+} CanvasDrawJob;
+
+/* the pool of worker threads is shared by all the canvases */
+#define CANVAS_MAX_DRAW_THREADS         4
+
+static GThreadPool *canvas_draw_pool = NULL;
+
 enum
 {
   PROP_0,
 
   PROP_WIDTH,
   PROP_HEIGHT,
+  PROP_ASYNC_DRAW,
 
   LAST_PROP
 };
@@ -137,6 +184,12 @@ clutter_canvas_finalize (GObject *gobject)
       priv->buffer = NULL;
     }
 
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
 
@@ -166,6 +219,11 @@ clutter_canvas_set_property (GObject      *gobject,
         }
       break;
 
+    case PROP_ASYNC_DRAW:
+      clutter_canvas_set_async_draw (CLUTTER_CANVAS (gobject),
+                                     g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -190,6 +248,10 @@ clutter_canvas_get_property (GObject    *gobject,
       g_value_set_int (value, priv->height);
       break;
 
+    case PROP_ASYNC_DRAW:
+      g_value_set_boolean (value, priv->async_draw);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -235,6 +297,25 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                       G_PARAM_READWRITE |
                       G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterCanvas:async-draw:
+   *
+   * Whether the #ClutterCanvas::draw signal should be emitted inside
+   * a worker thread.
+   *
+   * The handlers of the #ClutterCanvas::draw signal must not call any
+   * Clutter API when this property is set to %TRUE.
+   *
+   *
+   */
+  obj_props[PROP_ASYNC_DRAW] =
+    g_param_spec_boolean ("async-draw",
+                          P_("Asynchronous draw"),
+                          P_("Whether the canvas should be drawn inside a worker thread"),
+                          FALSE,
+                          G_PARAM_READWRITE |
+                          G_PARAM_STATIC_STRINGS);
+
   /**
    * ClutterCanvas::draw:
    * @canvas: the #ClutterCanvas that emitted the signal
@@ -245,6 +326,14 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * The #ClutterCanvas::draw signal is emitted each time a canvas is
    * invalidated.
    *
+   * If the canvas was invalidated using clutter_canvas_invalidate_rect(),
+   * the @cr context will be clipped to the invalidated area, and the
+   * contents of the canvas outside of that area will be preserved; you
+   * can use cairo_clip_extents() to avoid drawing outside of the clip.
+   *
+   * If the #ClutterCanvas:async-draw property is set, this signal is
+   * emitted inside a worker thread.
+   *
    * It is safe to connect multiple handlers to this signal: each
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
@@ -289,6 +378,7 @@ clutter_canvas_paint_content (ClutterContent   *content,
                               ClutterPaintNode *root)
 {
   ClutterCanvas *self = CLUTTER_CANVAS (content);
+  ClutterCanvasPrivate *priv = self->priv;
   ClutterPaintNode *node;
   CoglTexture *texture;
   ClutterActorBox box;
@@ -297,12 +387,15 @@ clutter_canvas_paint_content (ClutterContent   *content,
   ClutterScalingFilter min_f, mag_f;
   ClutterContentRepeat repeat;
 
-  if (self->priv->buffer == NULL)
+  if (priv->buffer == NULL)
     return;
 
-  texture = cogl_texture_new_from_bitmap (self->priv->buffer,
-                                          COGL_TEXTURE_NO_SLICING,
-                                          CLUTTER_CAIRO_FORMAT_ARGB32);
+  if (priv->texture == NULL)
+    priv->texture = cogl_texture_new_from_bitmap (priv->buffer,
+                                                  COGL_TEXTURE_NO_SLICING,
+                                                  CLUTTER_CAIRO_FORMAT_ARGB32);
+
+  texture = priv->texture;
   if (texture == NULL)
     return;
 
@@ -317,7 +410,6 @@ clutter_canvas_paint_content (ClutterContent   *content,
   color.alpha = paint_opacity;
 
   node = clutter_texture_node_new (texture, &color, min_f, mag_f);
-  cogl_object_unref (texture);
 
   clutter_paint_node_set_name (node, "Canvas");
 
@@ -428,18 +520,293 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   cairo_surface_destroy (surface);
 }
 
+/* redraws @area, preserving the rest of the buffer, and uploads it
+ * to the texture; returns %FALSE if the buffer could not be mapped,
+ * in which case the whole canvas needs to be drawn again
+ */
+static gboolean
+clutter_canvas_emit_draw_area (ClutterCanvas               *self,
+                               const cairo_rectangle_int_t *area)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  cairo_surface_t *surface;
+  unsigned char *data;
+  CoglBuffer *buffer;
+  int bitmap_stride;
+  gboolean res;
+  cairo_t *cr;
+
+  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
+  if (buffer == NULL)
+    return FALSE;
+
+  /* we cannot discard the contents of the buffer, this time */
+  data = cogl_buffer_map (buffer, COGL_BUFFER_ACCESS_READ_WRITE, 0);
+  if (data == NULL)
+    return FALSE;
+
+  bitmap_stride = cogl_bitmap_get_rowstride (priv->buffer);
+  surface = cairo_image_surface_create_for_data (data,
+                                                 CAIRO_FORMAT_ARGB32,
+                                                 priv->width,
+                                                 priv->height,
+                                                 bitmap_stride);
+
+  self->priv->cr = cr = cairo_create (surface);
+
+  cairo_rectangle (cr, area->x, area->y, area->width, area->height);
+  cairo_clip (cr);
+
+  g_signal_emit (self, canvas_signals[DRAW], 0,
+                 cr, priv->width, priv->height,
+                 &res);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled () && cairo_status (cr))
+    {
+      g_warning ("Drawing failed for <ClutterCanvas>[%p]: %s",
+                 self,
+                 cairo_status_to_string (cairo_status (cr)));
+    }
+#endif
+
+  self->priv->cr = NULL;
+  cairo_destroy (cr);
+
+  cairo_surface_flush (surface);
+
+  /* upload only the area we just drew; if we don't have a texture yet,
+   * it will be created from the whole buffer when painting */
+  if (priv->texture != NULL)
+    {
+      res = cogl_texture_set_region (priv->texture,
+                                     0, 0,
+                                     area->x, area->y,
+                                     area->width, area->height,
+                                     area->width, area->height,
+                                     CLUTTER_CAIRO_FORMAT_ARGB32,
+                                     bitmap_stride,
+                                     data
+                                     + (area->y * bitmap_stride)
+                                     + (area->x * 4));
+
+      if (!res)
+        {
+          cogl_object_unref (priv->texture);
+          priv->texture = NULL;
+        }
+    }
+
+  cairo_surface_destroy (surface);
+  cogl_buffer_unmap (buffer);
+
+  return TRUE;
+}
+
+static void clutter_canvas_queue_async_draw (ClutterCanvas *self);
+
+static gboolean
+clutter_canvas_draw_job_done (gpointer data)
+{
+  CanvasDrawJob *job = data;
+  ClutterCanvas *self = job->canvas;
+  ClutterCanvasPrivate *priv = self->priv;
+
+  CLUTTER_STATIC_COUNTER (canvas_async_draw_counter,
+                          "Asynchronous canvas draws",
+                          "Increments each time a canvas drawn inside a "
+                          "worker thread is uploaded",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (canvas_async_drop_counter,
+                          "Dropped asynchronous canvas draws",
+                          "Increments each time a canvas drawn inside a "
+                          "worker thread is discarded because the canvas "
+                          "size changed",
+                          0 /* no application private data */);
+
+  g_assert (priv->draw_job == job);
+  priv->draw_job = NULL;
+
+  if (job->width == priv->width && job->height == priv->height)
+    {
+      cairo_rectangle_int_t area = { 0, 0, job->width, job->height };
+      CoglContext *ctx;
+      CoglBitmap *bitmap;
+      CoglBuffer *buffer;
+      unsigned char *data;
+      int stride, bitmap_stride;
+      gint64 latency;
+
+      ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      bitmap = cogl_bitmap_new_with_size (ctx,
+                                          job->width,
+                                          job->height,
+                                          CLUTTER_CAIRO_FORMAT_ARGB32);
+
+      buffer = COGL_BUFFER (cogl_bitmap_get_buffer (bitmap));
+      bitmap_stride = cogl_bitmap_get_rowstride (bitmap);
+      stride = cairo_image_surface_get_stride (job->surface);
+      data = cairo_image_surface_get_data (job->surface);
+
+      if (stride == bitmap_stride)
+        cogl_buffer_set_data (buffer, 0, data, stride * job->height);
+      else
+        {
+          int y;
+
+          for (y = 0; y < job->height; y++)
+            cogl_buffer_set_data (buffer,
+                                  y * bitmap_stride,
+                                  data + (y * stride),
+                                  job->width * 4);
+        }
+
+      /* swap the new contents in; the texture will be created again
+       * the next time the canvas is painted */
+      if (priv->buffer != NULL)
+        cogl_object_unref (priv->buffer);
+
+      priv->buffer = bitmap;
+
+      if (priv->texture != NULL)
+        {
+          cogl_object_unref (priv->texture);
+          priv->texture = NULL;
+        }
+
+      latency = g_get_monotonic_time () - job->start_time;
+
+      priv->draw_stats.n_draws += 1;
+      priv->draw_stats.last_latency = latency;
+      priv->draw_stats.max_latency = MAX (priv->draw_stats.max_latency, latency);
+      priv->draw_stats.total_latency += latency;
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, canvas_async_draw_counter);
+
+      CLUTTER_NOTE (PAINT, "Canvas[%p]: asynchronous draw took %.3f ms",
+                    self,
+                    latency / 1000.0);
+
+      _clutter_content_queue_redraw_area (CLUTTER_CONTENT (self), &area);
+    }
+  else
+    {
+      priv->draw_stats.n_dropped_draws += 1;
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, canvas_async_drop_counter);
+    }
+
+  if (priv->async_draw_pending)
+    {
+      priv->async_draw_pending = FALSE;
+
+      if (priv->width > 0 && priv->height > 0)
+        clutter_canvas_queue_async_draw (self);
+    }
+
+  cairo_surface_destroy (job->surface);
+  g_slice_free (CanvasDrawJob, job);
+
+  /* this might finalize the canvas */
+  g_object_unref (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+clutter_canvas_draw_job_run (gpointer data,
+                             gpointer user_data)
+{
+  CanvasDrawJob *job = data;
+  gboolean res;
+  cairo_t *cr;
+
+  cr = cairo_create (job->surface);
+
+  g_signal_emit (job->canvas, canvas_signals[DRAW], 0,
+                 cr, job->width, job->height,
+                 &res);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled () && cairo_status (cr))
+    {
+      g_warning ("Drawing failed for <ClutterCanvas>[%p]: %s",
+                 job->canvas,
+                 cairo_status_to_string (cairo_status (cr)));
+    }
+#endif
+
+  cairo_destroy (cr);
+  cairo_surface_flush (job->surface);
+
+  /* upload the result before the next frame */
+  clutter_threads_add_idle_full (G_PRIORITY_HIGH_IDLE,
+                                 clutter_canvas_draw_job_done,
+                                 job,
+                                 NULL);
+}
+
+static void
+clutter_canvas_queue_async_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  CanvasDrawJob *job;
+
+  /* coalesce the invalidations happening while drawing */
+  if (priv->draw_job != NULL)
+    {
+      priv->async_draw_pending = TRUE;
+      return;
+    }
+
+  job = g_slice_new (CanvasDrawJob);
+  job->canvas = g_object_ref (self);
+  job->width = priv->width;
+  job->height = priv->height;
+  job->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                             priv->width,
+                                             priv->height);
+  job->start_time = g_get_monotonic_time ();
+
+  priv->draw_job = job;
+
+  if (G_UNLIKELY (canvas_draw_pool == NULL))
+    canvas_draw_pool = g_thread_pool_new (clutter_canvas_draw_job_run,
+                                          NULL,
+                                          CANVAS_MAX_DRAW_THREADS,
+                                          FALSE,
+                                          NULL);
+
+  g_thread_pool_push (canvas_draw_pool, job, NULL);
+}
+
 static void
 clutter_canvas_invalidate (ClutterContent *content)
 {
   ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
 
+  /* keep the current contents until the new ones are ready */
+  if (priv->async_draw)
+    {
+      if (priv->width > 0 && priv->height > 0)
+        clutter_canvas_queue_async_draw (self);
+
+      return;
+    }
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
       priv->buffer = NULL;
     }
 
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
   if (priv->width <= 0 || priv->height <= 0)
     return;
 
@@ -542,3 +909,155 @@ clutter_canvas_set_size (ClutterCanvas *canvas,
 
   g_object_thaw_notify (obj);
 }
+
+/**
+ * clutter_canvas_invalidate_rect:
+ * @canvas: a #ClutterCanvas
+ * @rect: the area to invalidate, in canvas coordinates
+ *
+ * Invalidates the portion of the @canvas inside @rect.
+ *
+ * The #ClutterCanvas::draw signal will be emitted with its #cairo_t
+ * context clipped to @rect, and the contents of the @canvas outside
+ * of @rect will be preserved. Only the invalidated portion of the
+ * @canvas will then be uploaded to the GPU and redrawn.
+ *
+ * If the @canvas was never drawn, or if the #ClutterCanvas:async-draw
+ * property is set, this function will invalidate the whole @canvas,
+ * like clutter_content_invalidate() does.
+ *
+ *
+ */
+void
+clutter_canvas_invalidate_rect (ClutterCanvas               *canvas,
+                                const cairo_rectangle_int_t *rect)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t area;
+  int x2, y2;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (rect != NULL);
+
+  priv = canvas->priv;
+
+  if (priv->width <= 0 || priv->height <= 0)
+    return;
+
+  if (priv->buffer == NULL || priv->async_draw)
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  /* clamp the area to the size of the canvas */
+  area.x = MAX (rect->x, 0);
+  area.y = MAX (rect->y, 0);
+  x2 = MIN (rect->x + rect->width, priv->width);
+  y2 = MIN (rect->y + rect->height, priv->height);
+
+  if (x2 <= area.x || y2 <= area.y)
+    return;
+
+  area.width = x2 - area.x;
+  area.height = y2 - area.y;
+
+  if (!clutter_canvas_emit_draw_area (canvas, &area))
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  _clutter_content_queue_redraw_area (CLUTTER_CONTENT (canvas), &area);
+}
+
+/**
+ * clutter_canvas_set_async_draw:
+ * @canvas: a #ClutterCanvas
+ * @async_draw: whether the canvas should be drawn inside a worker thread
+ *
+ * Sets whether the #ClutterCanvas::draw signal should be emitted inside
+ * a worker thread, instead of the main loop.
+ *
+ * While the @canvas is being drawn, the actors using it will keep
+ * displaying its previous contents.
+ *
+ *
+ */
+void
+clutter_canvas_set_async_draw (ClutterCanvas *canvas,
+                               gboolean       async_draw)
+{
+  ClutterCanvasPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  async_draw = !!async_draw;
+
+  if (priv->async_draw == async_draw)
+    return;
+
+  priv->async_draw = async_draw;
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_ASYNC_DRAW]);
+}
+
+/**
+ * clutter_canvas_get_async_draw:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves the value set using clutter_canvas_set_async_draw().
+ *
+ * Return value: %TRUE if the canvas is drawn inside a worker thread
+ *
+ *
+ */
+gboolean
+clutter_canvas_get_async_draw (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->async_draw;
+}
+
+/**
+ * clutter_canvas_get_draw_stats:
+ * @canvas: a #ClutterCanvas
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Retrieves the statistics of the draws of @canvas done inside a
+ * worker thread, since the @canvas was created or since the last
+ * call to clutter_canvas_reset_draw_stats().
+ *
+ * The statistics are only updated if the #ClutterCanvas:async-draw
+ * property is set.
+ *
+ *
+ */
+void
+clutter_canvas_get_draw_stats (ClutterCanvas          *canvas,
+                               ClutterCanvasDrawStats *stats)
+{
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (stats != NULL);
+
+  *stats = canvas->priv->draw_stats;
+}
+
+/**
+ * clutter_canvas_reset_draw_stats:
+ * @canvas: a #ClutterCanvas
+ *
+ * Resets the statistics returned by clutter_canvas_get_draw_stats().
+ *
+ *
+ */
+void
+clutter_canvas_reset_draw_stats (ClutterCanvas *canvas)
+{
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  memset (&canvas->priv->draw_stats, 0, sizeof (ClutterCanvasDrawStats));
+}
@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 typedef struct _ClutterCanvas           ClutterCanvas;
 typedef struct _ClutterCanvasPrivate    ClutterCanvasPrivate;
 typedef struct _ClutterCanvasClass      ClutterCanvasClass;
+typedef struct _ClutterCanvasDrawStats  ClutterCanvasDrawStats;
 
 /**
  * ClutterCanvas:
@@ -85,6 +86,35 @@ struct _ClutterCanvasClass
   gpointer _padding[16];
 };
 
+/**
+ * ClutterCanvasDrawStats:
+ * @n_draws: the number of draws done inside a worker thread and
+ *   uploaded
+ * @n_dropped_draws: the number of draws done inside a worker thread
+ *   and discarded, because the size of the canvas changed meanwhile
+ * @last_latency: the time between the request and the upload of the
+ *   last draw, in microseconds
+ * @max_latency: the longest time between the request and the upload
+ *   of a draw, in microseconds
+ * @total_latency: the sum of the times between the request and the
+ *   upload of each draw, in microseconds
+ *
+ * The statistics of the draws of a #ClutterCanvas with the
+ * #ClutterCanvas:async-draw property set, as returned by
+ * clutter_canvas_get_draw_stats().
+ *
+ *
+ */
+struct _ClutterCanvasDrawStats
+{
+  guint n_draws;
+  guint n_dropped_draws;
+
+  gint64 last_latency;
+  gint64 max_latency;
+  gint64 total_latency;
+};
+
 
 GType clutter_canvas_get_type (void) G_GNUC_CONST;
 
@@ -95,6 +125,17 @@ void                    clutter_canvas_set_size         (ClutterCanvas *canvas,
                                                          int            width,
                                                          int            height);
 
+void                    clutter_canvas_invalidate_rect  (ClutterCanvas               *canvas,
+                                                         const cairo_rectangle_int_t *rect);
+
+void                    clutter_canvas_set_async_draw   (ClutterCanvas *canvas,
+                                                         gboolean       async_draw);
+gboolean                clutter_canvas_get_async_draw   (ClutterCanvas *canvas);
+
+void                    clutter_canvas_get_draw_stats   (ClutterCanvas          *canvas,
+                                                         ClutterCanvasDrawStats *stats);
+void                    clutter_canvas_reset_draw_stats (ClutterCanvas          *canvas);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CANVAS_H__ */
@@ -38,6 +38,9 @@ void            _clutter_content_paint_content          (ClutterContent   *conte
                                                          ClutterActor     *actor,
                                                          ClutterPaintNode *node);
 
+void            _clutter_content_queue_redraw_area      (ClutterContent              *content,
+                                                         const cairo_rectangle_int_t *area);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CONTENT_PRIVATE_H__ */
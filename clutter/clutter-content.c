@@ -40,6 +40,8 @@
 #include "config.h"
 #endif
 
+#include <math.h>
+
 #include "clutter-content-private.h"
 
 #include "clutter-debug.h"
@@ -190,6 +192,79 @@ clutter_content_invalidate (ClutterContent *content)
     }
 }
 
+/*< private >
+ * _clutter_content_queue_redraw_area:
+ * @content: a #ClutterContent
+ * @area: the changed area, in the coordinates of the preferred size
+ *   of @content
+ *
+ * Queues a redraw of the part of each actor using @content that
+ * displays @area.
+ *
+ * Unlike clutter_content_invalidate(), this function does not call
+ * the #ClutterContentIface.invalidate() virtual function, so it
+ * should be used by #ClutterContent implementations that already
+ * updated their state.
+ */
+void
+_clutter_content_queue_redraw_area (ClutterContent              *content,
+                                    const cairo_rectangle_int_t *area)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+  gfloat content_width, content_height;
+  gboolean has_size;
+
+  actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
+  if (actors == NULL)
+    return;
+
+  has_size = clutter_content_get_preferred_size (content,
+                                                 &content_width,
+                                                 &content_height);
+
+  g_hash_table_iter_init (&iter, actors);
+  while (g_hash_table_iter_next (&iter, &key_p, &value_p))
+    {
+      ClutterActor *actor = key_p;
+      cairo_rectangle_int_t clip;
+      ClutterActorBox box;
+      float scale_x, scale_y;
+      float x1, y1, x2, y2;
+
+      g_assert (actor != NULL);
+
+      /* a repeated content can show the area more than once */
+      if (!has_size ||
+          content_width <= 0 || content_height <= 0 ||
+          clutter_actor_get_content_repeat (actor) != CLUTTER_REPEAT_NONE)
+        {
+          clutter_actor_queue_redraw (actor);
+          continue;
+        }
+
+      clutter_actor_get_content_box (actor, &box);
+
+      scale_x = (box.x2 - box.x1) / content_width;
+      scale_y = (box.y2 - box.y1) / content_height;
+
+      /* we add a pixel on each side to account for the filtering
+       * of the scaled content */
+      x1 = floorf (box.x1 + area->x * scale_x) - 1;
+      y1 = floorf (box.y1 + area->y * scale_y) - 1;
+      x2 = ceilf (box.x1 + (area->x + area->width) * scale_x) + 1;
+      y2 = ceilf (box.y1 + (area->y + area->height) * scale_y) + 1;
+
+      clip.x = x1;
+      clip.y = y1;
+      clip.width = x2 - x1;
+      clip.height = y2 - y1;
+
+      clutter_actor_queue_redraw_with_clip (actor, &clip);
+    }
+}
+
 /*< private >
  * _clutter_content_attached:
  * @content: a #ClutterContent
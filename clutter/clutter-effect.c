@@ -330,6 +330,14 @@ _clutter_effect_pick (ClutterEffect           *effect,
   CLUTTER_EFFECT_GET_CLASS (effect)->pick (effect, flags);
 }
 
+gboolean
+_clutter_effect_has_custom_pick (ClutterEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_EFFECT (effect), FALSE);
+
+  return CLUTTER_EFFECT_GET_CLASS (effect)->pick != clutter_effect_real_pick;
+}
+
 gboolean
 _clutter_effect_get_paint_volume (ClutterEffect      *effect,
                                   ClutterPaintVolume *volume)
@@ -11,6 +11,9 @@ void            _clutter_event_set_pointer_emulated     (ClutterEvent       *eve
 /* Reinjecting queued events for processing */
 void            _clutter_process_event                  (ClutterEvent       *event);
 
+/* Queues an event popped off the main event queue, taking ownership */
+void            _clutter_do_event_take                  (ClutterEvent       *event);
+
 /* clears the event queue inside the main context */
 void            _clutter_clear_events_queue             (void);
 void            _clutter_clear_events_queue_for_stage   (ClutterStage       *stage);
@@ -19,9 +22,16 @@ void            _clutter_event_set_platform_data        (ClutterEvent       *eve
                                                          gpointer            data);
 gpointer        _clutter_event_get_platform_data        (const ClutterEvent *event);
 
+void            _clutter_event_set_hardware_time        (ClutterEvent       *event,
+                                                         gint64              hardware_time);
+gint64          _clutter_event_get_hardware_time        (const ClutterEvent *event);
+
 void            _clutter_event_push                     (const ClutterEvent *event,
                                                          gboolean            do_copy);
 
+void            _clutter_event_coalesce_motion          (ClutterEvent       *event,
+                                                         const ClutterEvent *previous);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EVENT_PRIVATE_H__ */
@@ -34,6 +34,7 @@
 #include "clutter-private.h"
 
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:clutter-event
@@ -45,9 +46,19 @@
  * be synthesized by Clutter itself or by the application code.
  */
 
+/* the number of events inside each block of allocated events */
+#define EVENT_BLOCK_SIZE                64
+
 typedef struct _ClutterEventPrivate {
   ClutterEvent base;
 
+  /* points to the event itself while it is in use, so that a freed
+   * event does not look like an allocated event */
+  gpointer self;
+
+  /* the next unused event inside the same block */
+  struct _ClutterEventPrivate *next_free;
+
   ClutterInputDevice *device;
   ClutterInputDevice *source_device;
 
@@ -56,22 +67,200 @@ typedef struct _ClutterEventPrivate {
 
   gpointer platform_data;
 
+  /* the monotonic time of the event, as set by the input device,
+   * in microseconds; 0 if unknown */
+  gint64 hardware_time;
+
+  /* the samples of the events coalesced into this one, oldest first;
+   * the axes of the samples point inside motion_history_axes */
+  GArray *motion_history;
+  GArray *motion_history_axes;
+
   guint is_pointer_emulated : 1;
 } ClutterEventPrivate;
 
-static GHashTable *all_events = NULL;
-
 G_DEFINE_BOXED_TYPE (ClutterEvent, clutter_event,
                      clutter_event_copy,
                      clutter_event_free);
 
-static gboolean
+typedef struct _ClutterEventBlock       ClutterEventBlock;
+
+struct _ClutterEventBlock
+{
+  ClutterEventPrivate events[EVENT_BLOCK_SIZE];
+
+  /* the unused events of the block */
+  ClutterEventPrivate *free_events;
+  guint n_used;
+
+  /* the links inside the list of blocks with unused events */
+  ClutterEventBlock *prev;
+  ClutterEventBlock *next;
+};
+
+/* the events returned by clutter_event_new() are carved out of these
+ * blocks, sorted by address; a block is freed once none of its events
+ * is in use, unless it is the last one */
+static GPtrArray *event_blocks = NULL;
+
+/* the blocks with unused events, where clutter_event_new() looks first */
+static ClutterEventBlock *free_event_blocks = NULL;
+
+static guint
+event_blocks_search (guintptr  ptr,
+                     gboolean *found)
+{
+  guint lo = 0, hi = event_blocks != NULL ? event_blocks->len : 0;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+      guintptr block = (guintptr) g_ptr_array_index (event_blocks, mid);
+
+      if (ptr < block)
+        hi = mid;
+      else if (ptr >= block + sizeof (ClutterEventBlock))
+        lo = mid + 1;
+      else
+        {
+          *found = TRUE;
+          return mid;
+        }
+    }
+
+  *found = FALSE;
+
+  return lo;
+}
+
+static ClutterEventBlock *
+get_event_block (const ClutterEvent *event,
+                 guint              *index_)
+{
+  ClutterEventBlock *block;
+  gboolean found;
+  guintptr offset;
+  guint i;
+
+  i = event_blocks_search ((guintptr) event, &found);
+  if (!found)
+    return NULL;
+
+  block = g_ptr_array_index (event_blocks, i);
+
+  offset = (guintptr) event - (guintptr) block->events;
+  if (offset >= sizeof (block->events) ||
+      offset % sizeof (ClutterEventPrivate) != 0)
+    return NULL;
+
+  /* the event is inside a block, so we can read its private data; a
+   * copy made by value into another event does not copy the pointer,
+   * and freed events do not have one */
+  if (((const ClutterEventPrivate *) event)->self != event)
+    return NULL;
+
+  if (index_ != NULL)
+    *index_ = i;
+
+  return block;
+}
+
+static inline gboolean
 is_event_allocated (const ClutterEvent *event)
 {
-  if (all_events == NULL)
-    return FALSE;
+  return get_event_block (event, NULL) != NULL;
+}
+
+static void
+free_event_blocks_link (ClutterEventBlock *block)
+{
+  block->prev = NULL;
+  block->next = free_event_blocks;
+
+  if (free_event_blocks != NULL)
+    free_event_blocks->prev = block;
+
+  free_event_blocks = block;
+}
+
+static void
+free_event_blocks_unlink (ClutterEventBlock *block)
+{
+  if (block->prev != NULL)
+    block->prev->next = block->next;
+  else
+    free_event_blocks = block->next;
+
+  if (block->next != NULL)
+    block->next->prev = block->prev;
+
+  block->prev = block->next = NULL;
+}
+
+static ClutterEventPrivate *
+event_blocks_alloc (void)
+{
+  ClutterEventBlock *block;
+  ClutterEventPrivate *priv;
+  gboolean found;
+  guint i;
+
+  if (free_event_blocks == NULL)
+    {
+      if (G_UNLIKELY (event_blocks == NULL))
+        event_blocks = g_ptr_array_new ();
+
+      block = g_new0 (ClutterEventBlock, 1);
+
+      for (i = EVENT_BLOCK_SIZE; i > 0; i--)
+        {
+          block->events[i - 1].next_free = block->free_events;
+          block->free_events = &block->events[i - 1];
+        }
+
+      /* keep the blocks sorted by address */
+      i = event_blocks_search ((guintptr) block, &found);
+      g_ptr_array_add (event_blocks, NULL);
+      memmove (event_blocks->pdata + i + 1,
+               event_blocks->pdata + i,
+               (event_blocks->len - i - 1) * sizeof (gpointer));
+      event_blocks->pdata[i] = block;
+
+      free_event_blocks_link (block);
+    }
 
-  return g_hash_table_lookup (all_events, event) != NULL;
+  block = free_event_blocks;
+
+  priv = block->free_events;
+  block->free_events = priv->next_free;
+  block->n_used += 1;
+
+  if (block->free_events == NULL)
+    free_event_blocks_unlink (block);
+
+  return priv;
+}
+
+static void
+event_blocks_release (ClutterEventBlock   *block,
+                      guint                block_index,
+                      ClutterEventPrivate *priv)
+{
+  priv->self = NULL;
+  priv->next_free = block->free_events;
+
+  if (block->free_events == NULL)
+    free_event_blocks_link (block);
+
+  block->free_events = priv;
+  block->n_used -= 1;
+
+  if (block->n_used == 0 && event_blocks->len > 1)
+    {
+      free_event_blocks_unlink (block);
+      g_ptr_array_remove_index (event_blocks, block_index);
+      g_free (block);
+    }
 }
 
 /*
@@ -112,6 +301,43 @@ _clutter_event_set_platform_data (ClutterEvent *event,
   ((ClutterEventPrivate *) event)->platform_data = data;
 }
 
+/*< private >
+ * _clutter_event_set_hardware_time:
+ * @event: a #ClutterEvent
+ * @hardware_time: the monotonic time of the event, in microseconds
+ *
+ * Sets the time at which the input device generated @event, with
+ * a better resolution than the #ClutterEvent time field; backends
+ * can use it to let Clutter measure the latency of the input.
+ */
+void
+_clutter_event_set_hardware_time (ClutterEvent *event,
+                                  gint64        hardware_time)
+{
+  if (!is_event_allocated (event))
+    return;
+
+  ((ClutterEventPrivate *) event)->hardware_time = hardware_time;
+}
+
+/*< private >
+ * _clutter_event_get_hardware_time:
+ * @event: a #ClutterEvent
+ *
+ * Retrieves the time set using _clutter_event_set_hardware_time().
+ *
+ * Return value: the monotonic time of the event, in microseconds,
+ *   or 0 if the backend did not set it
+ */
+gint64
+_clutter_event_get_hardware_time (const ClutterEvent *event)
+{
+  if (!is_event_allocated (event))
+    return 0;
+
+  return ((ClutterEventPrivate *) event)->hardware_time;
+}
+
 void
 _clutter_event_set_pointer_emulated (ClutterEvent *event,
                                      gboolean      is_emulated)
@@ -122,6 +348,162 @@ _clutter_event_set_pointer_emulated (ClutterEvent *event,
   ((ClutterEventPrivate *) event)->is_pointer_emulated = !!is_emulated;
 }
 
+/* moves the axes pointers of the samples in @history from @old_data
+ * to @new_data, after the array holding the axes has been reallocated */
+static void
+motion_history_rebase_axes (GArray        *history,
+                            const gdouble *old_data,
+                            gdouble       *new_data)
+{
+  guint i;
+
+  if (old_data == new_data)
+    return;
+
+  for (i = 0; i < history->len; i++)
+    {
+      ClutterMotionSample *sample;
+
+      sample = &g_array_index (history, ClutterMotionSample, i);
+      if (sample->axes != NULL)
+        sample->axes = new_data + (sample->axes - old_data);
+    }
+}
+
+static void
+motion_history_append (ClutterEventPrivate *real_event,
+                       guint32              time_,
+                       gfloat               x,
+                       gfloat               y,
+                       const gdouble       *axes,
+                       guint                n_axes)
+{
+  ClutterMotionSample sample;
+
+  if (real_event->motion_history == NULL)
+    real_event->motion_history = g_array_new (FALSE, FALSE,
+                                              sizeof (ClutterMotionSample));
+
+  sample.time = time_;
+  sample.x = x;
+  sample.y = y;
+  sample.axes = NULL;
+
+  if (axes != NULL && n_axes > 0)
+    {
+      gdouble *old_data;
+      guint offset;
+
+      if (real_event->motion_history_axes == NULL)
+        real_event->motion_history_axes = g_array_new (FALSE, FALSE,
+                                                       sizeof (gdouble));
+
+      old_data = (gdouble *) real_event->motion_history_axes->data;
+      offset = real_event->motion_history_axes->len;
+
+      g_array_append_vals (real_event->motion_history_axes, axes, n_axes);
+
+      if (old_data != NULL)
+        motion_history_rebase_axes (real_event->motion_history,
+                                    old_data,
+                                    (gdouble *) real_event->motion_history_axes->data);
+
+      sample.axes = (gdouble *) real_event->motion_history_axes->data + offset;
+    }
+
+  g_array_append_val (real_event->motion_history, sample);
+}
+
+static void
+motion_history_free (ClutterEventPrivate *real_event)
+{
+  if (real_event->motion_history != NULL)
+    {
+      g_array_free (real_event->motion_history, TRUE);
+      real_event->motion_history = NULL;
+    }
+
+  if (real_event->motion_history_axes != NULL)
+    {
+      g_array_free (real_event->motion_history_axes, TRUE);
+      real_event->motion_history_axes = NULL;
+    }
+}
+
+/*< private >
+ * _clutter_event_coalesce_motion:
+ * @event: a %CLUTTER_MOTION or %CLUTTER_TOUCH_UPDATE event
+ * @previous: the event preceding @event, which is going to be dropped
+ *
+ * Prepends the motion history of @previous, followed by the sample
+ * of @previous itself, to the motion history of @event.
+ */
+void
+_clutter_event_coalesce_motion (ClutterEvent       *event,
+                                const ClutterEvent *previous)
+{
+  ClutterEventPrivate *real_event;
+  GArray *old_history, *old_axes;
+  const gdouble *axes;
+  guint n_axes, i;
+  gfloat x, y;
+
+  if (!is_event_allocated (event))
+    return;
+
+  real_event = (ClutterEventPrivate *) event;
+
+  old_history = real_event->motion_history;
+  old_axes = real_event->motion_history_axes;
+
+  /* the history of the previous event comes first, so we can simply
+   * take it over instead of copying it */
+  if (is_event_allocated (previous))
+    {
+      ClutterEventPrivate *real_previous = (ClutterEventPrivate *) previous;
+
+      real_event->motion_history = real_previous->motion_history;
+      real_event->motion_history_axes = real_previous->motion_history_axes;
+
+      real_previous->motion_history = NULL;
+      real_previous->motion_history_axes = NULL;
+    }
+  else
+    {
+      real_event->motion_history = NULL;
+      real_event->motion_history_axes = NULL;
+    }
+
+  clutter_event_get_coords (previous, &x, &y);
+  axes = clutter_event_get_axes (previous, &n_axes);
+
+  motion_history_append (real_event,
+                         clutter_event_get_time (previous),
+                         x, y,
+                         axes, n_axes);
+
+  if (old_history == NULL)
+    return;
+
+  clutter_event_get_axes (event, &n_axes);
+
+  for (i = 0; i < old_history->len; i++)
+    {
+      const ClutterMotionSample *sample;
+
+      sample = &g_array_index (old_history, ClutterMotionSample, i);
+
+      motion_history_append (real_event,
+                             sample->time,
+                             sample->x, sample->y,
+                             sample->axes, n_axes);
+    }
+
+  g_array_free (old_history, TRUE);
+  if (old_axes != NULL)
+    g_array_free (old_axes, TRUE);
+}
+
 /**
  * clutter_event_type:
  * @event: a #ClutterEvent
@@ -144,6 +526,14 @@ clutter_event_type (const ClutterEvent *event)
  *
  * Retrieves the time of the event.
  *
+ * The time is expressed in milliseconds, and its clock depends on the
+ * windowing system backend; events of different backends should not
+ * be compared. The evdev backend asks the kernel to use the same
+ * clock as g_get_monotonic_time(), so the time of its events is not
+ * the wall-clock time; if the kernel does not support changing the
+ * clock of an input device, the time of its events comes from the
+ * wall clock instead.
+ *
  * Return value: the time of the event, or %CLUTTER_CURRENT_TIME
  *
  *
@@ -1100,16 +1490,14 @@ clutter_event_new (ClutterEventType type)
   ClutterEvent *new_event;
   ClutterEventPrivate *priv;
 
-  priv = g_slice_new0 (ClutterEventPrivate);
+  priv = event_blocks_alloc ();
+  memset (priv, 0, sizeof (ClutterEventPrivate));
+
+  priv->self = priv;
 
   new_event = (ClutterEvent *) priv;
   new_event->type = new_event->any.type = type;
 
-  if (G_UNLIKELY (all_events == NULL))
-    all_events = g_hash_table_new (NULL, NULL);
-
-  g_hash_table_replace (all_events, priv, GUINT_TO_POINTER (1));
-
   return new_event;
 }
 
@@ -1144,7 +1532,36 @@ clutter_event_copy (const ClutterEvent *event)
       new_real_event->source_device = real_event->source_device;
       new_real_event->delta_x = real_event->delta_x;
       new_real_event->delta_y = real_event->delta_y;
+      new_real_event->hardware_time = real_event->hardware_time;
       new_real_event->is_pointer_emulated = real_event->is_pointer_emulated;
+
+      if (real_event->motion_history != NULL)
+        {
+          GArray *history = real_event->motion_history;
+
+          new_real_event->motion_history =
+            g_array_sized_new (FALSE, FALSE,
+                               sizeof (ClutterMotionSample),
+                               history->len);
+          g_array_append_vals (new_real_event->motion_history,
+                               history->data,
+                               history->len);
+        }
+
+      if (real_event->motion_history_axes != NULL)
+        {
+          GArray *axes = real_event->motion_history_axes;
+
+          new_real_event->motion_history_axes =
+            g_array_sized_new (FALSE, FALSE, sizeof (gdouble), axes->len);
+          g_array_append_vals (new_real_event->motion_history_axes,
+                               axes->data,
+                               axes->len);
+
+          motion_history_rebase_axes (new_real_event->motion_history,
+                                      (gdouble *) axes->data,
+                                      (gdouble *) new_real_event->motion_history_axes->data);
+        }
     }
 
   device = clutter_event_get_device (event);
@@ -1204,6 +1621,9 @@ clutter_event_free (ClutterEvent *event)
 {
   if (G_LIKELY (event != NULL))
     {
+      ClutterEventBlock *block;
+      guint block_index;
+
       _clutter_backend_free_event_data (clutter_get_default_backend (), event);
 
       switch (event->type)
@@ -1232,8 +1652,17 @@ clutter_event_free (ClutterEvent *event)
           break;
         }
 
-      g_hash_table_remove (all_events, event);
-      g_slice_free (ClutterEventPrivate, (ClutterEventPrivate *) event);
+      block = get_event_block (event, &block_index);
+      if (block != NULL)
+        {
+          ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+          motion_history_free (real_event);
+
+          /* the event goes back to its block, to avoid hitting the
+           * allocator for each event coming from the input devices */
+          event_blocks_release (block, block_index, real_event);
+        }
     }
 }
 
@@ -1533,6 +1962,54 @@ clutter_event_get_axes (const ClutterEvent *event,
   return retval;
 }
 
+/**
+ * clutter_event_get_motion_history:
+ * @event: a #ClutterEvent
+ * @n_samples: (out): return location for the number of samples
+ *
+ * Retrieves the samples of the %CLUTTER_MOTION or %CLUTTER_TOUCH_UPDATE
+ * events that were coalesced into @event, oldest first; the sample of
+ * @event itself is not part of the history.
+ *
+ * Clutter coalesces the motion events coming from the same device
+ * (or the touch updates of the same sequence, even if interleaved with
+ * the updates of other sequences) that are received between two
+ * frames, unless clutter_stage_set_throttle_motion_events() was used
+ * to disable the throttling; the history allows using all
+ * the samples, for instance in drawing applications, while paying
+ * for a single pick per frame.
+ *
+ * Return value: (transfer none) (array length=n_samples): the motion
+ *   history, or %NULL. The returned array is owned by @event
+ *
+ *
+ */
+const ClutterMotionSample *
+clutter_event_get_motion_history (const ClutterEvent *event,
+                                  guint              *n_samples)
+{
+  const ClutterEventPrivate *real_event;
+
+  g_return_val_if_fail (event != NULL, NULL);
+
+  real_event = (const ClutterEventPrivate *) event;
+
+  if (!is_event_allocated (event) ||
+      real_event->motion_history == NULL ||
+      real_event->motion_history->len == 0)
+    {
+      if (n_samples != NULL)
+        *n_samples = 0;
+
+      return NULL;
+    }
+
+  if (n_samples != NULL)
+    *n_samples = real_event->motion_history->len;
+
+  return (const ClutterMotionSample *) real_event->motion_history->data;
+}
+
 /**
  * clutter_event_get_distance:
  * @source: a #ClutterEvent
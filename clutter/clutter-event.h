@@ -114,6 +114,7 @@ typedef struct _ClutterScrollEvent      ClutterScrollEvent;
 typedef struct _ClutterStageStateEvent  ClutterStageStateEvent;
 typedef struct _ClutterCrossingEvent    ClutterCrossingEvent;
 typedef struct _ClutterTouchEvent       ClutterTouchEvent;
+typedef struct _ClutterMotionSample     ClutterMotionSample;
 
 /**
  * ClutterAnyEvent:
@@ -405,6 +406,28 @@ union _ClutterEvent
   ClutterTouchEvent touch;
 };
 
+/**
+ * ClutterMotionSample:
+ * @time: the time of the sample, in milliseconds
+ * @x: the X coordinate of the sample, relative to the stage
+ * @y: the Y coordinate of the sample, relative to the stage
+ * @axes: (array) (allow-none): the axes values of the sample, or %NULL;
+ *   the number of axes is the same as the one returned by
+ *   clutter_event_get_axes()
+ *
+ * A single sample of a pointer motion or touch update, as stored
+ * inside the history returned by clutter_event_get_motion_history().
+ *
+ *
+ */
+struct _ClutterMotionSample
+{
+  guint32 time;
+  gfloat x;
+  gfloat y;
+  gdouble *axes;
+};
+
 GType clutter_event_get_type (void) G_GNUC_CONST;
 
 gboolean                clutter_events_pending                  (void);
@@ -462,6 +485,10 @@ double                  clutter_event_get_angle                 (const ClutterEv
 gdouble *               clutter_event_get_axes                  (const ClutterEvent     *event,
                                                                  guint                  *n_axes);
 
+const ClutterMotionSample *
+                        clutter_event_get_motion_history        (const ClutterEvent     *event,
+                                                                 guint                  *n_samples);
+
 
 gboolean                clutter_event_has_shift_modifier        (const ClutterEvent     *event);
 
@@ -0,0 +1,66 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_FRAME_TIMINGS_PRIVATE_H__
+#define __CLUTTER_FRAME_TIMINGS_PRIVATE_H__
+
+#include <clutter/clutter-frame-timings.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+  CLUTTER_FRAME_PHASE_EVENTS,
+  CLUTTER_FRAME_PHASE_TIMELINES,
+  CLUTTER_FRAME_PHASE_RELAYOUT,
+  CLUTTER_FRAME_PHASE_PAINT,
+  CLUTTER_FRAME_PHASE_SWAP_WAIT
+} ClutterFramePhase;
+
+extern gboolean _clutter_frame_timings_enabled;
+
+/*< private >
+ * _clutter_frame_timings_get_time:
+ *
+ * Retrieves the start time to pass to _clutter_frame_timings_add_phase();
+ * this is cheap enough to be called unconditionally, as it does not
+ * query the clock unless the frame timings are enabled.
+ *
+ * Return value: the monotonic time, or 0 if the frame timings are
+ *   disabled
+ */
+static inline gint64
+_clutter_frame_timings_get_time (void)
+{
+  if (G_LIKELY (!_clutter_frame_timings_enabled))
+    return 0;
+
+  return g_get_monotonic_time ();
+}
+
+void    _clutter_frame_timings_begin_frame      (gint64            frame_time);
+void    _clutter_frame_timings_end_frame        (void);
+void    _clutter_frame_timings_add_phase        (ClutterFramePhase phase,
+                                                 gint64            start_time);
+void    _clutter_frame_timings_add_pick         (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_FRAME_TIMINGS_PRIVATE_H__ */
@@ -0,0 +1,478 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-frame-timings
+ * @Title: Frame timings
+ * @Short_Description: Per-frame timing records
+ *
+ * Clutter can record how long each frame took, split into the phases
+ * of the frame: event processing, timelines advancement, relayout,
+ * paint and waiting for the buffer swap. The records of the last
+ * frames are kept inside a ring buffer, so that the frame timings
+ * can be left enabled on deployed applications, and inspected when
+ * a frame takes longer than expected.
+ *
+ * The frame timings are disabled by default; they can be enabled
+ * at run time using clutter_frame_timings_set_enabled(), or by
+ * setting the <envar>CLUTTER_FRAME_TIMINGS</envar> environment
+ * variable.
+ *
+ * The records can be retrieved using clutter_frame_timings_get_records(),
+ * or serialized using clutter_frame_timings_to_json(); the output of
+ * clutter_frame_timings_to_trace() can be loaded inside the trace
+ * viewer of the Chromium web browser.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <json-glib/json-glib.h>
+
+#include "clutter-frame-timings-private.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* the number of frames kept inside the ring buffer */
+#define N_FRAME_RECORDS         512
+
+gboolean _clutter_frame_timings_enabled = FALSE;
+
+/* the ring buffer of records; frame_records_head is the slot that
+ * will be used by the next frame
+ */
+static ClutterFrameRecord *frame_records = NULL;
+static guint frame_records_head = 0;
+static guint frame_records_len = 0;
+
+/* the frame being recorded */
+static ClutterFrameRecord current_record = { 0, };
+
+static const struct {
+  const gchar *name;
+  gsize offset;
+} frame_phases[] = {
+  { "Events", G_STRUCT_OFFSET (ClutterFrameRecord, events_time) },
+  { "Timelines", G_STRUCT_OFFSET (ClutterFrameRecord, timelines_time) },
+  { "Relayout", G_STRUCT_OFFSET (ClutterFrameRecord, relayout_time) },
+  { "Paint", G_STRUCT_OFFSET (ClutterFrameRecord, paint_time) },
+  { "Swap wait", G_STRUCT_OFFSET (ClutterFrameRecord, swap_wait_time) },
+};
+
+#define FRAME_PHASE_TIME(record,phase) \
+  G_STRUCT_MEMBER (gint64, (record), frame_phases[(phase)].offset)
+
+/*< private >
+ * _clutter_frame_timings_begin_frame:
+ * @frame_time: the time of the frame, in microseconds
+ *
+ * Marks the beginning of a new frame.
+ */
+void
+_clutter_frame_timings_begin_frame (gint64 frame_time)
+{
+  if (G_LIKELY (!_clutter_frame_timings_enabled))
+    return;
+
+  current_record.frame_time = frame_time;
+}
+
+/*< private >
+ * _clutter_frame_timings_end_frame:
+ *
+ * Marks the end of the current frame, and stores its record inside
+ * the ring buffer.
+ */
+void
+_clutter_frame_timings_end_frame (void)
+{
+  ClutterFrameRecord *record;
+
+  if (G_LIKELY (!_clutter_frame_timings_enabled))
+    return;
+
+  /* the frame timings were enabled in the middle of the frame */
+  if (current_record.frame_time == 0)
+    return;
+
+  record = &frame_records[frame_records_head];
+
+  *record = current_record;
+  record->total_time = g_get_monotonic_time () - record->frame_time;
+
+  /* the swap happens while painting the stage */
+  record->paint_time = MAX (record->paint_time - record->swap_wait_time, 0);
+
+  frame_records_head = (frame_records_head + 1) % N_FRAME_RECORDS;
+  frame_records_len = MIN (frame_records_len + 1, N_FRAME_RECORDS);
+
+  CLUTTER_NOTE (SCHEDULER,
+                "Frame took %" G_GINT64_FORMAT " usecs "
+                "(events: %" G_GINT64_FORMAT ", "
+                "timelines: %" G_GINT64_FORMAT ", "
+                "relayout: %" G_GINT64_FORMAT ", "
+                "paint: %" G_GINT64_FORMAT ", "
+                "swap: %" G_GINT64_FORMAT ", "
+                "picks: %u)",
+                record->total_time,
+                record->events_time,
+                record->timelines_time,
+                record->relayout_time,
+                record->paint_time,
+                record->swap_wait_time,
+                record->n_picks);
+
+  memset (&current_record, 0, sizeof (ClutterFrameRecord));
+}
+
+/*< private >
+ * _clutter_frame_timings_add_phase:
+ * @phase: the phase of the frame
+ * @start_time: the value returned by _clutter_frame_timings_get_time()
+ *   at the start of the phase
+ *
+ * Adds the time elapsed since @start_time to the @phase of the
+ * current frame.
+ */
+void
+_clutter_frame_timings_add_phase (ClutterFramePhase phase,
+                                  gint64            start_time)
+{
+  if (G_LIKELY (!_clutter_frame_timings_enabled) || start_time == 0)
+    return;
+
+  FRAME_PHASE_TIME (&current_record, phase) +=
+    g_get_monotonic_time () - start_time;
+}
+
+void
+_clutter_frame_timings_add_pick (void)
+{
+  if (G_LIKELY (!_clutter_frame_timings_enabled))
+    return;
+
+  current_record.n_picks += 1;
+}
+
+/**
+ * clutter_frame_timings_set_enabled:
+ * @enabled: whether the frame timings should be recorded
+ *
+ * Enables or disables the recording of the frame timings.
+ *
+ * Disabling the frame timings does not discard the frames
+ * already recorded; use clutter_frame_timings_reset() for that.
+ *
+ *
+ */
+void
+clutter_frame_timings_set_enabled (gboolean enabled)
+{
+  enabled = !!enabled;
+
+  if (_clutter_frame_timings_enabled == enabled)
+    return;
+
+  if (enabled && frame_records == NULL)
+    frame_records = g_new0 (ClutterFrameRecord, N_FRAME_RECORDS);
+
+  memset (&current_record, 0, sizeof (ClutterFrameRecord));
+
+  _clutter_frame_timings_enabled = enabled;
+}
+
+/**
+ * clutter_frame_timings_get_enabled:
+ *
+ * Retrieves whether the frame timings are being recorded.
+ *
+ * Return value: %TRUE if the frame timings are enabled
+ *
+ *
+ */
+gboolean
+clutter_frame_timings_get_enabled (void)
+{
+  return _clutter_frame_timings_enabled;
+}
+
+/**
+ * clutter_frame_timings_reset:
+ *
+ * Discards all the frame timings recorded so far.
+ *
+ *
+ */
+void
+clutter_frame_timings_reset (void)
+{
+  frame_records_head = 0;
+  frame_records_len = 0;
+
+  memset (&current_record, 0, sizeof (ClutterFrameRecord));
+}
+
+/**
+ * clutter_frame_timings_get_n_records:
+ *
+ * Retrieves the number of frames currently recorded.
+ *
+ * Return value: the number of frame records
+ *
+ *
+ */
+guint
+clutter_frame_timings_get_n_records (void)
+{
+  return frame_records_len;
+}
+
+/**
+ * clutter_frame_timings_get_records:
+ * @records: (out caller-allocates) (array length=n_records): an array
+ *   of #ClutterFrameRecord
+ * @n_records: the number of elements of @records
+ *
+ * Copies the records of the most recent frames inside @records,
+ * from the oldest to the newest.
+ *
+ * Return value: the number of records copied inside @records
+ *
+ *
+ */
+guint
+clutter_frame_timings_get_records (ClutterFrameRecord *records,
+                                   guint               n_records)
+{
+  guint first, i;
+
+  g_return_val_if_fail (records != NULL || n_records == 0, 0);
+
+  n_records = MIN (n_records, frame_records_len);
+
+  /* skip the oldest records that do not fit */
+  first = frame_records_head + N_FRAME_RECORDS - n_records;
+
+  for (i = 0; i < n_records; i++)
+    records[i] = frame_records[(first + i) % N_FRAME_RECORDS];
+
+  return n_records;
+}
+
+static gchar *
+frame_timings_build_data (JsonBuilder *builder,
+                          gsize       *length)
+{
+  JsonGenerator *generator;
+  JsonNode *root;
+  gchar *res;
+
+  root = json_builder_get_root (builder);
+
+  generator = json_generator_new ();
+  json_generator_set_root (generator, root);
+
+  res = json_generator_to_data (generator, length);
+
+  g_object_unref (generator);
+  json_node_free (root);
+
+  return res;
+}
+
+/**
+ * clutter_frame_timings_to_json:
+ * @length: (out) (allow-none): return location for the length of
+ *   the returned string, or %NULL
+ *
+ * Serializes the recorded frame timings as a JSON object, containing
+ * a "frames" array with one object for each frame, from the oldest
+ * to the newest. All the times are in microseconds.
+ *
+ * Return value: (transfer full): a newly allocated string; use g_free()
+ *   when done
+ *
+ *
+ */
+gchar *
+clutter_frame_timings_to_json (gsize *length)
+{
+  JsonBuilder *builder;
+  gchar *res;
+  guint i, j;
+
+  builder = json_builder_new ();
+
+  json_builder_begin_object (builder);
+
+  json_builder_set_member_name (builder, "frames");
+  json_builder_begin_array (builder);
+
+  for (i = 0; i < frame_records_len; i++)
+    {
+      guint pos = (frame_records_head + N_FRAME_RECORDS - frame_records_len + i)
+                % N_FRAME_RECORDS;
+      const ClutterFrameRecord *record = &frame_records[pos];
+
+      json_builder_begin_object (builder);
+
+      json_builder_set_member_name (builder, "frame-time");
+      json_builder_add_int_value (builder, record->frame_time);
+
+      json_builder_set_member_name (builder, "total");
+      json_builder_add_int_value (builder, record->total_time);
+
+      for (j = 0; j < G_N_ELEMENTS (frame_phases); j++)
+        {
+          gchar *name = g_ascii_strdown (frame_phases[j].name, -1);
+
+          g_strdelimit (name, " ", '-');
+
+          json_builder_set_member_name (builder, name);
+          json_builder_add_int_value (builder, FRAME_PHASE_TIME (record, j));
+
+          g_free (name);
+        }
+
+      json_builder_set_member_name (builder, "picks");
+      json_builder_add_int_value (builder, record->n_picks);
+
+      json_builder_end_object (builder);
+    }
+
+  json_builder_end_array (builder);
+
+  json_builder_end_object (builder);
+
+  res = frame_timings_build_data (builder, length);
+
+  g_object_unref (builder);
+
+  return res;
+}
+
+static void
+frame_timings_add_trace_event (JsonBuilder *builder,
+                               const gchar *name,
+                               gint64       timestamp,
+                               gint64       duration)
+{
+  json_builder_begin_object (builder);
+
+  json_builder_set_member_name (builder, "name");
+  json_builder_add_string_value (builder, name);
+
+  json_builder_set_member_name (builder, "cat");
+  json_builder_add_string_value (builder, "clutter");
+
+  json_builder_set_member_name (builder, "ph");
+  json_builder_add_string_value (builder, "X");
+
+  json_builder_set_member_name (builder, "ts");
+  json_builder_add_int_value (builder, timestamp);
+
+  json_builder_set_member_name (builder, "dur");
+  json_builder_add_int_value (builder, duration);
+
+  json_builder_set_member_name (builder, "pid");
+  json_builder_add_int_value (builder, 0);
+
+  json_builder_set_member_name (builder, "tid");
+  json_builder_add_int_value (builder, 0);
+
+  json_builder_end_object (builder);
+}
+
+/**
+ * clutter_frame_timings_to_trace:
+ * @length: (out) (allow-none): return location for the length of
+ *   the returned string, or %NULL
+ *
+ * Serializes the recorded frame timings using the Trace Event format
+ * understood by the trace viewer of the Chromium web browser.
+ *
+ * Each frame is represented by a complete event, and each phase of
+ * the frame by a nested event; since only the overall duration of
+ * each phase is recorded, the phases are laid out one after the
+ * other, starting at the beginning of the frame.
+ *
+ * Return value: (transfer full): a newly allocated string; use g_free()
+ *   when done
+ *
+ *
+ */
+gchar *
+clutter_frame_timings_to_trace (gsize *length)
+{
+  JsonBuilder *builder;
+  gchar *res;
+  guint i, j;
+
+  builder = json_builder_new ();
+
+  json_builder_begin_object (builder);
+
+  json_builder_set_member_name (builder, "traceEvents");
+  json_builder_begin_array (builder);
+
+  for (i = 0; i < frame_records_len; i++)
+    {
+      guint pos = (frame_records_head + N_FRAME_RECORDS - frame_records_len + i)
+                % N_FRAME_RECORDS;
+      const ClutterFrameRecord *record = &frame_records[pos];
+      gint64 timestamp = record->frame_time;
+
+      frame_timings_add_trace_event (builder, "Frame",
+                                     record->frame_time,
+                                     record->total_time);
+
+      for (j = 0; j < G_N_ELEMENTS (frame_phases); j++)
+        {
+          gint64 duration = FRAME_PHASE_TIME (record, j);
+
+          if (duration == 0)
+            continue;
+
+          frame_timings_add_trace_event (builder, frame_phases[j].name,
+                                         timestamp,
+                                         duration);
+
+          timestamp += duration;
+        }
+    }
+
+  json_builder_end_array (builder);
+
+  json_builder_set_member_name (builder, "displayTimeUnit");
+  json_builder_add_string_value (builder, "ms");
+
+  json_builder_end_object (builder);
+
+  res = frame_timings_build_data (builder, length);
+
+  g_object_unref (builder);
+
+  return res;
+}
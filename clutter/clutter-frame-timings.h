@@ -0,0 +1,86 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_FRAME_TIMINGS_H__
+#define __CLUTTER_FRAME_TIMINGS_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterFrameRecord      ClutterFrameRecord;
+
+/**
+ * ClutterFrameRecord:
+ * @frame_time: the monotonic time at the start of the frame, in
+ *   microseconds
+ * @total_time: the time spent in the frame, in microseconds
+ * @events_time: the time spent processing events, in microseconds
+ * @timelines_time: the time spent advancing the timelines, in
+ *   microseconds
+ * @relayout_time: the time spent relayouting the stages, in
+ *   microseconds
+ * @paint_time: the time spent painting the stages, excluding
+ *   @swap_wait_time, in microseconds
+ * @swap_wait_time: the time spent waiting for the buffers of
+ *   the stages to be swapped, in microseconds
+ * @n_picks: the number of times the stages were picked
+ *
+ * The timings of a frame, as recorded when the frame timings are
+ * enabled using clutter_frame_timings_set_enabled().
+ *
+ * The work done between two frames, for instance picking the stage
+ * in response to events, is accounted to the following frame.
+ *
+ *
+ */
+struct _ClutterFrameRecord
+{
+  gint64 frame_time;
+  gint64 total_time;
+
+  gint64 events_time;
+  gint64 timelines_time;
+  gint64 relayout_time;
+  gint64 paint_time;
+  gint64 swap_wait_time;
+
+  guint n_picks;
+};
+
+void            clutter_frame_timings_set_enabled       (gboolean            enabled);
+gboolean        clutter_frame_timings_get_enabled       (void);
+void            clutter_frame_timings_reset             (void);
+
+guint           clutter_frame_timings_get_n_records     (void);
+guint           clutter_frame_timings_get_records       (ClutterFrameRecord *records,
+                                                         guint               n_records);
+
+gchar *         clutter_frame_timings_to_json           (gsize              *length);
+gchar *         clutter_frame_timings_to_trace          (gsize              *length);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_FRAME_TIMINGS_H__ */
@@ -97,6 +97,17 @@
 #define MAX_GESTURE_POINTS (10)
 #define FLOAT_EPSILON   (1e-15)
 
+/* the number of recent motion samples used to estimate the velocity,
+ * and their maximum age, in milliseconds */
+#define VELOCITY_SAMPLES        (16)
+#define VELOCITY_WINDOW         (100)
+
+typedef struct
+{
+  gfloat x, y;
+  gint64 time;
+} VelocitySample;
+
 typedef struct
 {
   ClutterInputDevice *device;
@@ -109,6 +120,12 @@ typedef struct
   gint64 last_delta_time;
   gfloat last_delta_x, last_delta_y;
   gfloat release_x, release_y;
+
+  /* ring of the most recent samples, including the ones coming
+   * from the motion history of the events */
+  VelocitySample samples[VELOCITY_SAMPLES];
+  guint next_sample;
+  guint n_samples;
 } GesturePoint;
 
 struct _ClutterGestureActionPrivate
@@ -150,6 +167,71 @@ static guint gesture_signals[LAST_SIGNAL] = { 0, };
 
 G_DEFINE_TYPE (ClutterGestureAction, clutter_gesture_action, CLUTTER_TYPE_ACTION);
 
+static void
+gesture_point_add_sample (GesturePoint *point,
+                          gfloat        x,
+                          gfloat        y,
+                          gint64        time_)
+{
+  VelocitySample *sample = &point->samples[point->next_sample];
+
+  sample->x = x;
+  sample->y = y;
+  sample->time = time_;
+
+  point->next_sample = (point->next_sample + 1) % VELOCITY_SAMPLES;
+  point->n_samples = MIN (point->n_samples + 1, VELOCITY_SAMPLES);
+}
+
+/* estimates the velocity from the samples received during the last
+ * VELOCITY_WINDOW milliseconds; returns FALSE if there are not enough
+ * samples to do so */
+static gboolean
+gesture_point_estimate_velocity (const GesturePoint *point,
+                                 gfloat             *velocity_x,
+                                 gfloat             *velocity_y)
+{
+  const VelocitySample *newest, *oldest;
+  guint i;
+  gint64 d_t;
+
+  if (point->n_samples < 2)
+    return FALSE;
+
+  newest = &point->samples[(point->next_sample + VELOCITY_SAMPLES - 1)
+                           % VELOCITY_SAMPLES];
+  oldest = newest;
+
+  for (i = 2; i <= point->n_samples; i++)
+    {
+      const VelocitySample *sample;
+
+      sample = &point->samples[(point->next_sample + VELOCITY_SAMPLES - i)
+                               % VELOCITY_SAMPLES];
+
+      if (newest->time - sample->time > VELOCITY_WINDOW)
+        break;
+
+      oldest = sample;
+    }
+
+  /* the pointer did not move during the window */
+  if (oldest == newest)
+    {
+      *velocity_x = *velocity_y = 0.f;
+      return TRUE;
+    }
+
+  d_t = newest->time - oldest->time;
+  if (d_t <= 0)
+    return FALSE;
+
+  *velocity_x = (newest->x - oldest->x) / d_t;
+  *velocity_y = (newest->y - oldest->y) / d_t;
+
+  return TRUE;
+}
+
 static GesturePoint *
 gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
 {
@@ -173,6 +255,11 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   point->last_delta_x = point->last_delta_y = 0;
   point->last_delta_time = 0;
 
+  point->next_sample = point->n_samples = 0;
+  gesture_point_add_sample (point,
+                            point->press_x, point->press_y,
+                            point->last_motion_time);
+
   if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS)
     point->sequence = clutter_event_get_event_sequence (event);
   else
@@ -225,11 +312,19 @@ static void
 gesture_update_motion_point (GesturePoint *point,
                              ClutterEvent *event)
 {
+  const ClutterMotionSample *history;
   gfloat motion_x, motion_y;
   gint64 _time;
+  guint i, n_samples;
 
   clutter_event_get_coords (event, &motion_x, &motion_y);
 
+  /* the samples coalesced into the event make the velocity estimate
+   * more accurate */
+  history = clutter_event_get_motion_history (event, &n_samples);
+  for (i = 0; i < n_samples; i++)
+    gesture_point_add_sample (point, history[i].x, history[i].y, history[i].time);
+
   clutter_event_free (point->last_event);
   point->last_event = clutter_event_copy (event);
 
@@ -241,6 +336,8 @@ gesture_update_motion_point (GesturePoint *point,
   _time = clutter_event_get_time (event);
   point->last_delta_time = _time - point->last_motion_time;
   point->last_motion_time = _time;
+
+  gesture_point_add_sample (point, motion_x, motion_y, _time);
 }
 
 static void
@@ -259,6 +356,8 @@ gesture_update_release_point (GesturePoint *point,
    * releasing it. */
    _time = clutter_event_get_time (event);
    point->last_delta_time += _time - point->last_motion_time;
+
+   gesture_point_add_sample (point, point->release_x, point->release_y, _time);
 }
 
 static gint
@@ -930,6 +1029,22 @@ clutter_gesture_action_get_release_coords (ClutterGestureAction *action,
  *
  * Retrieves the velocity, in stage pixels per millisecond, of the
  * latest motion event during the dragging.
+ *
+ * The velocity is no longer the one between the last two motion
+ * events: it is averaged between the latest sample of the touch point
+ * and the oldest one received at most 100 milliseconds before it. The
+ * samples are the press, the motion and the release events of the
+ * touch point, plus the samples coalesced into its motion events (see
+ * clutter_event_get_motion_history()); only the 16 most recent ones
+ * are kept, so with high frequency devices the window can be shorter
+ * than 100 milliseconds.
+ *
+ * If no other sample was received during the 100 milliseconds before
+ * the latest one, the velocity is 0, even if the touch point moved
+ * before that. Until the touch point has two samples, the velocity
+ * is the one between the last two motion events.
+ *
+ * Return value: the magnitude of the velocity
  */
 gfloat
 clutter_gesture_action_get_velocity (ClutterGestureAction *action,
@@ -938,11 +1053,26 @@ clutter_gesture_action_get_velocity (ClutterGestureAction *action,
                                      gfloat               *velocity_y)
 {
   gfloat d_x, d_y, distance, velocity;
+  gfloat v_x, v_y;
   gint64 d_t;
 
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
   g_return_val_if_fail (action->priv->points->len > point, 0);
 
+  if (gesture_point_estimate_velocity (&g_array_index (action->priv->points,
+                                                       GesturePoint,
+                                                       point),
+                                       &v_x, &v_y))
+    {
+      if (velocity_x)
+        *velocity_x = v_x;
+
+      if (velocity_y)
+        *velocity_y = v_y;
+
+      return sqrtf ((v_x * v_x) + (v_y * v_y));
+    }
+
   distance = clutter_gesture_action_get_motion_delta (action, point,
                                                       &d_x, &d_y);
 
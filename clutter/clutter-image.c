@@ -36,6 +36,11 @@
  * </xi:include>
  * </programlisting></informalexample>
  *
+ * Large images can be loaded using clutter_image_load_async(): the image
+ * data is decoded inside a worker thread, and then uploaded to the GPU
+ * over multiple frames, so that the loading does not block the redraw
+ * of the stages.
+ *
  * #ClutterImage is available since Clutter 1.10.
  */
 
@@ -47,6 +52,8 @@
 
 #include "clutter-image.h"
 
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
 #include "clutter-color.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
@@ -57,8 +64,38 @@
 struct _ClutterImagePrivate
 {
   CoglTexture *texture;
+
+  /* the last load started with clutter_image_load_async() */
+  struct _ImageLoadJob *load_job;
 };
 
+typedef struct _ImageLoadJob
+{
+  ClutterImage *image;
+
+  GInputStream *stream;
+  GCancellable *cancellable;
+
+  /* the maximum size of the decoded image, or -1 */
+  gint max_width;
+  gint max_height;
+
+  /* the result of clutter_image_load_async() */
+  GSimpleAsyncResult *result;
+
+  GdkPixbuf *pixbuf;
+
+  /* the texture being uploaded, and the first row to upload */
+  CoglTexture *texture;
+  gint next_row;
+} ImageLoadJob;
+
+/* the amount of image data uploaded at each frame while loading */
+#define IMAGE_UPLOAD_BUDGET     (1024 * 1024)
+
+/* the size of the chunks read from the stream while decoding */
+#define IMAGE_READ_CHUNK_SIZE   (64 * 1024)
+
 static void clutter_content_iface_init (ClutterContentIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterImage, clutter_image, G_TYPE_OBJECT,
@@ -76,6 +113,9 @@ clutter_image_finalize (GObject *gobject)
 {
   ClutterImagePrivate *priv = CLUTTER_IMAGE (gobject)->priv;
 
+  /* the load jobs hold a reference on the image */
+  g_assert (priv->load_job == NULL);
+
   if (priv->texture != NULL)
     {
       cogl_object_unref (priv->texture);
@@ -427,3 +467,354 @@ clutter_image_get_texture (ClutterImage *image)
 
   return image->priv->texture;
 }
+
+static void
+image_load_job_free (ImageLoadJob *job)
+{
+  if (job->image->priv->load_job == job)
+    job->image->priv->load_job = NULL;
+
+  if (job->texture != NULL)
+    cogl_object_unref (job->texture);
+
+  if (job->pixbuf != NULL)
+    g_object_unref (job->pixbuf);
+
+  if (job->cancellable != NULL)
+    g_object_unref (job->cancellable);
+
+  g_object_unref (job->stream);
+  g_object_unref (job->result);
+  g_object_unref (job->image);
+
+  g_slice_free (ImageLoadJob, job);
+}
+
+/* completes the load, and releases the job */
+static void
+image_load_job_complete (ImageLoadJob *job,
+                         GError       *error)
+{
+  if (error != NULL)
+    g_simple_async_result_take_error (job->result, error);
+
+  g_simple_async_result_complete_in_idle (job->result);
+
+  image_load_job_free (job);
+}
+
+static gboolean
+image_load_job_check_cancelled (ImageLoadJob  *job,
+                                GError       **error)
+{
+  if (g_cancellable_set_error_if_cancelled (job->cancellable, error))
+    return TRUE;
+
+  /* a newer load replaced this one */
+  if (job->image->priv->load_job != job)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                           _("The image load was superseded"));
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+image_load_size_prepared (GdkPixbufLoader *loader,
+                          gint             width,
+                          gint             height,
+                          gpointer         user_data)
+{
+  ImageLoadJob *job = user_data;
+  gdouble scale = 1.0;
+
+  /* we only ever scale down, keeping the aspect ratio, so that the
+   * decoders supporting it can skip the data we are not going to use
+   */
+  if (job->max_width > 0 && width > job->max_width)
+    scale = MIN (scale, (gdouble) job->max_width / width);
+
+  if (job->max_height > 0 && height > job->max_height)
+    scale = MIN (scale, (gdouble) job->max_height / height);
+
+  if (scale < 1.0)
+    gdk_pixbuf_loader_set_size (loader,
+                                MAX (1, (gint) (width * scale + 0.5)),
+                                MAX (1, (gint) (height * scale + 0.5)));
+}
+
+/* runs inside a worker thread */
+static void
+image_load_decode (GSimpleAsyncResult *res,
+                   GObject            *gobject,
+                   GCancellable       *cancellable)
+{
+  ImageLoadJob *job = g_simple_async_result_get_op_res_gpointer (res);
+  GdkPixbufLoader *loader;
+  GError *error = NULL;
+  guchar *buffer;
+  gssize n_read;
+
+  loader = gdk_pixbuf_loader_new ();
+  g_signal_connect (loader, "size-prepared",
+                    G_CALLBACK (image_load_size_prepared),
+                    job);
+
+  buffer = g_malloc (IMAGE_READ_CHUNK_SIZE);
+
+  do
+    {
+      n_read = g_input_stream_read (job->stream,
+                                    buffer, IMAGE_READ_CHUNK_SIZE,
+                                    cancellable,
+                                    &error);
+
+      if (n_read > 0 &&
+          !gdk_pixbuf_loader_write (loader, buffer, n_read, &error))
+        n_read = -1;
+    }
+  while (n_read > 0);
+
+  g_free (buffer);
+
+  /* the loader must always be closed, even on error */
+  if (error != NULL)
+    gdk_pixbuf_loader_close (loader, NULL);
+  else if (gdk_pixbuf_loader_close (loader, &error))
+    {
+      job->pixbuf = gdk_pixbuf_loader_get_pixbuf (loader);
+
+      if (job->pixbuf != NULL)
+        g_object_ref (job->pixbuf);
+      else
+        g_set_error_literal (&error, CLUTTER_IMAGE_ERROR,
+                             CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                             _("Unable to load image data"));
+    }
+
+  g_object_unref (loader);
+
+  if (error != NULL)
+    g_simple_async_result_take_error (res, error);
+}
+
+static gboolean
+image_load_upload_rows (gpointer data)
+{
+  ImageLoadJob *job = data;
+  ClutterImagePrivate *priv = job->image->priv;
+  CoglPixelFormat format;
+  GError *error = NULL;
+  const guchar *pixels;
+  gint width, height, stride;
+  gint n_rows;
+
+  if (image_load_job_check_cancelled (job, &error))
+    {
+      image_load_job_complete (job, error);
+      return G_SOURCE_REMOVE;
+    }
+
+  width = gdk_pixbuf_get_width (job->pixbuf);
+  height = gdk_pixbuf_get_height (job->pixbuf);
+  stride = gdk_pixbuf_get_rowstride (job->pixbuf);
+  pixels = gdk_pixbuf_get_pixels (job->pixbuf);
+  format = gdk_pixbuf_get_has_alpha (job->pixbuf)
+         ? COGL_PIXEL_FORMAT_RGBA_8888
+         : COGL_PIXEL_FORMAT_RGB_888;
+
+  n_rows = CLAMP (IMAGE_UPLOAD_BUDGET / stride, 1, height - job->next_row);
+
+  if (!cogl_texture_set_region (job->texture,
+                                0, 0,
+                                0, job->next_row,
+                                width, n_rows,
+                                width, n_rows,
+                                format,
+                                stride,
+                                pixels + (job->next_row * stride)))
+    {
+      g_set_error_literal (&error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                           _("Unable to load image data"));
+      image_load_job_complete (job, error);
+      return G_SOURCE_REMOVE;
+    }
+
+  CLUTTER_NOTE (PAINT, "Image[%p]: uploaded rows %d-%d of %d",
+                job->image,
+                job->next_row,
+                job->next_row + n_rows - 1,
+                height);
+
+  job->next_row += n_rows;
+
+  if (job->next_row < height)
+    {
+      /* make sure that there is going to be another frame, even if
+       * nothing else is queueing a redraw
+       */
+      _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+
+      return G_SOURCE_CONTINUE;
+    }
+
+  /* the whole texture has been uploaded, so we can replace the
+   * contents of the image in one go
+   */
+  if (priv->texture != NULL)
+    cogl_object_unref (priv->texture);
+
+  priv->texture = job->texture;
+  job->texture = NULL;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (job->image));
+
+  image_load_job_complete (job, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+image_load_decode_done (GObject      *gobject,
+                        GAsyncResult *res,
+                        gpointer      user_data)
+{
+  ImageLoadJob *job = user_data;
+  GError *error = NULL;
+
+  if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (res), &error) ||
+      image_load_job_check_cancelled (job, &error))
+    {
+      image_load_job_complete (job, error);
+      return;
+    }
+
+  job->texture =
+    cogl_texture_new_with_size (gdk_pixbuf_get_width (job->pixbuf),
+                                gdk_pixbuf_get_height (job->pixbuf),
+                                COGL_TEXTURE_NONE,
+                                gdk_pixbuf_get_has_alpha (job->pixbuf)
+                                  ? COGL_PIXEL_FORMAT_RGBA_8888_PRE
+                                  : COGL_PIXEL_FORMAT_RGB_888);
+  if (job->texture == NULL)
+    {
+      g_set_error_literal (&error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                           _("Unable to load image data"));
+      image_load_job_complete (job, error);
+      return;
+    }
+
+  /* upload the image data in bands of rows, one band per frame */
+  clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                         CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                         image_load_upload_rows,
+                                         job,
+                                         NULL);
+}
+
+/**
+ * clutter_image_load_async:
+ * @image: a #ClutterImage
+ * @stream: a #GInputStream with the encoded image data
+ * @max_width: the maximum width of the image, or -1
+ * @max_height: the maximum height of the image, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): a function to call when the image is loaded
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously loads the image data contained inside @stream, in
+ * any format supported by GdkPixbuf.
+ *
+ * The image data is decoded inside a worker thread; if the image is
+ * larger than @max_width or @max_height, it will be scaled down while
+ * decoding, preserving its aspect ratio. You can use the size of the
+ * allocation of the actors using @image to avoid decoding data that
+ * is never going to be displayed.
+ *
+ * The decoded image data is then uploaded over multiple frames, and
+ * the previous contents of @image are displayed until the upload is
+ * complete.
+ *
+ * Starting a new load will cancel any pending load on @image.
+ *
+ * When the image data has been loaded, @callback will be called; you
+ * should call clutter_image_load_finish() to retrieve the result of
+ * the operation.
+ *
+ *
+ */
+void
+clutter_image_load_async (ClutterImage        *image,
+                          GInputStream        *stream,
+                          gint                 max_width,
+                          gint                 max_height,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  GSimpleAsyncResult *decode;
+  ImageLoadJob *job;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  job = g_slice_new0 (ImageLoadJob);
+  job->image = g_object_ref (image);
+  job->stream = g_object_ref (stream);
+  job->cancellable = cancellable != NULL ? g_object_ref (cancellable) : NULL;
+  job->max_width = max_width;
+  job->max_height = max_height;
+  job->result = g_simple_async_result_new (G_OBJECT (image),
+                                           callback, user_data,
+                                           clutter_image_load_async);
+
+  /* any previous job will notice it has been replaced */
+  image->priv->load_job = job;
+
+  decode = g_simple_async_result_new (G_OBJECT (image),
+                                      image_load_decode_done, job,
+                                      image_load_decode);
+  g_simple_async_result_set_op_res_gpointer (decode, job, NULL);
+  g_simple_async_result_run_in_thread (decode,
+                                       image_load_decode,
+                                       G_PRIORITY_DEFAULT,
+                                       cancellable);
+  g_object_unref (decode);
+}
+
+/**
+ * clutter_image_load_finish:
+ * @image: a #ClutterImage
+ * @result: the #GAsyncResult passed to the callback of
+ *   clutter_image_load_async()
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes a load started with clutter_image_load_async().
+ *
+ * Return value: %TRUE if the image data was successfully loaded,
+ *   and %FALSE otherwise.
+ *
+ *
+ */
+gboolean
+clutter_image_load_finish (ClutterImage  *image,
+                           GAsyncResult  *result,
+                           GError       **error)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+                                                        G_OBJECT (image),
+                                                        clutter_image_load_async),
+                        FALSE);
+
+  if (g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result),
+                                             error))
+    return FALSE;
+
+  return TRUE;
+}
@@ -29,6 +29,7 @@
 #ifndef __CLUTTER_IMAGE_H__
 #define __CLUTTER_IMAGE_H__
 
+#include <gio/gio.h>
 #include <cogl/cogl.h>
 #include <clutter/clutter-types.h>
 
@@ -131,6 +132,17 @@ gboolean                clutter_image_set_bytes         (ClutterImage
                                                          guint                         row_stride,
                                                          GError                      **error);
 
+void                    clutter_image_load_async        (ClutterImage                 *image,
+                                                         GInputStream                 *stream,
+                                                         gint                          max_width,
+                                                         gint                          max_height,
+                                                         GCancellable                 *cancellable,
+                                                         GAsyncReadyCallback           callback,
+                                                         gpointer                      user_data);
+gboolean                clutter_image_load_finish       (ClutterImage                 *image,
+                                                         GAsyncResult                 *result,
+                                                         GError                      **error);
+
 #if defined(COGL_ENABLE_EXPERIMENTAL_API) && defined(CLUTTER_ENABLE_EXPERIMENTAL_API)
 
 CoglTexture *           clutter_image_get_texture       (ClutterImage                 *image);
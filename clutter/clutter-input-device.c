@@ -653,7 +653,6 @@ _clutter_input_device_set_actor (ClutterInputDevice   *device,
 
           event = clutter_event_new (CLUTTER_LEAVE);
           event->crossing.time = device->current_time;
-          event->crossing.flags = 0;
           event->crossing.stage = device->stage;
           event->crossing.source = old_actor;
           event->crossing.x = device->current_x;
@@ -689,7 +688,6 @@ _clutter_input_device_set_actor (ClutterInputDevice   *device,
 
           event = clutter_event_new (CLUTTER_ENTER);
           event->crossing.time = device->current_time;
-          event->crossing.flags = 0;
           event->crossing.stage = device->stage;
           event->crossing.x = device->current_x;
           event->crossing.y = device->current_y;
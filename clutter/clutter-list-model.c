@@ -32,7 +32,9 @@
  * #ClutterListModel is a #ClutterModel implementation provided by
  * Clutter. #ClutterListModel uses a #GSequence for storing the
  * values for each row, so it's optimized for insertion and look up
- * in sorted lists.
+ * in sorted lists. When a filter is set, #ClutterListModel caches its
+ * result for each row, so that looking up the rows that are not
+ * filtered out does not require running the filter again.
  *
  * #ClutterListModel is available since Clutter 0.6
  */
@@ -82,9 +84,25 @@ struct _ClutterListModelPrivate
 {
   GSequence *sequence;
 
+  /* the rows that are not filtered out, in the same order as they
+   * appear inside the sequence; this is only used when a filter is
+   * set
+   */
+  GSequence *filter_index;
+
   ClutterModelIter *temp_iter;
 };
 
+typedef struct _ListModelRow
+{
+  GValue *values;
+
+  /* the position of the row inside the filter index, or NULL if
+   * the row is filtered out
+   */
+  GSequenceIter *filter_iter;
+} ListModelRow;
+
 struct _ClutterListModelIter
 {
   ClutterModelIter parent_instance;
@@ -110,7 +128,7 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
                                    GValue           *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
+  ListModelRow *row;
   GValue *iter_value;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
@@ -118,8 +136,8 @@ clutter_list_model_iter_get_value (ClutterModelIter *iter,
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
+  row = g_sequence_get (iter_default->seq_iter);
+  iter_value = &row->values[column];
   g_assert (iter_value != NULL);
 
   if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
@@ -163,7 +181,7 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
                                    const GValue     *value)
 {
   ClutterListModelIter *iter_default;
-  GValue *values;
+  ListModelRow *row;
   GValue *iter_value;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
@@ -171,8 +189,8 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  values = g_sequence_get (iter_default->seq_iter);
-  iter_value = &values[column];
+  row = g_sequence_get (iter_default->seq_iter);
+  iter_value = &row->values[column];
   g_assert (iter_value != NULL);
 
   if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (iter_value)))
@@ -210,99 +228,117 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
     g_value_copy (value, iter_value);
 }
 
+static gint
+compare_seq_iters (gconstpointer a,
+                   gconstpointer b,
+                   gpointer      data G_GNUC_UNUSED)
+{
+  return g_sequence_iter_compare ((GSequenceIter *) a, (GSequenceIter *) b);
+}
+
+/*< private >
+ * filter_index_lookup:
+ * @priv: the private data of a #ClutterListModel
+ * @seq_iter: a position inside the sequence
+ *
+ * Retrieves the first row of the filter index that is at, or after,
+ * @seq_iter inside the sequence.
+ *
+ * Return value: a position inside the filter index
+ */
+static GSequenceIter *
+filter_index_lookup (ClutterListModelPrivate *priv,
+                     GSequenceIter           *seq_iter)
+{
+  ListModelRow *row;
+
+  if (g_sequence_iter_is_end (seq_iter))
+    return g_sequence_get_end_iter (priv->filter_index);
+
+  row = g_sequence_get (seq_iter);
+  if (row->filter_iter != NULL)
+    return row->filter_iter;
+
+  return g_sequence_search (priv->filter_index, seq_iter,
+                            compare_seq_iters,
+                            NULL);
+}
+
 static gboolean
 clutter_list_model_iter_is_first (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
+  ClutterListModelPrivate *priv;
   ClutterModel *model;
-  ClutterModelIter *temp_iter;
-  GSequence *sequence;
-  GSequenceIter *begin, *end;
+  ListModelRow *row;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
-  model = clutter_model_iter_get_model (iter);
-
-  sequence = CLUTTER_LIST_MODEL (model)->priv->sequence;
+  /* ::prev moves the iterator to the beginning of the sequence when
+   * there are no more rows before the current one
+   */
+  if (g_sequence_iter_is_begin (iter_default->seq_iter))
+    return TRUE;
 
-  begin = g_sequence_get_begin_iter (sequence);
-  end   = iter_default->seq_iter;
+  model = clutter_model_iter_get_model (iter);
 
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
+  priv = CLUTTER_LIST_MODEL (model)->priv;
+  if (priv->filter_index == NULL)
+    return FALSE;
 
-  while (!g_sequence_iter_is_begin (begin))
+  /* a row that is filtered out is before the first valid row if
+   * its closest valid row is the first one
+   */
+  if (!g_sequence_iter_is_end (iter_default->seq_iter))
     {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = begin;
-
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          end = begin;
-          break;
-        }
-
-      begin = g_sequence_iter_next (begin);
+      row = g_sequence_get (iter_default->seq_iter);
+      if (row->filter_iter != NULL)
+        return FALSE;
     }
 
-  /* This is because the 'begin_iter' is always *before* the last valid
-   * iter, otherwise we'd have endless loops 
-   */
-  end = g_sequence_iter_prev (end);
-
-  return iter_default->seq_iter == end;
+  return g_sequence_iter_is_begin (filter_index_lookup (priv, iter_default->seq_iter));
 }
 
 static gboolean
 clutter_list_model_iter_is_last (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
+  ClutterListModelPrivate *priv;
   ClutterModel *model;
-  GSequence *sequence;
-  GSequenceIter *begin, *end;
+  ListModelRow *row;
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
   g_assert (iter_default->seq_iter != NULL);
 
+  /* This is because ::next moves the iterator to the 'end_iter', which
+   * is always *after* the last valid iter. Otherwise we'd have endless
+   * loops 
+   */
   if (g_sequence_iter_is_end (iter_default->seq_iter))
     return TRUE;
 
   model = clutter_model_iter_get_model (iter);
 
-  sequence = CLUTTER_LIST_MODEL (model)->priv->sequence;
-
-  begin = g_sequence_get_end_iter (sequence);
-  begin = g_sequence_iter_prev (begin);
-  end   = iter_default->seq_iter;
-
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
-
-  while (!g_sequence_iter_is_begin (begin))
-    {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = begin;
+  priv = CLUTTER_LIST_MODEL (model)->priv;
+  if (priv->filter_index == NULL)
+    return FALSE;
 
-      if (clutter_model_filter_iter (model, temp_iter))
-        {
-          end = begin;
-          break;
-        }
-
-      begin = g_sequence_iter_prev (begin);
-    }
-
-  /* This is because the 'end_iter' is always *after* the last valid iter.
-   * Otherwise we'd have endless loops 
+  /* a row that is filtered out is after the last valid row if no
+   * valid row follows it
    */
-  end = g_sequence_iter_next (end);
+  row = g_sequence_get (iter_default->seq_iter);
+  if (row->filter_iter != NULL)
+    return FALSE;
 
-  return iter_default->seq_iter == end;
+  return g_sequence_iter_is_end (filter_index_lookup (priv, iter_default->seq_iter));
 }
 
 static ClutterModelIter *
 clutter_list_model_iter_next (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
+  ClutterListModelPrivate *priv;
   ClutterModel *model = NULL;
   GSequenceIter *filter_next;
   guint row;
@@ -313,26 +349,42 @@ clutter_list_model_iter_next (ClutterModelIter *iter)
   model = clutter_model_iter_get_model (iter);
   row   = clutter_model_iter_get_row (iter);
 
-  filter_next = g_sequence_iter_next (iter_default->seq_iter);
-  g_assert (filter_next != NULL);
+  priv = CLUTTER_LIST_MODEL (model)->priv;
 
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
-
-  while (!g_sequence_iter_is_end (filter_next))
+  if (priv->filter_index != NULL)
     {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = filter_next;
+      ListModelRow *list_row = NULL;
+
+      if (!g_sequence_iter_is_end (iter_default->seq_iter))
+        list_row = g_sequence_get (iter_default->seq_iter);
+
+      /* the next row that is not filtered out is either the one
+       * following the current row inside the filter index, or the
+       * first one after the current row if it is filtered out
+       */
+      if (list_row != NULL && list_row->filter_iter != NULL)
+        filter_next = g_sequence_iter_next (list_row->filter_iter);
+      else
+        filter_next = filter_index_lookup (priv, iter_default->seq_iter);
 
-      if (clutter_model_filter_iter (model, temp_iter))
+      if (g_sequence_iter_is_end (filter_next))
         {
           row += 1;
-          break;
+          filter_next = g_sequence_get_end_iter (priv->sequence);
+        }
+      else
+        {
+          row = g_sequence_iter_get_position (filter_next);
+          filter_next = g_sequence_get (filter_next);
         }
-
-      filter_next = g_sequence_iter_next (filter_next);
     }
+  else
+    {
+      filter_next = g_sequence_iter_next (iter_default->seq_iter);
+      g_assert (filter_next != NULL);
 
-  if (g_sequence_iter_is_end (filter_next))
-    row += 1;
+      row += 1;
+    }
 
   /* update the iterator and return it */
   _clutter_model_iter_set_row (CLUTTER_MODEL_ITER (iter_default), row);
@@ -345,7 +397,7 @@ static ClutterModelIter *
 clutter_list_model_iter_prev (ClutterModelIter *iter)
 {
   ClutterListModelIter *iter_default;
-  ClutterModelIter *temp_iter;
+  ClutterListModelPrivate *priv;
   ClutterModel *model;
   GSequenceIter *filter_prev;
   guint row;
@@ -356,26 +408,34 @@ clutter_list_model_iter_prev (ClutterModelIter *iter)
   model = clutter_model_iter_get_model (iter);
   row   = clutter_model_iter_get_row (iter);
 
-  filter_prev = g_sequence_iter_prev (iter_default->seq_iter);
-  g_assert (filter_prev != NULL);
-
-  temp_iter = CLUTTER_LIST_MODEL (model)->priv->temp_iter;
+  priv = CLUTTER_LIST_MODEL (model)->priv;
 
-  while (!g_sequence_iter_is_begin (filter_prev))
+  if (priv->filter_index != NULL)
     {
-      CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = filter_prev;
+      /* the previous row that is not filtered out precedes the first
+       * one at, or after, the current row inside the filter index
+       */
+      filter_prev = filter_index_lookup (priv, iter_default->seq_iter);
 
-      if (clutter_model_filter_iter (model, temp_iter))
+      if (g_sequence_iter_is_begin (filter_prev))
         {
           row -= 1;
-          break;
+          filter_prev = g_sequence_get_begin_iter (priv->sequence);
+        }
+      else
+        {
+          filter_prev = g_sequence_iter_prev (filter_prev);
+          row = g_sequence_iter_get_position (filter_prev);
+          filter_prev = g_sequence_get (filter_prev);
         }
-
-      filter_prev = g_sequence_iter_prev (filter_prev);
     }
+  else
+    {
+      filter_prev = g_sequence_iter_prev (iter_default->seq_iter);
+      g_assert (filter_prev != NULL);
 
-  if (g_sequence_iter_is_begin (filter_prev))
-    row -= 1;
+      row -= 1;
+    }
 
   /* update the iterator and return it */
   _clutter_model_iter_set_row (CLUTTER_MODEL_ITER (iter_default), row);
@@ -442,50 +502,33 @@ clutter_list_model_get_iter_at_row (ClutterModel *model,
 {
   ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
   GSequence *sequence = model_default->priv->sequence;
-  GSequenceIter *filter_next;
-  gint seq_length = g_sequence_get_length (sequence);
+  GSequence *filter_index = model_default->priv->filter_index;
   ClutterListModelIter *retval;
-  gint count = -1;
-
-  if (row >= seq_length)
-    return NULL;
-
-  retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                         "model", model,
-                         "row", row,
-                         NULL);
+  GSequenceIter *seq_iter;
 
-  /* short-circuit in case we don't have a filter in place */
-  if (!clutter_model_get_filter_set (model))
+  /* the row is a position among the rows that are not filtered out */
+  if (filter_index != NULL)
     {
-      retval->seq_iter = g_sequence_get_iter_at_pos (sequence, row);
+      if (row >= g_sequence_get_length (filter_index))
+        return NULL;
 
-      return CLUTTER_MODEL_ITER (retval);
+      seq_iter = g_sequence_get_iter_at_pos (filter_index, row);
+      seq_iter = g_sequence_get (seq_iter);
     }
-
-  filter_next = g_sequence_get_begin_iter (sequence);
-  g_assert (filter_next != NULL);
-
-  while (!g_sequence_iter_is_end (filter_next))
+  else
     {
-      retval->seq_iter = filter_next;
+      if (row >= g_sequence_get_length (sequence))
+        return NULL;
 
-      if (clutter_model_filter_iter (model, CLUTTER_MODEL_ITER (retval)))
-        {
-          /* We've found a row that is valid under the filter */
-          count++;
-          if (count == row)
-            break;
-        }
-
-      filter_next = g_sequence_iter_next (filter_next);
+      seq_iter = g_sequence_get_iter_at_pos (sequence, row);
     }
 
-  if (count != row)
-    {
-      g_object_unref (retval);
-      return NULL;
-    }
+  retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                         "model", model,
+                         "row", row,
+                         NULL);
+  retval->seq_iter = seq_iter;
+
   return CLUTTER_MODEL_ITER (retval);
 }
 
@@ -497,29 +540,33 @@ clutter_list_model_insert_row (ClutterModel *model,
   GSequence *sequence = model_default->priv->sequence;
   ClutterListModelIter *retval;
   guint n_columns, i, pos;
-  GValue *values;
+  ListModelRow *row;
   GSequenceIter *seq_iter;
 
   n_columns = clutter_model_get_n_columns (model);
-  values = g_new0 (GValue, n_columns);
+
+  /* the row is filtered out until its values have been set */
+  row = g_slice_new (ListModelRow);
+  row->values = g_new0 (GValue, n_columns);
+  row->filter_iter = NULL;
 
   for (i = 0; i < n_columns; i++)
-    g_value_init (&values[i], clutter_model_get_column_type (model, i));
+    g_value_init (&row->values[i], clutter_model_get_column_type (model, i));
 
   if (index_ < 0)
     {
-      seq_iter = g_sequence_append (sequence, values);
+      seq_iter = g_sequence_append (sequence, row);
       pos = g_sequence_get_length (sequence) - 1;
     }
   else if (index_ == 0)
     {
-      seq_iter = g_sequence_prepend (sequence, values);
+      seq_iter = g_sequence_prepend (sequence, row);
       pos = 0;
     }
   else
     {
       seq_iter = g_sequence_get_iter_at_pos (sequence, index_);
-      seq_iter = g_sequence_insert_before (seq_iter, values);
+      seq_iter = g_sequence_insert_before (seq_iter, row);
       pos = index_;
     }
 
@@ -538,42 +585,42 @@ clutter_list_model_remove_row (ClutterModel *model,
 {
   ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
   GSequence *sequence = model_default->priv->sequence;
+  GSequence *filter_index = model_default->priv->filter_index;
+  ClutterModelIter *iter;
   GSequenceIter *seq_iter;
-  guint pos = 0;
 
-  seq_iter = g_sequence_get_begin_iter (sequence);
-  while (!g_sequence_iter_is_end (seq_iter))
+  if (filter_index != NULL)
     {
-      if (clutter_model_filter_row (model, pos))
-        {
-          if (pos == row)
-            {  
-              ClutterModelIter *iter;
-
-              iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                                   "model", model,
-                                   "row", pos,
-                                   NULL);
-              CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
-
-              /* the actual row is removed from the sequence inside
-               * the ::row-removed signal class handler, so that every
-               * handler connected to ::row-removed will still get
-               * a valid iterator, and every signal connected to
-               * ::row-removed with the AFTER flag will get an updated
-               * model
-               */
-              g_signal_emit_by_name (model, "row-removed", iter);
-
-              g_object_unref (iter);
-
-              break;
-            }
-        }
+      if (row >= g_sequence_get_length (filter_index))
+        return;
 
-      pos += 1;
-      seq_iter = g_sequence_iter_next (seq_iter);
+      seq_iter = g_sequence_get_iter_at_pos (filter_index, row);
+      seq_iter = g_sequence_get (seq_iter);
+    }
+  else
+    {
+      if (row >= g_sequence_get_length (sequence))
+        return;
+
+      seq_iter = g_sequence_get_iter_at_pos (sequence, row);
     }
+
+  iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                       "model", model,
+                       "row", row,
+                       NULL);
+  CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
+
+  /* the actual row is removed from the sequence inside
+   * the ::row-removed signal class handler, so that every
+   * handler connected to ::row-removed will still get
+   * a valid iterator, and every signal connected to
+   * ::row-removed with the AFTER flag will get an updated
+   * model
+   */
+  g_signal_emit_by_name (model, "row-removed", iter);
+
+  g_object_unref (iter);
 }
 
 typedef struct
@@ -589,16 +636,51 @@ sort_model_default (gconstpointer a,
                     gconstpointer b,
                     gpointer      data)
 {
-  const GValue *row_a = a;
-  const GValue *row_b = b;
+  const ListModelRow *row_a = a;
+  const ListModelRow *row_b = b;
   SortClosure *clos = data;
 
   return clos->func (clos->model,
-                     &row_a[clos->column],
-                     &row_b[clos->column],
+                     &row_a->values[clos->column],
+                     &row_b->values[clos->column],
                      clos->data);
 }
 
+/*< private >
+ * clutter_list_model_rebuild_filter_index:
+ * @model: a #ClutterListModel
+ *
+ * Rebuilds the filter index of @model in a single pass over the
+ * sequence, using the filter result cached for each row; this is
+ * needed after the sequence has been sorted.
+ */
+static void
+clutter_list_model_rebuild_filter_index (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  GSequence *filter_index;
+  GSequenceIter *seq_iter;
+
+  if (priv->filter_index == NULL)
+    return;
+
+  filter_index = g_sequence_new (NULL);
+
+  seq_iter = g_sequence_get_begin_iter (priv->sequence);
+  while (!g_sequence_iter_is_end (seq_iter))
+    {
+      ListModelRow *row = g_sequence_get (seq_iter);
+
+      if (row->filter_iter != NULL)
+        row->filter_iter = g_sequence_append (filter_index, seq_iter);
+
+      seq_iter = g_sequence_iter_next (seq_iter);
+    }
+
+  g_sequence_free (priv->filter_index);
+  priv->filter_index = filter_index;
+}
+
 static void
 clutter_list_model_resort (ClutterModel         *model,
                            ClutterModelSortFunc  func,
@@ -614,6 +696,123 @@ clutter_list_model_resort (ClutterModel         *model,
   g_sequence_sort (CLUTTER_LIST_MODEL (model)->priv->sequence,
                    sort_model_default,
                    &sort_closure);
+
+  clutter_list_model_rebuild_filter_index (CLUTTER_LIST_MODEL (model));
+}
+
+static void
+clutter_list_model_resort_row (ClutterModel         *model,
+                               ClutterModelIter     *iter,
+                               ClutterModelSortFunc  func,
+                               gpointer              data)
+{
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
+  ClutterListModelIter *iter_default = CLUTTER_LIST_MODEL_ITER (iter);
+  SortClosure sort_closure = { NULL, 0, NULL, NULL };
+  GSequenceIter *filter_iter;
+  ListModelRow *row;
+
+  sort_closure.model  = model;
+  sort_closure.column = clutter_model_get_sorting_column (model);
+  sort_closure.func   = func;
+  sort_closure.data   = data;
+
+  /* the rest of the sequence is sorted, so we can just move the row
+   * to its position instead of sorting the whole sequence
+   */
+  g_sequence_sort_changed (iter_default->seq_iter,
+                           sort_model_default,
+                           &sort_closure);
+
+  if (priv->filter_index == NULL)
+    {
+      _clutter_model_iter_set_row (iter,
+                                   g_sequence_iter_get_position (iter_default->seq_iter));
+      return;
+    }
+
+  row = g_sequence_get (iter_default->seq_iter);
+  if (row->filter_iter != NULL)
+    g_sequence_sort_changed (row->filter_iter, compare_seq_iters, NULL);
+
+  /* the row of an iterator is the position among the filtered rows;
+   * a row that is filtered out takes the position of the first valid
+   * row following it
+   */
+  filter_iter = filter_index_lookup (priv, iter_default->seq_iter);
+  _clutter_model_iter_set_row (iter, g_sequence_iter_get_position (filter_iter));
+}
+
+static void
+clutter_list_model_refilter (ClutterModel *model)
+{
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
+  ClutterModelIter *temp_iter = priv->temp_iter;
+  GSequenceIter *seq_iter;
+  gboolean filter_set;
+
+  filter_set = clutter_model_get_filter_set (model);
+
+  if (priv->filter_index != NULL)
+    g_sequence_free (priv->filter_index);
+
+  priv->filter_index = filter_set ? g_sequence_new (NULL) : NULL;
+
+  /* the filter is run once for each row, and the rows that are not
+   * filtered out are appended to the index in order
+   */
+  seq_iter = g_sequence_get_begin_iter (priv->sequence);
+  while (!g_sequence_iter_is_end (seq_iter))
+    {
+      ListModelRow *row = g_sequence_get (seq_iter);
+
+      row->filter_iter = NULL;
+
+      if (filter_set)
+        {
+          CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = seq_iter;
+
+          if (clutter_model_filter_iter (model, temp_iter))
+            row->filter_iter = g_sequence_append (priv->filter_index, seq_iter);
+        }
+
+      seq_iter = g_sequence_iter_next (seq_iter);
+    }
+}
+
+static void
+clutter_list_model_refilter_row (ClutterModel     *model,
+                                 ClutterModelIter *iter)
+{
+  ClutterListModelPrivate *priv = CLUTTER_LIST_MODEL (model)->priv;
+  ClutterListModelIter *iter_default = CLUTTER_LIST_MODEL_ITER (iter);
+  GSequenceIter *filter_iter;
+  ListModelRow *row;
+
+  if (priv->filter_index == NULL)
+    return;
+
+  row = g_sequence_get (iter_default->seq_iter);
+
+  if (clutter_model_filter_iter (model, iter))
+    {
+      if (row->filter_iter == NULL)
+        row->filter_iter = g_sequence_insert_sorted (priv->filter_index,
+                                                     iter_default->seq_iter,
+                                                     compare_seq_iters,
+                                                     NULL);
+    }
+  else if (row->filter_iter != NULL)
+    {
+      g_sequence_remove (row->filter_iter);
+      row->filter_iter = NULL;
+    }
+
+  /* a row that is filtered out takes the position of the first valid
+   * row following it, like in ::resort_row
+   */
+  filter_iter = filter_index_lookup (priv, iter_default->seq_iter);
+  _clutter_model_iter_set_row (iter, g_sequence_iter_get_position (filter_iter));
 }
 
 static guint
@@ -621,11 +820,10 @@ clutter_list_model_get_n_rows (ClutterModel *model)
 {
   ClutterListModel *list_model = CLUTTER_LIST_MODEL (model);
 
-  /* short-circuit in case we don't have a filter in place */
-  if (!clutter_model_get_filter_set (model))
-    return g_sequence_get_length (list_model->priv->sequence);
+  if (list_model->priv->filter_index != NULL)
+    return g_sequence_get_length (list_model->priv->filter_index);
 
-  return CLUTTER_MODEL_CLASS (clutter_list_model_parent_class)->get_n_rows (model);
+  return g_sequence_get_length (list_model->priv->sequence);
 }
 
 static void
@@ -634,18 +832,22 @@ clutter_list_model_row_removed (ClutterModel     *model,
 {
   ClutterListModelIter *iter_default;
   guint i, n_columns;
-  GValue *values;
+  ListModelRow *row;
 
   n_columns = clutter_model_get_n_columns (model);
 
   iter_default = CLUTTER_LIST_MODEL_ITER (iter);
 
-  values = g_sequence_get (iter_default->seq_iter);
+  row = g_sequence_get (iter_default->seq_iter);
+
+  if (row->filter_iter != NULL)
+    g_sequence_remove (row->filter_iter);
 
   for (i = 0; i < n_columns; i++)
-    g_value_unset (&values[i]);
+    g_value_unset (&row->values[i]);
 
-  g_free (values);
+  g_free (row->values);
+  g_slice_free (ListModelRow, row);
 
   g_sequence_remove (iter_default->seq_iter);
   iter_default->seq_iter = NULL;
@@ -664,17 +866,21 @@ clutter_list_model_finalize (GObject *gobject)
   iter = g_sequence_get_begin_iter (sequence);
   while (!g_sequence_iter_is_end (iter))
     {
-      GValue *values = g_sequence_get (iter);
+      ListModelRow *row = g_sequence_get (iter);
 
       for (i = 0; i < n_columns; i++)
-        g_value_unset (&values[i]);
+        g_value_unset (&row->values[i]);
 
-      g_free (values);
+      g_free (row->values);
+      g_slice_free (ListModelRow, row);
 
       iter = g_sequence_iter_next (iter);
     }
   g_sequence_free (sequence);
 
+  if (model->priv->filter_index != NULL)
+    g_sequence_free (model->priv->filter_index);
+
   G_OBJECT_CLASS (clutter_list_model_parent_class)->finalize (gobject);
 }
 
@@ -707,6 +913,9 @@ clutter_list_model_class_init (ClutterListModelClass *klass)
   model_class->insert_row      = clutter_list_model_insert_row;
   model_class->remove_row      = clutter_list_model_remove_row;
   model_class->resort          = clutter_list_model_resort;
+  model_class->resort_row      = clutter_list_model_resort_row;
+  model_class->refilter        = clutter_list_model_refilter;
+  model_class->refilter_row    = clutter_list_model_refilter_row;
   model_class->get_n_rows      = clutter_list_model_get_n_rows;
 
   model_class->row_removed     = clutter_list_model_row_removed;
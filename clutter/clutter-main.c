@@ -104,6 +104,7 @@
 #include "clutter-device-manager-private.h"
 #include "clutter-event-private.h"
 #include "clutter-feature.h"
+#include "clutter-frame-timings.h"
 #include "clutter-main.h"
 #include "clutter-master-clock.h"
 #include "clutter-private.h"
@@ -154,8 +155,11 @@ static gboolean clutter_disable_mipmap_text  = FALSE;
 static gboolean clutter_use_fuzzy_picking    = FALSE;
 static gboolean clutter_enable_accessibility = TRUE;
 static gboolean clutter_sync_to_vblank       = TRUE;
+static gboolean clutter_frame_timings        = FALSE;
 
 static guint clutter_default_fps             = 60;
+static guint clutter_max_redraw_rects        = 4;
+static guint clutter_text_layout_cache_size  = 0;
 
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
@@ -321,6 +325,16 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_sync_to_vblank = bool_value;
 
+  bool_value =
+    g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
+                            "FrameTimings",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_frame_timings = bool_value;
+
   int_value =
     g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
                             "DefaultFps",
@@ -331,6 +345,26 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_default_fps = int_value;
 
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "MaxRedrawRects",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_max_redraw_rects = CLAMP (int_value, 1, 64);
+
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "TextLayoutCacheSize",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_text_layout_cache_size = MAX (int_value, 0);
+
   str_value =
     g_key_file_get_string (keyfile, ENVIRONMENT_GROUP,
                            "TextDirection",
@@ -1582,6 +1616,22 @@ pre_parse_hook (GOptionContext  *context,
       clutter_default_fps = CLAMP (default_fps, 1, 1000);
     }
 
+  env_string = g_getenv ("CLUTTER_MAX_REDRAW_RECTS");
+  if (env_string)
+    {
+      gint max_redraw_rects = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_max_redraw_rects = CLAMP (max_redraw_rects, 1, 64);
+    }
+
+  env_string = g_getenv ("CLUTTER_TEXT_LAYOUT_CACHE_SIZE");
+  if (env_string)
+    {
+      gint cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_text_layout_cache_size = MAX (cache_size, 0);
+    }
+
   env_string = g_getenv ("CLUTTER_DISABLE_MIPMAPPED_TEXT");
   if (env_string)
     clutter_disable_mipmap_text = TRUE;
@@ -1594,6 +1644,10 @@ pre_parse_hook (GOptionContext  *context,
   if (g_strcmp0 (env_string, "none") == 0)
     clutter_sync_to_vblank = FALSE;
 
+  env_string = g_getenv ("CLUTTER_FRAME_TIMINGS");
+  if (env_string)
+    clutter_frame_timings = TRUE;
+
   return _clutter_backend_pre_parse (backend, error);
 }
 
@@ -1629,6 +1683,9 @@ post_parse_hook (GOptionContext  *context,
   clutter_context->show_fps = clutter_show_fps;
   clutter_context->options_parsed = TRUE;
 
+  if (clutter_frame_timings)
+    clutter_frame_timings_set_enabled (TRUE);
+
   /* If not asked to defer display setup, call clutter_init_real(),
    * which in turn calls the backend post parse hooks.
    */
@@ -2243,7 +2300,33 @@ clutter_do_event (ClutterEvent *event)
    * because we've "looked ahead" and know all motion events that
    * will occur before drawing the frame.
    */
-  _clutter_stage_queue_event (event->any.stage, event);
+  _clutter_stage_queue_event (event->any.stage, event, TRUE);
+}
+
+/*< private >
+ * _clutter_do_event_take:
+ * @event: (transfer full): a #ClutterEvent
+ *
+ * Like clutter_do_event(), but takes ownership of @event, which is
+ * moved to the event queue of its stage instead of being copied.
+ *
+ * This is meant to be used by the backends for the events they pop
+ * off the main event queue.
+ */
+void
+_clutter_do_event_take (ClutterEvent *event)
+{
+  if (event->any.stage == NULL ||
+      CLUTTER_ACTOR_IN_DESTRUCTION (event->any.stage))
+    {
+      if (event->any.stage == NULL)
+        g_warning ("%s: Event does not have a stage: discarding.", G_STRFUNC);
+
+      clutter_event_free (event);
+      return;
+    }
+
+  _clutter_stage_queue_event (event->any.stage, event, FALSE);
 }
 
 static void
@@ -2610,6 +2693,18 @@ _clutter_process_event (ClutterEvent *event)
       return;
     }
 
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (CLUTTER_HAS_DEBUG (EVENT))
+    {
+      gint64 hardware_time = _clutter_event_get_hardware_time (event);
+
+      if (hardware_time != 0)
+        CLUTTER_NOTE (EVENT, "Processing event of type %d, latency: %.3f ms",
+                      event->type,
+                      (g_get_monotonic_time () - hardware_time) / 1000.0);
+    }
+#endif
+
   /* push events on a stack, so that we don't need to
    * add an event parameter to all signals that can be emitted within
    * an event chain
@@ -3474,6 +3569,36 @@ _clutter_get_sync_to_vblank (void)
   return clutter_sync_to_vblank;
 }
 
+/*< private >
+ * _clutter_get_max_redraw_rects:
+ *
+ * Retrieves the maximum number of rectangles that a stage should
+ * use to describe the region to redraw; past this number, the
+ * region is replaced by its extents.
+ *
+ * Return value: the maximum number of redraw rectangles
+ */
+guint
+_clutter_get_max_redraw_rects (void)
+{
+  return clutter_max_redraw_rects;
+}
+
+/*< private >
+ * _clutter_get_text_layout_cache_size:
+ *
+ * Retrieves the size of the layout cache shared by all the
+ * #ClutterText actors.
+ *
+ * Return value: the size of the cache, in bytes; 0 if the cache
+ *   is disabled
+ */
+gsize
+_clutter_get_text_layout_cache_size (void)
+{
+  return (gsize) clutter_text_layout_cache_size * 1024;
+}
+
 void
 _clutter_debug_messagev (const char *format,
                          va_list     var_args)
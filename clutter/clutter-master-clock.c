@@ -36,7 +36,9 @@
 #endif
 
 #include "clutter-master-clock.h"
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-frame-timings-private.h"
 #include "clutter-private.h"
 #include "clutter-profile.h"
 #include "clutter-stage-manager-private.h"
@@ -66,8 +68,13 @@ struct _ClutterMasterClock
 {
   GObject parent_instance;
 
-  /* the list of timelines handled by the clock */
-  GSList *timelines;
+  /* the list of timelines handled by the clock, and the link of
+   * each timeline inside the list, for fast removal */
+  GQueue timelines;
+  GHashTable *timeline_links;
+
+  /* the timelines being advanced in the current frame */
+  GPtrArray *tick_timelines;
 
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
@@ -142,7 +149,7 @@ master_clock_is_running (ClutterMasterClock *master_clock)
 
   stages = clutter_stage_manager_peek_stages (stage_manager);
 
-  if (master_clock->timelines)
+  if (!g_queue_is_empty (&master_clock->timelines))
     return TRUE;
 
   for (l = stages; l; l = l->next)
@@ -251,7 +258,7 @@ master_clock_reschedule_stage_updates (ClutterMasterClock *master_clock,
       _clutter_stage_clear_update_time (l->data);
 
       /* And if there is still work to be done, schedule a new one */
-      if (master_clock->timelines ||
+      if (!g_queue_is_empty (&master_clock->timelines) ||
           _clutter_stage_has_queued_events (l->data) ||
           _clutter_stage_needs_update (l->data))
         _clutter_stage_schedule_update (l->data);
@@ -349,6 +356,7 @@ master_clock_process_events (ClutterMasterClock *master_clock,
                              GSList             *stages)
 {
   GSList *l;
+  gint64 timings_start = _clutter_frame_timings_get_time ();
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
@@ -367,6 +375,8 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_event_process);
 
+  _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_EVENTS, timings_start);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
     clutter_warn_if_over_budget (master_clock, start, "Event processing");
@@ -386,7 +396,10 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 static void
 master_clock_advance_timelines (ClutterMasterClock *master_clock)
 {
-  GSList *timelines, *l;
+  GPtrArray *timelines = master_clock->tick_timelines;
+  GList *l;
+  guint i;
+  gint64 timings_start = _clutter_frame_timings_get_time ();
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
@@ -400,7 +413,7 @@ master_clock_advance_timelines (ClutterMasterClock *master_clock)
   /* we protect ourselves from timelines being removed during
    * the advancement by other timelines by copying the list of
    * timelines, taking a reference on them, iterating over the
-   * copied list and then releasing the reference.
+   * copy and then releasing the reference.
    *
    * we cannot simply take a reference on the timelines and still
    * use the list held by the master clock because the do_tick()
@@ -417,18 +430,30 @@ master_clock_advance_timelines (ClutterMasterClock *master_clock)
    * and remove_timeline() would not find the timeline, failing
    * and leaving a dangling pointer behind.
    */
-  timelines = g_slist_copy (master_clock->timelines);
-  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+  for (l = master_clock->timelines.head; l != NULL; l = l->next)
+    g_ptr_array_add (timelines, g_object_ref (l->data));
 
   CLUTTER_TIMER_START (_clutter_uprof_context, master_timeline_advance);
 
-  for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+  /* the notifications of the properties changed by the transitions
+   * are emitted once all the timelines have been advanced */
+  _clutter_actor_begin_transition_notify_batch ();
+
+  for (i = 0; i < timelines->len; i++)
+    _clutter_timeline_do_tick (g_ptr_array_index (timelines, i),
+                               master_clock->cur_tick / 1000);
+
+  _clutter_actor_end_transition_notify_batch ();
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_timeline_advance);
 
-  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
-  g_slist_free (timelines);
+  for (i = 0; i < timelines->len; i++)
+    g_object_unref (g_ptr_array_index (timelines, i));
+
+  g_ptr_array_set_size (timelines, 0);
+
+  _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_TIMELINES,
+                                    timings_start);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -562,6 +587,8 @@ clutter_clock_dispatch (GSource     *source,
   /* Get the time to use for this frame */
   master_clock->cur_tick = g_source_get_time (source);
 
+  _clutter_frame_timings_begin_frame (master_clock->cur_tick);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   master_clock->remaining_budget = master_clock->frame_budget;
 #endif
@@ -600,6 +627,8 @@ clutter_clock_dispatch (GSource     *source,
 
   master_clock->prev_tick = master_clock->cur_tick;
 
+  _clutter_frame_timings_end_frame ();
+
   _clutter_threads_release_lock ();
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_dispatch_timer);
@@ -612,7 +641,9 @@ clutter_master_clock_finalize (GObject *gobject)
 {
   ClutterMasterClock *master_clock = CLUTTER_MASTER_CLOCK (gobject);
 
-  g_slist_free (master_clock->timelines);
+  g_queue_clear (&master_clock->timelines);
+  g_hash_table_destroy (master_clock->timeline_links);
+  g_ptr_array_free (master_clock->tick_timelines, TRUE);
 
   G_OBJECT_CLASS (clutter_master_clock_parent_class)->finalize (gobject);
 }
@@ -630,6 +661,10 @@ clutter_master_clock_init (ClutterMasterClock *self)
 {
   GSource *source;
 
+  g_queue_init (&self->timelines);
+  self->timeline_links = g_hash_table_new (NULL, NULL);
+  self->tick_timelines = g_ptr_array_new ();
+
   source = clutter_clock_source_new (self);
   self->source = source;
 
@@ -679,13 +714,15 @@ _clutter_master_clock_add_timeline (ClutterMasterClock *master_clock,
 {
   gboolean is_first;
 
-  if (g_slist_find (master_clock->timelines, timeline))
+  if (g_hash_table_lookup (master_clock->timeline_links, timeline) != NULL)
     return;
 
-  is_first = master_clock->timelines == NULL;
+  is_first = g_queue_is_empty (&master_clock->timelines);
 
-  master_clock->timelines = g_slist_prepend (master_clock->timelines,
-                                             timeline);
+  g_queue_push_head (&master_clock->timelines, timeline);
+  g_hash_table_insert (master_clock->timeline_links,
+                       timeline,
+                       master_clock->timelines.head);
 
   if (is_first)
     {
@@ -706,8 +743,14 @@ void
 _clutter_master_clock_remove_timeline (ClutterMasterClock *master_clock,
                                        ClutterTimeline    *timeline)
 {
-  master_clock->timelines = g_slist_remove (master_clock->timelines,
-                                            timeline);
+  GList *link_;
+
+  link_ = g_hash_table_lookup (master_clock->timeline_links, timeline);
+  if (link_ == NULL)
+    return;
+
+  g_hash_table_remove (master_clock->timeline_links, timeline);
+  g_queue_delete_link (&master_clock->timelines, link_);
 }
 
 /*
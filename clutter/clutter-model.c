@@ -192,6 +192,8 @@ enum
 
   SORT_CHANGED,
   FILTER_CHANGED,
+
+  ROWS_CHANGED,
   
   LAST_SIGNAL
 };
@@ -224,6 +226,11 @@ struct _ClutterModelPrivate
   ClutterModelSortFunc    sort_func;
   gpointer                sort_data;
   GDestroyNotify          sort_notify;
+
+  /* see clutter_model_freeze_rows() */
+  guint                   rows_freeze_count;
+  gint                    first_changed_row;
+  guint                   rows_need_resort : 1;
 };
 
 static GType
@@ -463,6 +470,31 @@ clutter_model_class_init (ClutterModelClass *klass)
                   NULL, NULL,
                   _clutter_marshal_VOID__VOID,
                   G_TYPE_NONE, 0);
+  /**
+   * ClutterModel::rows-changed:
+   * @model: the #ClutterModel on which the signal is emitted
+   * @first_row: the first row that changed
+   * @n_rows: the number of rows from @first_row that changed
+   *
+   * The ::rows-changed signal is emitted by clutter_model_thaw_rows()
+   * in place of the ::row-added and ::row-changed signals that would
+   * have been emitted while the rows were frozen.
+   *
+   * Rows that were added shift the following rows, so the range
+   * extends to the end of the model.
+   *
+   *
+   */
+  model_signals[ROWS_CHANGED] =
+    g_signal_new ("rows-changed",
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  _clutter_marshal_VOID__UINT_UINT,
+                  G_TYPE_NONE, 2,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT);
 }
 
 static void
@@ -476,6 +508,8 @@ clutter_model_init (ClutterModel *self)
   priv->column_types = NULL;
   priv->column_names = NULL;
 
+  priv->first_changed_row = -1;
+
   priv->filter_func = NULL;
   priv->filter_data = NULL;
   priv->filter_notify = NULL;
@@ -785,6 +819,156 @@ clutter_model_resort (ClutterModel *model)
     klass->resort (model, priv->sort_func, priv->sort_data);
 }
 
+/*< private >
+ * clutter_model_resort_row:
+ * @model: a #ClutterModel
+ * @iter: a #ClutterModelIter
+ *
+ * Moves the row pointed by @iter to its position in the sorted
+ * @model, after its value in the sorting column changed; if the
+ * rows are frozen, the model is resorted once they are thawed.
+ */
+static void
+clutter_model_resort_row (ClutterModel     *model,
+                          ClutterModelIter *iter)
+{
+  ClutterModelPrivate *priv = model->priv;
+  ClutterModelClass *klass = CLUTTER_MODEL_GET_CLASS (model);
+
+  if (priv->rows_freeze_count > 0)
+    {
+      priv->rows_need_resort = TRUE;
+      return;
+    }
+
+  if (klass->resort_row != NULL && priv->sort_func != NULL)
+    klass->resort_row (model, iter, priv->sort_func, priv->sort_data);
+  else
+    clutter_model_resort (model);
+}
+
+/*< private >
+ * clutter_model_refilter_row:
+ * @model: a #ClutterModel
+ * @iter: a #ClutterModelIter
+ *
+ * Checks again whether the row pointed by @iter is filtered out,
+ * after its values changed.
+ */
+static void
+clutter_model_refilter_row (ClutterModel     *model,
+                            ClutterModelIter *iter)
+{
+  ClutterModelClass *klass = CLUTTER_MODEL_GET_CLASS (model);
+
+  if (klass->refilter_row != NULL && model->priv->filter_func != NULL)
+    klass->refilter_row (model, iter);
+}
+
+static inline void
+clutter_model_add_changed_row (ClutterModel *model,
+                               guint         row)
+{
+  ClutterModelPrivate *priv = model->priv;
+
+  if (priv->first_changed_row < 0 || row < priv->first_changed_row)
+    priv->first_changed_row = row;
+}
+
+static void
+clutter_model_emit_row_added (ClutterModel     *model,
+                              ClutterModelIter *iter)
+{
+  clutter_model_refilter_row (model, iter);
+
+  if (model->priv->rows_freeze_count > 0)
+    {
+      clutter_model_add_changed_row (model, clutter_model_iter_get_row (iter));
+      return;
+    }
+
+  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+}
+
+/**
+ * clutter_model_freeze_rows:
+ * @model: a #ClutterModel
+ *
+ * Freezes the row signals of @model, to add or change many rows at
+ * once.
+ *
+ * While the rows are frozen, the #ClutterModel::row-added and
+ * #ClutterModel::row-changed signals are not emitted, and a sorted
+ * @model is not resorted after each change; when the rows are thawed
+ * using clutter_model_thaw_rows(), the @model is sorted once and a
+ * single #ClutterModel::rows-changed signal is emitted.
+ *
+ * The #ClutterModel::row-removed signal is still emitted while the
+ * rows are frozen.
+ *
+ * This function can be called multiple times; each call must be
+ * matched by a call to clutter_model_thaw_rows().
+ *
+ *
+ */
+void
+clutter_model_freeze_rows (ClutterModel *model)
+{
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+
+  model->priv->rows_freeze_count += 1;
+}
+
+/**
+ * clutter_model_thaw_rows:
+ * @model: a #ClutterModel
+ *
+ * Reverts the effect of a previous call to clutter_model_freeze_rows();
+ * once all the calls have been reverted, @model is resorted if needed
+ * and the #ClutterModel::rows-changed signal is emitted for the rows
+ * that were added or changed.
+ *
+ *
+ */
+void
+clutter_model_thaw_rows (ClutterModel *model)
+{
+  ClutterModelPrivate *priv;
+  guint first_row, n_rows;
+
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+
+  priv = model->priv;
+
+  g_return_if_fail (priv->rows_freeze_count > 0);
+
+  priv->rows_freeze_count -= 1;
+  if (priv->rows_freeze_count > 0)
+    return;
+
+  if (priv->rows_need_resort)
+    {
+      priv->rows_need_resort = FALSE;
+
+      clutter_model_resort (model);
+
+      if (priv->first_changed_row >= 0)
+        priv->first_changed_row = 0;
+    }
+
+  if (priv->first_changed_row < 0)
+    return;
+
+  n_rows = clutter_model_get_n_rows (model);
+  first_row = MIN (priv->first_changed_row, n_rows);
+
+  priv->first_changed_row = -1;
+
+  g_signal_emit (model, model_signals[ROWS_CHANGED], 0,
+                 first_row,
+                 n_rows - first_row);
+}
+
 /**
  * clutter_model_filter_row:
  * @model: a #ClutterModel
@@ -1025,6 +1209,56 @@ clutter_model_get_n_columns (ClutterModel *model)
   return CLUTTER_MODEL_GET_CLASS (model)->get_n_columns (model);
 }
 
+/* forward declaration */
+static inline void clutter_model_iter_set_value_internal (ClutterModelIter *iter,
+                                                          guint             column,
+                                                          const GValue     *value);
+
+/*< private >
+ * clutter_model_insert_row_values:
+ * @model: a #ClutterModel
+ * @index_: the position of the new row, or -1 to append it
+ * @n_columns: the number of columns and values
+ * @columns: a vector with the columns to set
+ * @values: a vector with the values
+ *
+ * Inserts a new row in @model, sets its values and moves it to
+ * its sorted position, if needed, before announcing it.
+ */
+static void
+clutter_model_insert_row_values (ClutterModel *model,
+                                 gint          index_,
+                                 guint         n_columns,
+                                 guint        *columns,
+                                 GValue       *values)
+{
+  ClutterModelPrivate *priv = model->priv;
+  ClutterModelIter *iter;
+  gboolean resort = FALSE;
+  gint i;
+
+  iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, index_);
+  g_assert (CLUTTER_IS_MODEL_ITER (iter));
+
+  /* the row is not announced yet, so we do not emit ::row-changed
+   * for each column
+   */
+  for (i = 0; i < n_columns; i++)
+    {
+      if (priv->sort_column == columns[i])
+        resort = TRUE;
+
+      clutter_model_iter_set_value_internal (iter, columns[i], &values[i]);
+    }
+
+  if (resort)
+    clutter_model_resort_row (model, iter);
+
+  clutter_model_emit_row_added (model, iter);
+
+  g_object_unref (iter);
+}
+
 /**
  * clutter_model_appendv:
  * @model: a #ClutterModel
@@ -1035,6 +1269,12 @@ clutter_model_get_n_columns (ClutterModel *model)
  * Creates and appends a new row to the #ClutterModel, setting the row
  * values for the given @columns upon creation.
  *
+ * The #ClutterModel::row-added signal is emitted once all the values
+ * are set, after the new row was moved to its sorted position if one
+ * of @columns is the sorting column of @model; like the variadic
+ * version of this function, no #ClutterModel::row-changed signal is
+ * emitted for the values of the new row anymore.
+ *
  *
  */
 void
@@ -1043,35 +1283,12 @@ clutter_model_appendv (ClutterModel *model,
                        guint        *columns,
                        GValue       *values)
 {
-  ClutterModelPrivate *priv;
-  ClutterModelIter *iter;
-  gint i;
-  gboolean resort = FALSE;
-
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   g_return_if_fail (n_columns <= clutter_model_get_n_columns (model));
   g_return_if_fail (columns != NULL);
   g_return_if_fail (values != NULL);
 
-  priv = model->priv;
-
-  iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, -1);
-  g_assert (CLUTTER_IS_MODEL_ITER (iter));
-
-  for (i = 0; i < n_columns; i++)
-    {
-      if (priv->sort_column == columns[i])
-        resort = TRUE;
-
-      clutter_model_iter_set_value (iter, columns[i], &values[i]);
-    }
-
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
-
-  if (resort)
-    clutter_model_resort (model);
-
-  g_object_unref (iter);
+  clutter_model_insert_row_values (model, -1, n_columns, columns, values);
 }
 
 /* forward declaration */
@@ -1114,7 +1331,7 @@ clutter_model_append (ClutterModel *model,
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1129,6 +1346,12 @@ clutter_model_append (ClutterModel *model,
  * Creates and prepends a new row to the #ClutterModel, setting the row
  * values for the given @columns upon creation.
  *
+ * The #ClutterModel::row-added signal is emitted once all the values
+ * are set, after the new row was moved to its sorted position if one
+ * of @columns is the sorting column of @model; like the variadic
+ * version of this function, no #ClutterModel::row-changed signal is
+ * emitted for the values of the new row anymore.
+ *
  *
  */
 void
@@ -1137,35 +1360,12 @@ clutter_model_prependv (ClutterModel *model,
                         guint        *columns,
                         GValue       *values)
 {
-  ClutterModelPrivate *priv;
-  ClutterModelIter *iter;
-  gint i;
-  gboolean resort = FALSE;
-
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   g_return_if_fail (n_columns <= clutter_model_get_n_columns (model));
   g_return_if_fail (columns != NULL);
   g_return_if_fail (values != NULL);
 
-  priv = model->priv;
-
-  iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, 0);
-  g_assert (CLUTTER_IS_MODEL_ITER (iter));
-
-  for (i = 0; i < n_columns; i++)
-    {
-      if (priv->sort_column == columns[i])
-        resort = TRUE;
-
-      clutter_model_iter_set_value (iter, columns[i], &values[i]);
-    }
-
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
-
-  if (resort)
-    clutter_model_resort (model);
-
-  g_object_unref (iter);
+  clutter_model_insert_row_values (model, 0, n_columns, columns, values);
 }
 
 /**
@@ -1203,7 +1403,7 @@ clutter_model_prepend (ClutterModel *model,
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1243,14 +1443,14 @@ clutter_model_insert (ClutterModel *model,
   iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, row);
   g_assert (CLUTTER_IS_MODEL_ITER (iter));
 
-  /* set_valist() will call clutter_model_resort() if one of the
-   * passed columns matches the model sorting column index
+  /* set_valist() will move the row to its sorted position if one of
+   * the passed columns matches the model sorting column index
    */
   va_start (args, row);
   clutter_model_iter_set_internal_valist (iter, args);
   va_end (args);
 
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+  clutter_model_emit_row_added (model, iter);
 
   g_object_unref (iter);
 }
@@ -1266,6 +1466,12 @@ clutter_model_insert (ClutterModel *model,
  * Inserts data at @row into the #ClutterModel, setting the row
  * values for the given @columns upon creation.
  *
+ * The #ClutterModel::row-added signal is emitted once all the values
+ * are set, after the new row was moved to its sorted position if one
+ * of @columns is the sorting column of @model; like the variadic
+ * version of this function, no #ClutterModel::row-changed signal is
+ * emitted for the values of the new row anymore.
+ *
  *
  */
 void
@@ -1275,35 +1481,12 @@ clutter_model_insertv (ClutterModel *model,
                        guint        *columns,
                        GValue       *values)
 {
-  ClutterModelPrivate *priv;
-  ClutterModelIter *iter;
-  gint i;
-  gboolean resort = FALSE;
-
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   g_return_if_fail (n_columns <= clutter_model_get_n_columns (model));
   g_return_if_fail (columns != NULL);
   g_return_if_fail (values != NULL);
 
-  priv = model->priv;
-
-  iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, row);
-  g_assert (CLUTTER_IS_MODEL_ITER (iter));
-
-  for (i = 0; i < n_columns; i++)
-    {
-      if (priv->sort_column == columns[i])
-        resort = TRUE;
-
-      clutter_model_iter_set_value (iter, columns[i], &values[i]);
-    }
-
-  g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
-
-  if (resort)
-    clutter_model_resort (model);
-
-  g_object_unref (iter);
+  clutter_model_insert_row_values (model, row, n_columns, columns, values);
 }
 
 /**
@@ -1344,13 +1527,22 @@ clutter_model_insert_value (ClutterModel *model,
 
   g_assert (CLUTTER_IS_MODEL_ITER (iter));
 
-  clutter_model_iter_set_value (iter, column, value);
-
   if (added)
-    g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
+    {
+      clutter_model_iter_set_value_internal (iter, column, value);
 
-  if (priv->sort_column == column)
-    clutter_model_resort (model);
+      if (priv->sort_column == column)
+        clutter_model_resort_row (model, iter);
+
+      clutter_model_emit_row_added (model, iter);
+    }
+  else
+    {
+      clutter_model_iter_set_value (iter, column, value);
+
+      if (priv->sort_column == column)
+        clutter_model_resort_row (model, iter);
+    }
 
   g_object_unref (iter);
 }
@@ -1375,6 +1567,10 @@ clutter_model_remove (ClutterModel *model,
   klass = CLUTTER_MODEL_GET_CLASS (model);
   if (klass->remove_row)
     klass->remove_row (model, row);
+
+  /* the rows after the removed one have been shifted */
+  if (model->priv->first_changed_row > (gint) row)
+    model->priv->first_changed_row -= 1;
 }
 
 /**
@@ -1689,6 +1885,13 @@ clutter_model_set_sort (ClutterModel         *model,
  *
  * Filters the @model using the given filtering function.
  *
+ * Models implementing the refilter virtual functions, like
+ * #ClutterListModel, run @func once for each row when the filter is
+ * set, and then only for the rows whose values change, caching its
+ * result for each row. A filter that depends on state outside of the
+ * model goes stale when that state changes: call this function again,
+ * with the same @func, to filter all the rows again.
+ *
  *
  */
 void
@@ -1698,6 +1901,7 @@ clutter_model_set_filter (ClutterModel           *model,
                           GDestroyNotify          notify)
 {
   ClutterModelPrivate *priv;
+  ClutterModelClass *klass;
     
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   priv = model->priv;
@@ -1709,6 +1913,11 @@ clutter_model_set_filter (ClutterModel           *model,
   priv->filter_data = user_data;
   priv->filter_notify = notify;
 
+  /* the handlers of ::filter-changed must see the new filter */
+  klass = CLUTTER_MODEL_GET_CLASS (model);
+  if (klass->refilter)
+    klass->refilter (model);
+
   g_signal_emit (model, model_signals[FILTER_CHANGED], 0);
   g_object_notify (G_OBJECT (model), "filter-set");
 }
@@ -2041,7 +2250,7 @@ clutter_model_iter_set_internal_valist (ClutterModelIter *iter,
     }
 
   if (sort)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 }
 
 static void inline
@@ -2052,6 +2261,14 @@ clutter_model_iter_emit_row_changed (ClutterModelIter *iter)
 
   g_assert (CLUTTER_IS_MODEL (model));
 
+  clutter_model_refilter_row (model, iter);
+
+  if (model->priv->rows_freeze_count > 0)
+    {
+      clutter_model_add_changed_row (model, clutter_model_iter_get_row (iter));
+      return;
+    }
+
   g_signal_emit (model, model_signals[ROW_CHANGED], 0, iter);
 }
 
@@ -138,6 +138,16 @@ struct _ClutterModel
  *   and returning an iterator pointing to it; if the index is a negative
  *   integer, the row should be appended to the model
  * @remove_row: virtual function for removing a row at the given index
+ * @resort_row: virtual function for moving the row pointed by the passed
+ *   iterator to its position in the sorted model, after its value in the
+ *   sorting column changed; the rest of the model is already sorted. If
+ *   not implemented, the whole model is resorted
+ * @refilter: virtual function for checking again which rows of the
+ *   model are filtered out, after the filter changed
+ * @refilter_row: virtual function for checking again whether the row
+ *   pointed by the passed iterator is filtered out, after its values
+ *   changed. Implementing @refilter and @refilter_row is optional, and
+ *   allows caching the result of the filter for each row
  *
  * Class for #ClutterModel instances.
  *
@@ -176,11 +186,16 @@ struct _ClutterModelClass
   void              (* sort_changed)    (ClutterModel     *model);
   void              (* filter_changed)  (ClutterModel     *model);
 
+  void              (* resort_row)      (ClutterModel         *model,
+                                         ClutterModelIter     *iter,
+                                         ClutterModelSortFunc  func,
+                                         gpointer              data);
+  void              (* refilter)        (ClutterModel         *model);
+  void              (* refilter_row)    (ClutterModel         *model,
+                                         ClutterModelIter     *iter);
+
   /*< private >*/
   /* padding for future expansion */
-  void (*_clutter_model_1) (void);
-  void (*_clutter_model_2) (void);
-  void (*_clutter_model_3) (void);
   void (*_clutter_model_4) (void);
   void (*_clutter_model_5) (void);
   void (*_clutter_model_6) (void);
@@ -224,6 +239,9 @@ void                  clutter_model_insert_value       (ClutterModel     *model,
 void                  clutter_model_remove             (ClutterModel     *model,
                                                         guint             row);
 
+void                  clutter_model_freeze_rows        (ClutterModel     *model);
+void                  clutter_model_thaw_rows          (ClutterModel     *model);
+
 guint                 clutter_model_get_n_rows         (ClutterModel     *model);
 guint                 clutter_model_get_n_columns      (ClutterModel     *model);
 const gchar *         clutter_model_get_column_name    (ClutterModel     *model,
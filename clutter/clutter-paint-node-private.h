@@ -115,6 +115,8 @@ ClutterPaintNode *      _clutter_dummy_node_new                         (Clutter
 void                    _clutter_paint_node_paint                       (ClutterPaintNode            *root);
 void                    _clutter_paint_node_dump_tree                   (ClutterPaintNode            *root);
 
+ClutterPaintNode *      _clutter_pipeline_node_paint_siblings           (ClutterPaintNode            *node);
+
 G_GNUC_INTERNAL
 void                    clutter_paint_node_remove_child                 (ClutterPaintNode      *node,
                                                                          ClutterPaintNode      *child);
@@ -965,11 +965,23 @@ _clutter_paint_node_paint (ClutterPaintNode *node)
       klass->draw (node);
     }
 
-  for (iter = node->first_child;
-       iter != NULL;
-       iter = iter->next_sibling)
+  iter = node->first_child;
+  while (iter != NULL)
     {
+      ClutterPaintNode *next;
+
+      /* consecutive pipeline nodes sharing the same pipeline are
+       * painted together */
+      next = _clutter_pipeline_node_paint_siblings (iter);
+      if (next != iter)
+        {
+          iter = next;
+          continue;
+        }
+
       _clutter_paint_node_paint (iter);
+
+      iter = iter->next_sibling;
     }
 
   if (res)
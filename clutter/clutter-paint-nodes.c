@@ -39,6 +39,8 @@
 
 #include "clutter-paint-node-private.h"
 
+#include <string.h>
+
 #include <pango/pango.h>
 #include <cogl/cogl.h>
 
@@ -380,6 +382,52 @@ clutter_pipeline_node_pre_draw (ClutterPaintNode *node)
   return FALSE;
 }
 
+#define N_STACK_RECTANGLES     16
+
+/* copies @n_rects consecutive PAINT_OP_TEX_RECT operations of @node,
+ * starting at @first, into @verts
+ */
+static void
+clutter_pipeline_node_copy_rectangles (ClutterPaintNode *node,
+                                       guint             first,
+                                       guint             n_rects,
+                                       float            *verts)
+{
+  guint i;
+
+  for (i = 0; i < n_rects; i++)
+    {
+      const ClutterPaintOperation *op;
+
+      op = &g_array_index (node->operations, ClutterPaintOperation, first + i);
+      memcpy (verts + (i * 8), op->op.texrect, sizeof (float) * 8);
+    }
+}
+
+/* submits @n_rects consecutive PAINT_OP_TEX_RECT operations, starting
+ * at @first, using a single call
+ */
+static void
+clutter_pipeline_node_draw_rectangles (ClutterPaintNode *node,
+                                       guint             first,
+                                       guint             n_rects)
+{
+  float stack_verts[N_STACK_RECTANGLES * 8];
+  float *verts;
+
+  if (n_rects > N_STACK_RECTANGLES)
+    verts = g_new (float, n_rects * 8);
+  else
+    verts = stack_verts;
+
+  clutter_pipeline_node_copy_rectangles (node, first, n_rects, verts);
+
+  cogl_rectangles_with_texture_coords (verts, n_rects);
+
+  if (verts != stack_verts)
+    g_free (verts);
+}
+
 static void
 clutter_pipeline_node_draw (ClutterPaintNode *node)
 {
@@ -395,6 +443,7 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
   for (i = 0; i < node->operations->len; i++)
     {
       const ClutterPaintOperation *op;
+      guint n_rects;
 
       op = &g_array_index (node->operations, ClutterPaintOperation, i);
 
@@ -404,14 +453,27 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
           break;
 
         case PAINT_OP_TEX_RECT:
-          cogl_rectangle_with_texture_coords (op->op.texrect[0],
-                                              op->op.texrect[1],
-                                              op->op.texrect[2],
-                                              op->op.texrect[3],
-                                              op->op.texrect[4],
-                                              op->op.texrect[5],
-                                              op->op.texrect[6],
-                                              op->op.texrect[7]);
+          n_rects = 1;
+          while (i + n_rects < node->operations->len &&
+                 g_array_index (node->operations,
+                                ClutterPaintOperation,
+                                i + n_rects).opcode == PAINT_OP_TEX_RECT)
+            n_rects += 1;
+
+          if (n_rects > 1)
+            {
+              clutter_pipeline_node_draw_rectangles (node, i, n_rects);
+              i += n_rects - 1;
+            }
+          else
+            cogl_rectangle_with_texture_coords (op->op.texrect[0],
+                                                op->op.texrect[1],
+                                                op->op.texrect[2],
+                                                op->op.texrect[3],
+                                                op->op.texrect[4],
+                                                op->op.texrect[5],
+                                                op->op.texrect[6],
+                                                op->op.texrect[7]);
           break;
 
         case PAINT_OP_PATH:
@@ -436,6 +498,105 @@ clutter_pipeline_node_post_draw (ClutterPaintNode *node)
   cogl_pop_source ();
 }
 
+/* checks whether @node is a pipeline node that only draws texture
+ * rectangles, and that can be drawn together with its siblings
+ */
+static gboolean
+clutter_pipeline_node_can_batch (ClutterPaintNode *node)
+{
+  ClutterPaintNodeClass *klass = CLUTTER_PAINT_NODE_GET_CLASS (node);
+  guint i;
+
+  if (!CLUTTER_IS_PIPELINE_NODE (node) ||
+      CLUTTER_PIPELINE_NODE (node)->pipeline == NULL)
+    return FALSE;
+
+  /* the subclasses only differ in the way they create the pipeline */
+  if (klass->pre_draw != clutter_pipeline_node_pre_draw ||
+      klass->draw != clutter_pipeline_node_draw ||
+      klass->post_draw != clutter_pipeline_node_post_draw)
+    return FALSE;
+
+  if (node->first_child != NULL || node->operations == NULL)
+    return FALSE;
+
+  for (i = 0; i < node->operations->len; i++)
+    {
+      const ClutterPaintOperation *op;
+
+      op = &g_array_index (node->operations, ClutterPaintOperation, i);
+      if (op->opcode != PAINT_OP_TEX_RECT)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_pipeline_node_paint_siblings:
+ * @node: a #ClutterPaintNode
+ *
+ * Paints @node together with the following siblings using the same
+ * #CoglPipeline, if all of them only draw texture rectangles, so that
+ * the rectangles are submitted with a single call, and the pipeline
+ * is only pushed once.
+ *
+ * Return value: the first sibling that was not painted, or @node if
+ *   it cannot be painted together with its siblings
+ */
+ClutterPaintNode *
+_clutter_pipeline_node_paint_siblings (ClutterPaintNode *node)
+{
+  float stack_verts[N_STACK_RECTANGLES * 8];
+  ClutterPaintNode *iter, *last;
+  CoglPipeline *pipeline;
+  float *verts;
+  guint n_rects;
+
+  if (!clutter_pipeline_node_can_batch (node))
+    return node;
+
+  pipeline = CLUTTER_PIPELINE_NODE (node)->pipeline;
+  n_rects = node->operations->len;
+
+  for (last = node; last->next_sibling != NULL; last = last->next_sibling)
+    {
+      iter = last->next_sibling;
+
+      if (!clutter_pipeline_node_can_batch (iter) ||
+          CLUTTER_PIPELINE_NODE (iter)->pipeline != pipeline)
+        break;
+
+      n_rects += iter->operations->len;
+    }
+
+  if (last == node)
+    return node;
+
+  if (n_rects > N_STACK_RECTANGLES)
+    verts = g_new (float, n_rects * 8);
+  else
+    verts = stack_verts;
+
+  n_rects = 0;
+  for (iter = node; iter != last->next_sibling; iter = iter->next_sibling)
+    {
+      clutter_pipeline_node_copy_rectangles (iter, 0,
+                                             iter->operations->len,
+                                             verts + (n_rects * 8));
+      n_rects += iter->operations->len;
+    }
+
+  cogl_push_source (pipeline);
+  cogl_rectangles_with_texture_coords (verts, n_rects);
+  cogl_pop_source ();
+
+  if (verts != stack_verts)
+    g_free (verts);
+
+  return last->next_sibling;
+}
+
 static JsonNode *
 clutter_pipeline_node_serialize (ClutterPaintNode *node)
 {
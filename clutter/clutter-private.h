@@ -229,6 +229,8 @@ ClutterActor *  _clutter_get_actor_by_id        (ClutterStage *stage,
                                                  guint32       actor_id);
 
 gboolean        _clutter_get_sync_to_vblank     (void);
+guint           _clutter_get_max_redraw_rects   (void);
+gsize           _clutter_get_text_layout_cache_size (void);
 
 /* use this function as the accumulator if you have a signal with
  * a G_TYPE_BOOLEAN return value; this will stop the emission as
@@ -305,6 +307,11 @@ gboolean        _clutter_util_matrix_decompose  (const ClutterMatrix *src,
                                                  ClutterVertex       *translate_p,
                                                  ClutterVertex4      *perspective_p);
 
+void            _clutter_util_matrix_interpolate (const ClutterMatrix *matrix1,
+                                                  const ClutterMatrix *matrix2,
+                                                  gdouble              progress,
+                                                  ClutterMatrix       *res);
+
 typedef struct _ClutterPlane
 {
   float v0[3];
@@ -320,6 +327,7 @@ typedef enum _ClutterCullResult
 } ClutterCullResult;
 
 gboolean        _clutter_has_progress_function  (GType gtype);
+gboolean        _clutter_has_custom_progress_functions (void);
 gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *initial,
                                                  const GValue *final,
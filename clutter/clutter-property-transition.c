@@ -36,6 +36,7 @@
 
 #include "clutter-property-transition.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
@@ -146,6 +147,15 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
+  /* the animatable properties of ClutterActor have a fast path that
+   * does not need a GValue round-trip */
+  if (CLUTTER_IS_ACTOR (animatable) &&
+      _clutter_actor_compute_transition_value (CLUTTER_ACTOR (animatable),
+                                               priv->pspec,
+                                               interval,
+                                               progress))
+    return;
+
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
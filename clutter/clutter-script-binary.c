@@ -0,0 +1,719 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Compiled ClutterScript UI definitions.
+ *
+ * The compiled data starts with COMPILED_MAGIC, followed by a little
+ * endian serialized GVariant of type COMPILED_TYPE_STRING, holding the
+ * version of the format and an array with one entry per ObjectInfo:
+ *
+ *   (id, class name, flags, type function, properties, children, signals)
+ *
+ * The values of the properties are stored as GVariants mirroring the
+ * JSON nodes: null is "()", booleans are "b", integers are "x", doubles
+ * are "d", strings are "s", arrays are "av" and objects are "a{sv}".
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "clutter-color.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-script.h"
+#include "clutter-script-private.h"
+
+/* includes the trailing NUL, which cannot appear in JSON data */
+#define COMPILED_MAGIC          "CSCRIPT"
+#define COMPILED_MAGIC_LEN      8
+
+#define COMPILED_VERSION        1
+
+#define COMPILED_OBJECT_TYPE_STRING     "(ssusa(sv)asa(sssu))"
+#define COMPILED_TYPE_STRING            "(ua" COMPILED_OBJECT_TYPE_STRING ")"
+
+enum
+{
+  COMPILED_FLAG_FAKE_ID       = 1 << 0,
+  COMPILED_FLAG_STAGE_DEFAULT = 1 << 1
+};
+
+static GVariant *
+variant_from_json_node (JsonNode *node)
+{
+  GVariantBuilder builder;
+
+  switch (JSON_NODE_TYPE (node))
+    {
+    case JSON_NODE_OBJECT:
+      {
+        JsonObject *object = json_node_get_object (node);
+        GList *members, *l;
+
+        g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
+        members = json_object_get_members (object);
+        for (l = members; l != NULL; l = l->next)
+          {
+            JsonNode *member = json_object_get_member (object, l->data);
+
+            g_variant_builder_add (&builder, "{sv}",
+                                   l->data,
+                                   variant_from_json_node (member));
+          }
+
+        g_list_free (members);
+
+        return g_variant_builder_end (&builder);
+      }
+
+    case JSON_NODE_ARRAY:
+      {
+        JsonArray *array = json_node_get_array (node);
+        guint i, array_len = json_array_get_length (array);
+
+        g_variant_builder_init (&builder, G_VARIANT_TYPE ("av"));
+
+        for (i = 0; i < array_len; i++)
+          {
+            JsonNode *element = json_array_get_element (array, i);
+
+            g_variant_builder_add (&builder, "v",
+                                   variant_from_json_node (element));
+          }
+
+        return g_variant_builder_end (&builder);
+      }
+
+    case JSON_NODE_VALUE:
+      switch (json_node_get_value_type (node))
+        {
+        case G_TYPE_INT64:
+          return g_variant_new_int64 (json_node_get_int (node));
+
+        case G_TYPE_DOUBLE:
+          return g_variant_new_double (json_node_get_double (node));
+
+        case G_TYPE_BOOLEAN:
+          return g_variant_new_boolean (json_node_get_boolean (node));
+
+        case G_TYPE_STRING:
+          return g_variant_new_string (json_node_get_string (node));
+
+        default:
+          break;
+        }
+      break;
+
+    case JSON_NODE_NULL:
+      break;
+    }
+
+  return g_variant_new_tuple (NULL, 0);
+}
+
+static const gchar *
+remap_id (GHashTable  *fake_ids,
+          const gchar *id_)
+{
+  const gchar *new_id = g_hash_table_lookup (fake_ids, id_);
+
+  return new_id != NULL ? new_id : id_;
+}
+
+static JsonNode *
+json_node_from_variant (GVariant   *variant,
+                        GHashTable *fake_ids)
+{
+  JsonNode *node;
+
+  if (g_variant_is_of_type (variant, G_VARIANT_TYPE_INT64))
+    {
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, g_variant_get_int64 (variant));
+    }
+  else if (g_variant_is_of_type (variant, G_VARIANT_TYPE_DOUBLE))
+    {
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_double (node, g_variant_get_double (variant));
+    }
+  else if (g_variant_is_of_type (variant, G_VARIANT_TYPE_BOOLEAN))
+    {
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_boolean (node, g_variant_get_boolean (variant));
+    }
+  else if (g_variant_is_of_type (variant, G_VARIANT_TYPE_STRING))
+    {
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_string (node, g_variant_get_string (variant, NULL));
+    }
+  else if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("av")))
+    {
+      JsonArray *array;
+      GVariantIter iter;
+      GVariant *element;
+
+      array = json_array_sized_new (g_variant_n_children (variant));
+
+      g_variant_iter_init (&iter, variant);
+      while (g_variant_iter_next (&iter, "v", &element))
+        {
+          json_array_add_element (array,
+                                  json_node_from_variant (element, fake_ids));
+          g_variant_unref (element);
+        }
+
+      node = json_node_new (JSON_NODE_ARRAY);
+      json_node_take_array (node, array);
+    }
+  else if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("a{sv}")))
+    {
+      JsonObject *object;
+      GVariantIter iter;
+      const gchar *name;
+      GVariant *value;
+
+      object = json_object_new ();
+
+      g_variant_iter_init (&iter, variant);
+      while (g_variant_iter_next (&iter, "{&sv}", &name, &value))
+        {
+          /* the nested object definitions are referenced by id */
+          if (strcmp (name, "id") == 0 &&
+              g_variant_is_of_type (value, G_VARIANT_TYPE_STRING))
+            {
+              const gchar *id_ = g_variant_get_string (value, NULL);
+
+              json_object_set_string_member (object, name,
+                                             remap_id (fake_ids, id_));
+            }
+          else
+            json_object_set_member (object, name,
+                                    json_node_from_variant (value, fake_ids));
+
+          g_variant_unref (value);
+        }
+
+      node = json_node_new (JSON_NODE_OBJECT);
+      json_node_take_object (node, object);
+    }
+  else
+    node = json_node_new (JSON_NODE_NULL);
+
+  return node;
+}
+
+/* converts the string values that would otherwise be parsed each time
+ * the compiled data is loaded; returns NULL if the value of @node has
+ * to be stored unchanged
+ */
+static JsonNode *
+compile_property_value (GParamSpec *pspec,
+                        JsonNode   *node)
+{
+  GType value_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
+  JsonNode *retval;
+  const gchar *str;
+
+  if (JSON_NODE_TYPE (node) != JSON_NODE_VALUE ||
+      json_node_get_value_type (node) != G_TYPE_STRING)
+    return NULL;
+
+  str = json_node_get_string (node);
+
+  if (G_TYPE_FUNDAMENTAL (value_type) == G_TYPE_ENUM)
+    {
+      gint enum_value;
+
+      if (!_clutter_script_enum_from_string (value_type, str, &enum_value))
+        return NULL;
+
+      retval = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (retval, enum_value);
+
+      return retval;
+    }
+
+  if (G_TYPE_FUNDAMENTAL (value_type) == G_TYPE_FLAGS)
+    {
+      gint flags_value;
+
+      if (!_clutter_script_flags_from_string (value_type, str, &flags_value))
+        return NULL;
+
+      retval = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (retval, flags_value);
+
+      return retval;
+    }
+
+  if (value_type == CLUTTER_TYPE_COLOR)
+    {
+      ClutterColor color;
+      JsonObject *object;
+
+      if (!clutter_color_from_string (&color, str))
+        return NULL;
+
+      object = json_object_new ();
+      json_object_set_int_member (object, "red", color.red);
+      json_object_set_int_member (object, "green", color.green);
+      json_object_set_int_member (object, "blue", color.blue);
+      json_object_set_int_member (object, "alpha", color.alpha);
+
+      retval = json_node_new (JSON_NODE_OBJECT);
+      json_node_take_object (retval, object);
+
+      return retval;
+    }
+
+  return NULL;
+}
+
+static GVariant *
+compile_object_info (ClutterScript *script,
+                     ObjectInfo    *oinfo)
+{
+  GVariantBuilder properties, children, signals;
+  GObjectClass *klass = NULL;
+  gchar *type_func = NULL;
+  guint flags = 0;
+  GVariant *retval;
+  GType gtype;
+  GList *l;
+
+  if (oinfo->type_func != NULL)
+    {
+      type_func = g_strdup (oinfo->type_func);
+      gtype = _clutter_script_get_type_from_symbol (type_func);
+    }
+  else
+    {
+      gtype = clutter_script_get_type_from_name (script, oinfo->class_name);
+
+      /* store the type function, if it follows the naming policy, so
+       * that loading the compiled data does not need to build it
+       */
+      if (gtype != G_TYPE_INVALID)
+        {
+          type_func = _clutter_script_get_type_symbol (oinfo->class_name);
+
+          if (_clutter_script_get_type_from_symbol (type_func) != gtype)
+            {
+              g_free (type_func);
+              type_func = NULL;
+            }
+        }
+    }
+
+  if (gtype == G_TYPE_INVALID)
+    CLUTTER_NOTE (SCRIPT, "Unable to resolve the type '%s' of object '%s'; "
+                  "its properties will be stored unchanged",
+                  oinfo->class_name,
+                  oinfo->id);
+  else if (g_type_is_a (gtype, G_TYPE_OBJECT))
+    klass = g_type_class_ref (gtype);
+
+  g_variant_builder_init (&properties, G_VARIANT_TYPE ("a(sv)"));
+
+  for (l = oinfo->properties; l != NULL; l = l->next)
+    {
+      PropertyInfo *pinfo = l->data;
+      JsonNode *compiled = NULL;
+
+      if (klass != NULL && !pinfo->is_child && !pinfo->is_layout)
+        {
+          GParamSpec *pspec;
+
+          pspec = g_object_class_find_property (klass, pinfo->name);
+          if (pspec != NULL)
+            compiled = compile_property_value (pspec, pinfo->node);
+        }
+
+      if (compiled != NULL)
+        {
+          g_variant_builder_add (&properties, "(sv)",
+                                 pinfo->name,
+                                 variant_from_json_node (compiled));
+          json_node_free (compiled);
+        }
+      else
+        g_variant_builder_add (&properties, "(sv)",
+                               pinfo->name,
+                               variant_from_json_node (pinfo->node));
+    }
+
+  g_variant_builder_init (&children, G_VARIANT_TYPE ("as"));
+
+  for (l = oinfo->children; l != NULL; l = l->next)
+    g_variant_builder_add (&children, "s", l->data);
+
+  g_variant_builder_init (&signals, G_VARIANT_TYPE ("a(sssu)"));
+
+  for (l = oinfo->signals; l != NULL; l = l->next)
+    {
+      SignalInfo *sinfo = l->data;
+
+      if (!sinfo->is_handler)
+        continue;
+
+      g_variant_builder_add (&signals, "(sssu)",
+                             sinfo->name,
+                             sinfo->handler,
+                             sinfo->object != NULL ? sinfo->object : "",
+                             (guint) sinfo->flags);
+    }
+
+  if (oinfo->has_fake_id)
+    flags |= COMPILED_FLAG_FAKE_ID;
+
+  if (oinfo->is_stage_default)
+    flags |= COMPILED_FLAG_STAGE_DEFAULT;
+
+  retval = g_variant_new (COMPILED_OBJECT_TYPE_STRING,
+                          oinfo->id,
+                          oinfo->class_name,
+                          flags,
+                          type_func != NULL ? type_func : "",
+                          &properties,
+                          &children,
+                          &signals);
+
+  if (klass != NULL)
+    g_type_class_unref (klass);
+
+  g_free (type_func);
+
+  return retval;
+}
+
+static gint
+compare_object_info (gconstpointer a,
+                     gconstpointer b)
+{
+  const ObjectInfo *info_a = a;
+  const ObjectInfo *info_b = b;
+
+  return strcmp (info_a->id, info_b->id);
+}
+
+/*< private >
+ * _clutter_script_compile:
+ * @script: a #ClutterScript
+ *
+ * Serializes the object definitions loaded by @script.
+ *
+ * The definitions are sorted by id, so that compiling the same
+ * UI definition twice yields the same data.
+ *
+ * Return value: (transfer full): the compiled definitions
+ */
+GBytes *
+_clutter_script_compile (ClutterScript *script)
+{
+  GVariantBuilder objects;
+  GVariant *compiled;
+  GList *infos, *l;
+  guint8 *data;
+  gsize size;
+
+  g_variant_builder_init (&objects,
+                          G_VARIANT_TYPE ("a" COMPILED_OBJECT_TYPE_STRING));
+
+  infos = _clutter_script_list_object_infos (script);
+  infos = g_list_sort (infos, compare_object_info);
+
+  for (l = infos; l != NULL; l = l->next)
+    g_variant_builder_add_value (&objects,
+                                 compile_object_info (script, l->data));
+
+  g_list_free (infos);
+
+  compiled = g_variant_new (COMPILED_TYPE_STRING, COMPILED_VERSION, &objects);
+  g_variant_ref_sink (compiled);
+
+  if (G_BYTE_ORDER == G_BIG_ENDIAN)
+    {
+      GVariant *swapped = g_variant_byteswap (compiled);
+
+      g_variant_unref (compiled);
+      compiled = swapped;
+    }
+
+  size = g_variant_get_size (compiled);
+
+  data = g_malloc (COMPILED_MAGIC_LEN + size);
+  memcpy (data, COMPILED_MAGIC, COMPILED_MAGIC_LEN);
+  g_variant_store (compiled, data + COMPILED_MAGIC_LEN);
+
+  g_variant_unref (compiled);
+
+  return g_bytes_new_take (data, COMPILED_MAGIC_LEN + size);
+}
+
+/*< private >
+ * _clutter_script_is_compiled_data:
+ * @data: a buffer
+ * @length: the length of the buffer
+ *
+ * Checks whether @data contains compiled UI definitions.
+ *
+ * Return value: %TRUE if @data should be loaded using
+ *   _clutter_script_load_compiled_data()
+ */
+gboolean
+_clutter_script_is_compiled_data (const gchar *data,
+                                  gsize        length)
+{
+  return length >= COMPILED_MAGIC_LEN &&
+         memcmp (data, COMPILED_MAGIC, COMPILED_MAGIC_LEN) == 0;
+}
+
+static void
+load_compiled_object (ClutterScript *script,
+                      GVariant      *record,
+                      GHashTable    *fake_ids)
+{
+  const gchar *id_, *class_name, *type_func;
+  GVariant *properties, *children, *signals;
+  ObjectInfo *oinfo;
+  GVariantIter iter;
+  const gchar *str;
+  guint flags;
+  gsize i;
+
+  g_variant_get (record, "(&s&su&s@a(sv)@as@a(sssu))",
+                 &id_,
+                 &class_name,
+                 &flags,
+                 &type_func,
+                 &properties,
+                 &children,
+                 &signals);
+
+  id_ = remap_id (fake_ids, id_);
+
+  oinfo = _clutter_script_get_object_info (script, id_);
+  if (oinfo == NULL)
+    {
+      oinfo = g_slice_new0 (ObjectInfo);
+      oinfo->merge_id = _clutter_script_get_last_merge_id (script);
+      oinfo->id = g_strdup (id_);
+      oinfo->class_name = g_strdup (class_name);
+      oinfo->has_fake_id = (flags & COMPILED_FLAG_FAKE_ID) != 0;
+
+      if (*type_func != '\0')
+        oinfo->type_func = g_strdup (type_func);
+    }
+
+  /* the lists are built in the same order as the ones created by the
+   * ClutterScriptParser for the original definition
+   */
+  for (i = g_variant_n_children (properties); i > 0; i--)
+    {
+      PropertyInfo *pinfo;
+      GVariant *value;
+
+      g_variant_get_child (properties, i - 1, "(&sv)", &str, &value);
+
+      pinfo = g_slice_new (PropertyInfo);
+      pinfo->name = g_strdup (str);
+      pinfo->node = json_node_from_variant (value, fake_ids);
+      pinfo->pspec = NULL;
+      pinfo->is_child = g_str_has_prefix (str, "child::") ? TRUE : FALSE;
+      pinfo->is_layout = g_str_has_prefix (str, "layout::") ? TRUE : FALSE;
+
+      oinfo->properties = g_list_prepend (oinfo->properties, pinfo);
+
+      g_variant_unref (value);
+    }
+
+  g_variant_iter_init (&iter, children);
+  while (g_variant_iter_next (&iter, "&s", &str))
+    oinfo->children = g_list_append (oinfo->children,
+                                     g_strdup (remap_id (fake_ids, str)));
+
+  for (i = g_variant_n_children (signals); i > 0; i--)
+    {
+      const gchar *name, *handler, *object;
+      SignalInfo *sinfo;
+      guint signal_flags;
+
+      g_variant_get_child (signals, i - 1, "(&s&s&su)",
+                           &name,
+                           &handler,
+                           &object,
+                           &signal_flags);
+
+      sinfo = g_slice_new0 (SignalInfo);
+      sinfo->is_handler = TRUE;
+      sinfo->name = g_strdup (name);
+      sinfo->handler = g_strdup (handler);
+      sinfo->object = *object != '\0' ? g_strdup (object) : NULL;
+      sinfo->flags = signal_flags;
+
+      oinfo->signals = g_list_prepend (oinfo->signals, sinfo);
+    }
+
+  oinfo->is_actor = FALSE;
+
+  if ((flags & COMPILED_FLAG_STAGE_DEFAULT) != 0)
+    {
+      oinfo->is_actor = TRUE;
+      oinfo->is_stage = TRUE;
+      oinfo->is_stage_default = TRUE;
+    }
+  else
+    oinfo->is_stage_default = FALSE;
+
+  oinfo->is_unmerged = FALSE;
+  oinfo->has_unresolved = TRUE;
+  oinfo->is_lazy = TRUE;
+
+  CLUTTER_NOTE (SCRIPT,
+                "Added compiled object '%s' (type:%s, id:%d, props:%d, signals:%d)",
+                oinfo->id,
+                oinfo->class_name,
+                oinfo->merge_id,
+                g_list_length (oinfo->properties),
+                g_list_length (oinfo->signals));
+
+  _clutter_script_add_object_info (script, oinfo);
+
+  g_variant_unref (properties);
+  g_variant_unref (children);
+  g_variant_unref (signals);
+}
+
+/*< private >
+ * _clutter_script_load_compiled_data:
+ * @script: a #ClutterScript
+ * @data: compiled UI definitions
+ * @length: the length of @data
+ * @error: return location for a #GError, or %NULL
+ *
+ * Adds the object definitions inside @data to @script, using the
+ * current merge id.
+ *
+ * Unlike the definitions parsed from JSON, the objects are not
+ * constructed until they are needed.
+ *
+ * Return value: %TRUE on success
+ */
+gboolean
+_clutter_script_load_compiled_data (ClutterScript  *script,
+                                    const gchar    *data,
+                                    gsize           length,
+                                    GError        **error)
+{
+  GVariant *compiled, *objects, *record;
+  GHashTable *fake_ids;
+  gpointer aligned_data = NULL;
+  GVariantIter iter;
+  guint version;
+
+  g_return_val_if_fail (_clutter_script_is_compiled_data (data, length), FALSE);
+
+  data += COMPILED_MAGIC_LEN;
+  length -= COMPILED_MAGIC_LEN;
+
+  /* GVariant needs the serialized data to be aligned */
+  if (((gsize) data & 7) != 0)
+    {
+      aligned_data = g_memdup (data, length);
+      data = aligned_data;
+    }
+
+  compiled = g_variant_new_from_data (G_VARIANT_TYPE (COMPILED_TYPE_STRING),
+                                      data, length,
+                                      FALSE,
+                                      NULL, NULL);
+  g_variant_ref_sink (compiled);
+
+  if (G_BYTE_ORDER == G_BIG_ENDIAN)
+    {
+      GVariant *swapped = g_variant_byteswap (compiled);
+
+      g_variant_unref (compiled);
+      compiled = swapped;
+    }
+
+  g_variant_get (compiled, "(u@a" COMPILED_OBJECT_TYPE_STRING ")",
+                 &version,
+                 &objects);
+
+  if (version != COMPILED_VERSION)
+    {
+      g_set_error (error, CLUTTER_SCRIPT_ERROR,
+                   CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+                   "Unsupported version %u of the compiled UI "
+                   "definitions; the definitions must be compiled "
+                   "again",
+                   version);
+
+      g_variant_unref (objects);
+      g_variant_unref (compiled);
+      g_free (aligned_data);
+
+      return FALSE;
+    }
+
+  /* the ids generated when compiling are replaced, so that they do not
+   * clash with the ones generated for other definitions
+   */
+  fake_ids = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+  g_variant_iter_init (&iter, objects);
+  while ((record = g_variant_iter_next_value (&iter)) != NULL)
+    {
+      const gchar *id_;
+      guint flags;
+
+      g_variant_get (record, "(&s&su&s@a(sv)@as@a(sssu))",
+                     &id_, NULL, &flags, NULL, NULL, NULL, NULL);
+
+      if ((flags & COMPILED_FLAG_FAKE_ID) != 0)
+        g_hash_table_insert (fake_ids,
+                             (gpointer) id_,
+                             _clutter_script_generate_fake_id (script));
+
+      g_variant_unref (record);
+    }
+
+  g_variant_iter_init (&iter, objects);
+  while ((record = g_variant_iter_next_value (&iter)) != NULL)
+    {
+      load_compiled_object (script, record, fake_ids);
+      g_variant_unref (record);
+    }
+
+  g_hash_table_unref (fake_ids);
+
+  g_variant_unref (objects);
+  g_variant_unref (compiled);
+  g_free (aligned_data);
+
+  return TRUE;
+}
@@ -0,0 +1,138 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * clutter-script-compiler: compiles ClutterScript UI definitions into
+ * the binary form loaded by ClutterScript, using
+ * clutter_script_compile_data().
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include <clutter/clutter.h>
+
+static gchar *output_file = NULL;
+static gchar **modules = NULL;
+static gchar **input_files = NULL;
+
+static GOptionEntry entries[] = {
+  {
+    "output", 'o',
+    0,
+    G_OPTION_ARG_FILENAME, &output_file,
+    "Write the compiled definitions to FILE", "FILE"
+  },
+  {
+    "load-module", 'l',
+    0,
+    G_OPTION_ARG_FILENAME_ARRAY, &modules,
+    "Load the types defined by MODULE", "MODULE"
+  },
+  {
+    G_OPTION_REMAINING, 0,
+    0,
+    G_OPTION_ARG_FILENAME_ARRAY, &input_files,
+    NULL, NULL
+  },
+  { NULL }
+};
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GBytes *compiled;
+  gchar *contents;
+  gsize length;
+  gint i;
+
+#if !GLIB_CHECK_VERSION (2, 35, 1)
+  g_type_init ();
+#endif
+
+  context = g_option_context_new ("FILE - compile ClutterScript UI definitions");
+  g_option_context_add_main_entries (context, entries, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  if (input_files == NULL || input_files[0] == NULL || input_files[1] != NULL)
+    {
+      g_printerr ("A single input file is required\n");
+      return EXIT_FAILURE;
+    }
+
+  /* the types of the application are resolved by looking up their
+   * type functions, so the modules defining them must be global
+   */
+  for (i = 0; modules != NULL && modules[i] != NULL; i++)
+    {
+      if (g_module_open (modules[i], G_MODULE_BIND_LAZY) == NULL)
+        {
+          g_printerr ("Unable to load '%s': %s\n",
+                      modules[i],
+                      g_module_error ());
+          return EXIT_FAILURE;
+        }
+    }
+
+  if (!g_file_get_contents (input_files[0], &contents, &length, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  compiled = clutter_script_compile_data (contents, length, &error);
+  g_free (contents);
+
+  if (compiled == NULL)
+    {
+      g_printerr ("%s: %s\n", input_files[0], error->message);
+      return EXIT_FAILURE;
+    }
+
+  if (output_file == NULL)
+    output_file = g_strconcat (input_files[0], ".compiled", NULL);
+
+  if (!g_file_set_contents (output_file,
+                            g_bytes_get_data (compiled, NULL),
+                            g_bytes_get_size (compiled),
+                            &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_bytes_unref (compiled);
+
+  return EXIT_SUCCESS;
+}
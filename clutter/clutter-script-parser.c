@@ -66,35 +66,69 @@ clutter_script_parser_init (ClutterScriptParser *parser)
 {
 }
 
-GType
-_clutter_script_get_type_from_symbol (const gchar *symbol)
+/* caches the types resolved through a symbol lookup; the types are
+ * never unregistered, so the entries are valid for the whole lifetime
+ * of the process
+ */
+static GHashTable *resolved_types = NULL;
+
+static GType
+get_type_from_symbol_uncached (const gchar *symbol)
 {
   static GModule *module = NULL;
   GTypeGetFunc func;
   GType gtype = G_TYPE_INVALID;
 
-  if (!module)
+  if (G_UNLIKELY (!module))
     module = g_module_open (NULL, 0);
-  
+
   if (g_module_symbol (module, symbol, (gpointer)&func))
-    gtype = func ();
-  
+    {
+      CLUTTER_NOTE (SCRIPT, "Type function: %s", symbol);
+      gtype = func ();
+    }
+
   return gtype;
 }
 
 GType
-_clutter_script_get_type_from_class (const gchar *name)
+_clutter_script_get_type_from_symbol (const gchar *symbol)
+{
+  GType gtype;
+
+  if (G_UNLIKELY (resolved_types == NULL))
+    resolved_types = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                            g_free,
+                                            NULL);
+
+  gtype = GPOINTER_TO_SIZE (g_hash_table_lookup (resolved_types, symbol));
+  if (gtype != G_TYPE_INVALID)
+    return gtype;
+
+  gtype = get_type_from_symbol_uncached (symbol);
+  if (gtype != G_TYPE_INVALID)
+    g_hash_table_insert (resolved_types,
+                         g_strdup (symbol),
+                         GSIZE_TO_POINTER (gtype));
+
+  return gtype;
+}
+
+/*< private >
+ * _clutter_script_get_type_symbol:
+ * @name: the name of a class
+ *
+ * Retrieves the name of the function returning the #GType of
+ * the class called @name, following the GObject naming policy.
+ *
+ * Return value: (transfer full): the name of the type function
+ */
+gchar *
+_clutter_script_get_type_symbol (const gchar *name)
 {
-  static GModule *module = NULL;
   GString *symbol_name = g_string_sized_new (64);
-  GType gtype = G_TYPE_INVALID;
-  GTypeGetFunc func;
-  gchar *symbol;
   gint i;
 
-  if (G_UNLIKELY (!module))
-    module = g_module_open (NULL, 0);
-  
   for (i = 0; name[i] != '\0'; i++)
     {
       gchar c = name[i];
@@ -132,15 +166,18 @@ _clutter_script_get_type_from_class (const gchar *name)
     }
 
   g_string_append (symbol_name, "_get_type");
-  
-  symbol = g_string_free (symbol_name, FALSE);
 
-  if (g_module_symbol (module, symbol, (gpointer)&func))
-    {
-      CLUTTER_NOTE (SCRIPT, "Type function: %s", symbol);
-      gtype = func ();
-    }
-  
+  return g_string_free (symbol_name, FALSE);
+}
+
+GType
+_clutter_script_get_type_from_class (const gchar *name)
+{
+  GType gtype;
+  gchar *symbol;
+
+  symbol = _clutter_script_get_type_symbol (name);
+  gtype = _clutter_script_get_type_from_symbol (symbol);
   g_free (symbol);
 
   return gtype;
@@ -741,6 +778,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
   ObjectInfo *oinfo;
   JsonNode *val;
   const gchar *id_;
+  gboolean has_fake_id = FALSE;
   GList *members, *l;
 
   /* if the object definition does not have an 'id' field we'll
@@ -766,6 +804,8 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                     json_object_get_string_member (object, "type"));
 
       g_free (fake);
+
+      has_fake_id = TRUE;
     }
 
   if (!json_object_has_member (object, "type"))
@@ -789,6 +829,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
       oinfo = g_slice_new0 (ObjectInfo);
       oinfo->merge_id = _clutter_script_get_last_merge_id (script);
       oinfo->id = g_strdup (id_);
+      oinfo->has_fake_id = has_fake_id;
 
       class_name = json_object_get_string_member (object, "type");
       oinfo->class_name = g_strdup (class_name);
@@ -894,13 +935,19 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                 g_list_length (oinfo->signals));
 
   _clutter_script_add_object_info (script, oinfo);
-  _clutter_script_construct_object (script, oinfo);
+
+  /* when compiling, the definitions are only collected */
+  if (!_clutter_script_is_compiling (script))
+    _clutter_script_construct_object (script, oinfo);
 }
 
 static void
 clutter_script_parser_parse_end (JsonParser *parser)
 {
-  clutter_script_ensure_objects (CLUTTER_SCRIPT_PARSER (parser)->script);
+  ClutterScript *script = CLUTTER_SCRIPT_PARSER (parser)->script;
+
+  if (!_clutter_script_is_compiling (script))
+    clutter_script_ensure_objects (script);
 }
 
 gboolean
@@ -1703,6 +1750,13 @@ add_children (ClutterScript *script,
                     g_type_name (G_OBJECT_TYPE (container)));
 
       clutter_actor_add_child (container, CLUTTER_ACTOR (object));
+
+      /* the lazily constructed children have their properties applied
+       * once they have been added, so that their child and layout
+       * properties can be resolved as well
+       */
+      if (child_info->is_lazy)
+        _clutter_script_apply_properties (script, child_info);
     }
 
   g_list_foreach (oinfo->children, (GFunc) g_free, NULL);
@@ -1935,4 +1989,10 @@ _clutter_script_construct_object (ClutterScript *script,
                             g_free);
 
   _clutter_script_check_unresolved (script, oinfo);
+
+  /* the objects loaded from a compiled definition are constructed on
+   * demand, and nobody is going to apply their properties later on
+   */
+  if (oinfo->is_lazy)
+    _clutter_script_apply_properties (script, oinfo);
 }
@@ -71,6 +71,8 @@ typedef struct {
   guint is_stage_default : 1;
   guint has_unresolved   : 1;
   guint is_unmerged      : 1;
+  guint has_fake_id      : 1;
+  guint is_lazy          : 1;
 } ObjectInfo;
 
 void object_info_free (gpointer data);
@@ -106,6 +108,7 @@ gboolean _clutter_script_parse_node        (ClutterScript *script,
 
 GType    _clutter_script_get_type_from_symbol (const gchar *symbol);
 GType    _clutter_script_get_type_from_class  (const gchar *name);
+gchar *  _clutter_script_get_type_symbol      (const gchar *name);
 
 gulong   _clutter_script_resolve_animation_mode (JsonNode *node);
 
@@ -159,6 +162,18 @@ void _clutter_script_add_object_info (ClutterScript *script,
 
 const gchar *_clutter_script_get_id_from_node (JsonNode *node);
 
+gboolean _clutter_script_is_compiling (ClutterScript *script);
+
+GList *  _clutter_script_list_object_infos  (ClutterScript  *script);
+
+GBytes * _clutter_script_compile            (ClutterScript  *script);
+gboolean _clutter_script_is_compiled_data   (const gchar    *data,
+                                             gsize           length);
+gboolean _clutter_script_load_compiled_data (ClutterScript  *script,
+                                             const gchar    *data,
+                                             gsize           length,
+                                             GError        **error);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_SCRIPT_PRIVATE_H__ */
@@ -115,6 +115,14 @@
  *                   of creating a new #ClutterStage instance
  * ]]></programlisting>
  *
+ * UI definitions can also be compiled ahead of time into a binary form,
+ * using clutter_script_compile_data() or the clutter-script-compiler
+ * tool; the compiled data can be loaded with the same functions used
+ * for the JSON data, including clutter_script_load_from_resource().
+ * The objects defined inside compiled data are not constructed when
+ * loading it, but the first time they are needed, for instance when
+ * calling clutter_script_get_object().
+ *
  * #ClutterScript is available since Clutter 0.6
  */
 
@@ -172,6 +180,7 @@ struct _ClutterScriptPrivate
 
   gchar *filename;
   guint is_filename : 1;
+  guint is_compiling : 1;
 };
 
 G_DEFINE_TYPE (ClutterScript, clutter_script, G_TYPE_OBJECT);
@@ -454,6 +463,7 @@ clutter_script_load_from_file (ClutterScript  *script,
 {
   ClutterScriptPrivate *priv;
   GError *internal_error;
+  GMappedFile *mapped_file;
 
   g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
   g_return_val_if_fail (filename != NULL, 0);
@@ -466,9 +476,34 @@ clutter_script_load_from_file (ClutterScript  *script,
   priv->last_merge_id += 1;
 
   internal_error = NULL;
-  json_parser_load_from_file (JSON_PARSER (priv->parser),
-                              filename,
-                              &internal_error);
+
+  /* both the compiled and the JSON definitions are read directly from
+   * the mapped file, instead of reading the file again */
+  mapped_file = g_mapped_file_new (filename, FALSE, &internal_error);
+  if (mapped_file != NULL)
+    {
+      const gchar *contents = g_mapped_file_get_contents (mapped_file);
+      gsize length = g_mapped_file_get_length (mapped_file);
+
+      /* empty files are not mapped */
+      if (contents == NULL)
+        contents = "";
+
+      if (_clutter_script_is_compiled_data (contents, length))
+        {
+          _clutter_script_load_compiled_data (script, contents, length,
+                                              &internal_error);
+        }
+      else
+        {
+          json_parser_load_from_data (JSON_PARSER (priv->parser),
+                                      contents, length,
+                                      &internal_error);
+        }
+
+      g_mapped_file_unref (mapped_file);
+    }
+
   if (internal_error)
     {
       g_propagate_error (error, internal_error);
@@ -490,6 +525,9 @@ clutter_script_load_from_file (ClutterScript  *script,
  * Loads the definitions from @data into @script and merges with
  * the currently loaded ones, if any.
  *
+ * The definitions can also be in the compiled form returned by
+ * clutter_script_compile_data(); in that case, @length must be set.
+ *
  * Return value: on error, zero is returned and @error is set
  *   accordingly. On success, the merge id for the UI definitions is
  *   returned. You can use the merge id with clutter_script_unmerge_objects().
@@ -508,9 +546,6 @@ clutter_script_load_from_data (ClutterScript  *script,
   g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
   g_return_val_if_fail (data != NULL, 0);
 
-  if (length < 0)
-    length = strlen (data);
-
   priv = script->priv;
 
   g_free (priv->filename);
@@ -519,9 +554,22 @@ clutter_script_load_from_data (ClutterScript  *script,
   priv->last_merge_id += 1;
 
   internal_error = NULL;
-  json_parser_load_from_data (JSON_PARSER (priv->parser),
-                              data, length,
-                              &internal_error);
+
+  if (length >= 0 && _clutter_script_is_compiled_data (data, length))
+    {
+      _clutter_script_load_compiled_data (script, data, length,
+                                          &internal_error);
+    }
+  else
+    {
+      if (length < 0)
+        length = strlen (data);
+
+      json_parser_load_from_data (JSON_PARSER (priv->parser),
+                                  data, length,
+                                  &internal_error);
+    }
+
   if (internal_error)
     {
       g_propagate_error (error, internal_error);
@@ -571,6 +619,67 @@ clutter_script_load_from_resource (ClutterScript  *script,
   return res;
 }
 
+/**
+ * clutter_script_compile_data:
+ * @data: a buffer containing UI definitions in JSON
+ * @length: the length of the buffer, or -1 if @data is a NUL-terminated
+ *   buffer
+ * @error: return location for a #GError, or %NULL
+ *
+ * Compiles the UI definitions inside @data into a binary form, which
+ * can be loaded using clutter_script_load_from_data(),
+ * clutter_script_load_from_file() and clutter_script_load_from_resource()
+ * without parsing the JSON again.
+ *
+ * The objects defined inside @data are not constructed, but the types
+ * of their classes are resolved, and the values of their enumeration,
+ * flags and color properties are converted ahead of time.
+ *
+ * Loading compiled data fails if it was created with an incompatible
+ * version of Clutter; in that case, the UI definitions have to be
+ * compiled again.
+ *
+ * Return value: (transfer full): the compiled UI definitions, or %NULL
+ *   in case of error. Use g_bytes_unref() when done
+ *
+ *
+ */
+GBytes *
+clutter_script_compile_data (const gchar  *data,
+                             gssize        length,
+                             GError      **error)
+{
+  ClutterScript *script;
+  GError *internal_error;
+  GBytes *retval;
+
+  g_return_val_if_fail (data != NULL, NULL);
+
+  if (length < 0)
+    length = strlen (data);
+
+  script = clutter_script_new ();
+  script->priv->is_compiling = TRUE;
+  script->priv->last_merge_id += 1;
+
+  internal_error = NULL;
+  json_parser_load_from_data (JSON_PARSER (script->priv->parser),
+                              data, length,
+                              &internal_error);
+  if (internal_error != NULL)
+    {
+      g_propagate_error (error, internal_error);
+      g_object_unref (script);
+      return NULL;
+    }
+
+  retval = _clutter_script_compile (script);
+
+  g_object_unref (script);
+
+  return retval;
+}
+
 /**
  * clutter_script_get_object:
  * @script: a #ClutterScript
@@ -943,10 +1052,18 @@ connect_each_object (gpointer key,
   SignalConnectData *connect_data = data;
   ClutterScript *script = connect_data->script;
   ObjectInfo *oinfo = value;
-  GObject *object = oinfo->object;
+  GObject *object;
   GList *unresolved, *l;
 
-  _clutter_script_construct_object (script, oinfo);
+  /* do not force the construction of lazily loaded objects unless
+   * there are signal handlers to connect
+   */
+  if (oinfo->signals == NULL)
+    return;
+
+  object = clutter_script_get_object (script, oinfo->id);
+  if (object == NULL)
+    return;
 
   unresolved = NULL;
   for (l = oinfo->signals; l != NULL; l = l->next)
@@ -1357,6 +1474,36 @@ _clutter_script_get_object_info (ClutterScript *script,
   return g_hash_table_lookup (priv->objects, script_id);
 }
 
+/*
+ * _clutter_script_is_compiling:
+ * @script: a #ClutterScript
+ *
+ * Checks whether @script is only collecting the object definitions
+ * for clutter_script_compile_data(), in which case no object should
+ * be constructed
+ *
+ * Return value: %TRUE if @script is compiling
+ */
+gboolean
+_clutter_script_is_compiling (ClutterScript *script)
+{
+  return script->priv->is_compiling;
+}
+
+/*
+ * _clutter_script_list_object_infos:
+ * @script: a #ClutterScript
+ *
+ * Retrieves all the #ObjectInfo held by @script
+ *
+ * Return value: a list of #ObjectInfo; use g_list_free() when done
+ */
+GList *
+_clutter_script_list_object_infos (ClutterScript *script)
+{
+  return g_hash_table_get_values (script->priv->objects);
+}
+
 /*
  * _clutter_script_get_last_merge_id:
  * @script: a #ClutterScript
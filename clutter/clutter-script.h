@@ -158,6 +158,10 @@ guint           clutter_script_load_from_resource       (ClutterScript
                                                          const gchar               *resource_path,
                                                          GError                   **error);
 
+GBytes *        clutter_script_compile_data             (const gchar               *data,
+                                                         gssize                     length,
+                                                         GError                   **error);
+
 GObject *       clutter_script_get_object               (ClutterScript             *script,
                                                          const gchar               *name);
 gint            clutter_script_get_objects              (ClutterScript             *script,
@@ -0,0 +1,504 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: quadtree of pointers associated with boxes.
+ *
+ * Each item is stored in the deepest node whose bounds fully contain
+ * the box of the item; items crossing the boundaries between the
+ * quadrants of a node, or lying outside the bounds of the root node,
+ * are stored in the node itself. Nodes are split lazily, once they
+ * hold more than NODE_MAX_ITEMS items.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-spatial-index.h"
+
+#define NODE_MAX_ITEMS  8
+#define NODE_MAX_DEPTH  8
+
+typedef struct _QuadNode        QuadNode;
+typedef struct _IndexEntry      IndexEntry;
+
+struct _QuadNode
+{
+  ClutterActorBox bounds;
+
+  /* the IndexEntry stored at this level */
+  GPtrArray *entries;
+
+  QuadNode *children[4];
+
+  guint depth;
+};
+
+struct _IndexEntry
+{
+  gpointer item;
+
+  ClutterActorBox box;
+
+  /* the node holding the entry, and the position inside its array */
+  QuadNode *node;
+  guint position;
+};
+
+struct _ClutterSpatialIndex
+{
+  /* item -> IndexEntry */
+  GHashTable *entries;
+
+  QuadNode *root;
+};
+
+static inline gboolean
+box_contains_box (const ClutterActorBox *outer,
+                  const ClutterActorBox *inner)
+{
+  return inner->x1 >= outer->x1 && inner->x2 <= outer->x2 &&
+         inner->y1 >= outer->y1 && inner->y2 <= outer->y2;
+}
+
+static inline gboolean
+box_intersects_box (const ClutterActorBox *a,
+                    const ClutterActorBox *b)
+{
+  return a->x1 < b->x2 && a->x2 > b->x1 &&
+         a->y1 < b->y2 && a->y2 > b->y1;
+}
+
+static inline gboolean
+box_contains_point (const ClutterActorBox *box,
+                    gfloat                 x,
+                    gfloat                 y)
+{
+  return x >= box->x1 && x < box->x2 &&
+         y >= box->y1 && y < box->y2;
+}
+
+static QuadNode *
+quad_node_new (const ClutterActorBox *bounds,
+               guint                  depth)
+{
+  QuadNode *node = g_slice_new0 (QuadNode);
+
+  node->bounds = *bounds;
+  node->entries = g_ptr_array_new ();
+  node->depth = depth;
+
+  return node;
+}
+
+static void
+quad_node_free (QuadNode *node)
+{
+  int i;
+
+  if (node == NULL)
+    return;
+
+  for (i = 0; i < 4; i++)
+    quad_node_free (node->children[i]);
+
+  g_ptr_array_free (node->entries, TRUE);
+  g_slice_free (QuadNode, node);
+}
+
+static void
+quad_node_append (QuadNode   *node,
+                  IndexEntry *entry)
+{
+  entry->node = node;
+  entry->position = node->entries->len;
+  g_ptr_array_add (node->entries, entry);
+}
+
+static void
+quad_node_remove (QuadNode   *node,
+                  IndexEntry *entry)
+{
+  guint position = entry->position;
+
+  g_assert (g_ptr_array_index (node->entries, position) == entry);
+
+  /* this moves the last entry into the slot we just freed */
+  g_ptr_array_remove_index_fast (node->entries, position);
+
+  if (position < node->entries->len)
+    {
+      IndexEntry *moved = g_ptr_array_index (node->entries, position);
+
+      moved->position = position;
+    }
+
+  entry->node = NULL;
+}
+
+static QuadNode *
+quad_node_find_child (QuadNode              *node,
+                      const ClutterActorBox *box)
+{
+  int i;
+
+  if (node->children[0] == NULL)
+    return NULL;
+
+  for (i = 0; i < 4; i++)
+    {
+      if (box_contains_box (&node->children[i]->bounds, box))
+        return node->children[i];
+    }
+
+  return NULL;
+}
+
+static void
+quad_node_split (QuadNode *node)
+{
+  GPtrArray *old_entries;
+  float mid_x, mid_y;
+  guint i;
+
+  mid_x = (node->bounds.x1 + node->bounds.x2) / 2.f;
+  mid_y = (node->bounds.y1 + node->bounds.y2) / 2.f;
+
+  {
+    ClutterActorBox quadrants[4] = {
+      { node->bounds.x1, node->bounds.y1, mid_x, mid_y },
+      { mid_x, node->bounds.y1, node->bounds.x2, mid_y },
+      { node->bounds.x1, mid_y, mid_x, node->bounds.y2 },
+      { mid_x, mid_y, node->bounds.x2, node->bounds.y2 },
+    };
+
+    for (i = 0; i < 4; i++)
+      node->children[i] = quad_node_new (&quadrants[i], node->depth + 1);
+  }
+
+  /* push down every entry that fits inside one of the quadrants */
+  old_entries = node->entries;
+  node->entries = g_ptr_array_new ();
+
+  for (i = 0; i < old_entries->len; i++)
+    {
+      IndexEntry *entry = g_ptr_array_index (old_entries, i);
+      QuadNode *child = quad_node_find_child (node, &entry->box);
+
+      quad_node_append (child != NULL ? child : node, entry);
+    }
+
+  g_ptr_array_free (old_entries, TRUE);
+}
+
+static void
+quad_node_query_point (QuadNode                *node,
+                       gfloat                   x,
+                       gfloat                   y,
+                       ClutterSpatialIndexFunc  func,
+                       gpointer                 user_data)
+{
+  guint i;
+
+  for (i = 0; i < node->entries->len; i++)
+    {
+      IndexEntry *entry = g_ptr_array_index (node->entries, i);
+
+      if (box_contains_point (&entry->box, x, y))
+        func (entry->item, &entry->box, user_data);
+    }
+
+  if (node->children[0] == NULL)
+    return;
+
+  for (i = 0; i < 4; i++)
+    {
+      if (box_contains_point (&node->children[i]->bounds, x, y))
+        {
+          quad_node_query_point (node->children[i], x, y, func, user_data);
+          break;
+        }
+    }
+}
+
+static void
+quad_node_query_box (QuadNode                *node,
+                     const ClutterActorBox   *box,
+                     ClutterSpatialIndexFunc  func,
+                     gpointer                 user_data)
+{
+  guint i;
+
+  for (i = 0; i < node->entries->len; i++)
+    {
+      IndexEntry *entry = g_ptr_array_index (node->entries, i);
+
+      if (box_intersects_box (&entry->box, box))
+        func (entry->item, &entry->box, user_data);
+    }
+
+  if (node->children[0] == NULL)
+    return;
+
+  for (i = 0; i < 4; i++)
+    {
+      if (box_intersects_box (&node->children[i]->bounds, box))
+        quad_node_query_box (node->children[i], box, func, user_data);
+    }
+}
+
+static void
+index_entry_free (gpointer data)
+{
+  g_slice_free (IndexEntry, data);
+}
+
+ClutterSpatialIndex *
+_clutter_spatial_index_new (const ClutterActorBox *bounds)
+{
+  ClutterSpatialIndex *index_;
+
+  g_return_val_if_fail (bounds != NULL, NULL);
+
+  index_ = g_slice_new (ClutterSpatialIndex);
+  index_->entries = g_hash_table_new_full (NULL, NULL,
+                                           NULL,
+                                           index_entry_free);
+  index_->root = quad_node_new (bounds, 0);
+
+  return index_;
+}
+
+void
+_clutter_spatial_index_free (ClutterSpatialIndex *index_)
+{
+  g_return_if_fail (index_ != NULL);
+
+  quad_node_free (index_->root);
+  g_hash_table_destroy (index_->entries);
+  g_slice_free (ClutterSpatialIndex, index_);
+}
+
+/*< private >
+ * _clutter_spatial_index_reset:
+ * @index_: a #ClutterSpatialIndex
+ * @bounds: the new bounds of the index
+ *
+ * Removes all the items from @index_, and changes the bounds of
+ * the root node to @bounds.
+ */
+void
+_clutter_spatial_index_reset (ClutterSpatialIndex   *index_,
+                              const ClutterActorBox *bounds)
+{
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (bounds != NULL);
+
+  g_hash_table_remove_all (index_->entries);
+
+  quad_node_free (index_->root);
+  index_->root = quad_node_new (bounds, 0);
+}
+
+guint
+_clutter_spatial_index_get_n_items (ClutterSpatialIndex *index_)
+{
+  g_return_val_if_fail (index_ != NULL, 0);
+
+  return g_hash_table_size (index_->entries);
+}
+
+/*< private >
+ * _clutter_spatial_index_insert:
+ * @index_: a #ClutterSpatialIndex
+ * @item: the item to insert
+ * @box: the box associated to @item
+ *
+ * Inserts @item inside @index_; if @item is already stored inside
+ * the index, its box will be replaced by @box.
+ */
+void
+_clutter_spatial_index_insert (ClutterSpatialIndex   *index_,
+                               gpointer               item,
+                               const ClutterActorBox *box)
+{
+  IndexEntry *entry;
+  QuadNode *node, *child;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (box != NULL);
+
+  entry = g_hash_table_lookup (index_->entries, item);
+  if (entry != NULL)
+    quad_node_remove (entry->node, entry);
+  else
+    {
+      entry = g_slice_new (IndexEntry);
+      entry->item = item;
+
+      g_hash_table_insert (index_->entries, item, entry);
+    }
+
+  entry->box = *box;
+
+  node = index_->root;
+  while ((child = quad_node_find_child (node, box)) != NULL)
+    node = child;
+
+  quad_node_append (node, entry);
+
+  if (node->children[0] == NULL &&
+      node->entries->len > NODE_MAX_ITEMS &&
+      node->depth < NODE_MAX_DEPTH)
+    quad_node_split (node);
+}
+
+/*< private >
+ * _clutter_spatial_index_remove:
+ * @index_: a #ClutterSpatialIndex
+ * @item: the item to remove
+ *
+ * Removes @item from @index_.
+ *
+ * Return value: %TRUE if @item was stored inside @index_
+ */
+gboolean
+_clutter_spatial_index_remove (ClutterSpatialIndex *index_,
+                               gpointer             item)
+{
+  IndexEntry *entry;
+
+  g_return_val_if_fail (index_ != NULL, FALSE);
+
+  entry = g_hash_table_lookup (index_->entries, item);
+  if (entry == NULL)
+    return FALSE;
+
+  quad_node_remove (entry->node, entry);
+  g_hash_table_remove (index_->entries, item);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_spatial_index_lookup:
+ * @index_: a #ClutterSpatialIndex
+ * @item: the item to look up
+ * @box: (out) (allow-none): return location for the box of @item
+ *
+ * Retrieves the box associated to @item.
+ *
+ * Return value: %TRUE if @item is stored inside @index_
+ */
+gboolean
+_clutter_spatial_index_lookup (ClutterSpatialIndex *index_,
+                               gpointer             item,
+                               ClutterActorBox     *box)
+{
+  IndexEntry *entry;
+
+  g_return_val_if_fail (index_ != NULL, FALSE);
+
+  entry = g_hash_table_lookup (index_->entries, item);
+  if (entry == NULL)
+    return FALSE;
+
+  if (box != NULL)
+    *box = entry->box;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_spatial_index_query_point:
+ * @index_: a #ClutterSpatialIndex
+ * @x: the X coordinate of the point
+ * @y: the Y coordinate of the point
+ * @func: the function to call for each item containing the point
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each item stored inside @index_ whose box
+ * contains the point at (@x, @y). The order in which @func is
+ * called is undefined.
+ */
+void
+_clutter_spatial_index_query_point (ClutterSpatialIndex     *index_,
+                                    gfloat                   x,
+                                    gfloat                   y,
+                                    ClutterSpatialIndexFunc  func,
+                                    gpointer                 user_data)
+{
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (func != NULL);
+
+  quad_node_query_point (index_->root, x, y, func, user_data);
+}
+
+/*< private >
+ * _clutter_spatial_index_query_box:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box to query
+ * @func: the function to call for each item intersecting @box
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each item stored inside @index_ whose box
+ * intersects @box. The order in which @func is called is undefined.
+ */
+void
+_clutter_spatial_index_query_box (ClutterSpatialIndex     *index_,
+                                  const ClutterActorBox   *box,
+                                  ClutterSpatialIndexFunc  func,
+                                  gpointer                 user_data)
+{
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (box != NULL);
+  g_return_if_fail (func != NULL);
+
+  quad_node_query_box (index_->root, box, func, user_data);
+}
+
+/*< private >
+ * _clutter_spatial_index_foreach:
+ * @index_: a #ClutterSpatialIndex
+ * @func: the function to call for each item
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each item stored inside @index_. The index must
+ * not be modified by @func.
+ */
+void
+_clutter_spatial_index_foreach (ClutterSpatialIndex     *index_,
+                                ClutterSpatialIndexFunc  func,
+                                gpointer                 user_data)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (func != NULL);
+
+  g_hash_table_iter_init (&iter, index_->entries);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      IndexEntry *entry = value;
+
+      func (entry->item, &entry->box, user_data);
+    }
+}
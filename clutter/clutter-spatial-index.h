@@ -0,0 +1,77 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: quadtree of pointers associated with boxes.
+ */
+
+#ifndef __CLUTTER_SPATIAL_INDEX_H__
+#define __CLUTTER_SPATIAL_INDEX_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterSpatialIndex     ClutterSpatialIndex;
+
+/*< private >
+ * ClutterSpatialIndexFunc:
+ * @item: the item stored in the index
+ * @box: the box associated to @item
+ * @user_data: data passed to the query function
+ *
+ * The prototype of the function called for each item matching a
+ * query on a #ClutterSpatialIndex.
+ */
+typedef void (* ClutterSpatialIndexFunc) (gpointer               item,
+                                          const ClutterActorBox *box,
+                                          gpointer               user_data);
+
+ClutterSpatialIndex *   _clutter_spatial_index_new              (const ClutterActorBox   *bounds);
+void                    _clutter_spatial_index_free             (ClutterSpatialIndex     *index_);
+
+void                    _clutter_spatial_index_reset            (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *bounds);
+guint                   _clutter_spatial_index_get_n_items      (ClutterSpatialIndex     *index_);
+
+void                    _clutter_spatial_index_insert           (ClutterSpatialIndex     *index_,
+                                                                 gpointer                 item,
+                                                                 const ClutterActorBox   *box);
+gboolean                _clutter_spatial_index_remove           (ClutterSpatialIndex     *index_,
+                                                                 gpointer                 item);
+gboolean                _clutter_spatial_index_lookup           (ClutterSpatialIndex     *index_,
+                                                                 gpointer                 item,
+                                                                 ClutterActorBox         *box);
+
+void                    _clutter_spatial_index_query_point      (ClutterSpatialIndex     *index_,
+                                                                 gfloat                   x,
+                                                                 gfloat                   y,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+void                    _clutter_spatial_index_query_box        (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+void                    _clutter_spatial_index_foreach          (ClutterSpatialIndex     *index_,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SPATIAL_INDEX_H__ */
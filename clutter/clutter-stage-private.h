@@ -26,6 +26,7 @@
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
 #include <clutter/clutter-private.h>
+#include <clutter/clutter-spatial-index.h>
 
 #include <cogl/cogl.h>
 
@@ -58,11 +59,14 @@ void                _clutter_stage_get_viewport          (ClutterStage
 void                _clutter_stage_dirty_viewport        (ClutterStage          *stage);
 void                _clutter_stage_maybe_setup_viewport  (ClutterStage          *stage);
 void                _clutter_stage_maybe_relayout        (ClutterActor          *stage);
+void                _clutter_stage_queue_relayout_root   (ClutterStage          *stage,
+                                                          ClutterActor          *actor);
 gboolean            _clutter_stage_needs_update          (ClutterStage          *stage);
 gboolean            _clutter_stage_do_update             (ClutterStage          *stage);
 
 void     _clutter_stage_queue_event                       (ClutterStage *stage,
-					                   ClutterEvent *event);
+					                   ClutterEvent *event,
+					                   gboolean      copy_event);
 gboolean _clutter_stage_has_queued_events                 (ClutterStage *stage);
 void     _clutter_stage_process_queued_events             (ClutterStage *stage);
 void     _clutter_stage_update_input_devices              (ClutterStage *stage);
@@ -75,12 +79,32 @@ ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
                                       gint             x,
                                       gint             y,
                                       ClutterPickMode  mode);
+void          _clutter_stage_do_pick_points (ClutterStage        *stage,
+                                             const ClutterPoint  *points,
+                                             guint                n_points,
+                                             ClutterPickMode      mode,
+                                             ClutterActor       **actors);
 
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
 
 const ClutterPlane *_clutter_stage_get_clip (ClutterStage *stage);
 
+void                 _clutter_stage_update_actor_paint_box (ClutterStage       *stage,
+                                                            ClutterActor       *actor,
+                                                            ClutterPaintVolume *pv);
+void                 _clutter_stage_remove_actor_paint_box (ClutterStage       *stage,
+                                                            ClutterActor       *actor);
+gboolean             _clutter_stage_get_actor_paint_box    (ClutterStage       *stage,
+                                                            ClutterActor       *actor,
+                                                            ClutterActorBox    *box);
+gboolean             _clutter_stage_paint_box_is_clipped   (ClutterStage          *stage,
+                                                            const ClutterActorBox *box);
+void                 _clutter_stage_query_paint_boxes      (ClutterStage            *stage,
+                                                            ClutterSpatialIndexFunc  func,
+                                                            gpointer                 user_data);
+ClutterSpatialIndex *_clutter_stage_get_paint_box_index    (ClutterStage       *stage);
+
 ClutterStageQueueRedrawEntry *_clutter_stage_queue_actor_redraw            (ClutterStage                 *stage,
                                                                             ClutterStageQueueRedrawEntry *entry,
                                                                             ClutterActor                 *actor,
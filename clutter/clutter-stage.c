@@ -47,6 +47,7 @@
 #endif
 
 #include <math.h>
+#include <string.h>
 #include <cairo.h>
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
@@ -62,6 +63,7 @@
 #include "clutter-device-manager-private.h"
 #include "clutter-enum-types.h"
 #include "clutter-event-private.h"
+#include "clutter-frame-timings-private.h"
 #include "clutter-id-pool.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
@@ -131,10 +133,36 @@ struct _ClutterStagePrivate
 
   ClutterPlane current_clip_planes[4];
 
+  /* the window-space bounds of the clip used by the current paint */
+  ClutterActorBox current_clip_box;
+
+  /* the window-space paint boxes of the actors, as of their last paint */
+  ClutterSpatialIndex *paint_box_index;
+
   GList *pending_queue_redraws;
 
+  /* the relayout roots that queued a relayout; see
+   * _clutter_stage_queue_relayout_root()
+   */
+  GPtrArray *pending_relayout_roots;
+
   ClutterPickMode pick_buffer_mode;
 
+  /* the pixels read from the valid pick buffer by the last batched
+   * pick, up to MAX_PICK_POINTS; see _clutter_stage_do_pick_points() */
+  GArray *pick_points;
+
+  /* the offscreen framebuffer holding the full pick renders, and the
+   * pixel buffer they are read back into; see
+   * clutter_stage_render_offscreen_pick() */
+  CoglHandle pick_texture;
+  CoglFramebuffer *pick_framebuffer;
+  CoglBitmap *pick_bitmap;
+  const guint8 *pick_data;
+
+  /* the number of full pick renders since the last redraw */
+  guint full_picks_per_frame;
+
   CoglFramebuffer *active_framebuffer;
 
   gint sync_delay;
@@ -164,6 +192,9 @@ struct _ClutterStagePrivate
   guint accept_focus           : 1;
   guint motion_events_enabled  : 1;
   guint has_custom_perspective : 1;
+  guint geometric_picking      : 1;
+  guint pick_buffer_offscreen  : 1;
+  guint pick_offscreen_failed  : 1;
 };
 
 enum
@@ -202,6 +233,9 @@ static const ClutterColor default_stage_color = { 255, 255, 255, 255 };
 
 static void _clutter_stage_maybe_finish_queue_redraws (ClutterStage *stage);
 static void free_queue_redraw_entry (ClutterStageQueueRedrawEntry *entry);
+static gboolean clutter_stage_render_offscreen_pick (ClutterStage    *stage,
+                                                     ClutterPickMode  mode);
+static void clutter_stage_clear_paint_boxes (ClutterStage *stage);
 
 static void
 clutter_stage_get_preferred_width (ClutterActor *self,
@@ -575,6 +609,11 @@ _clutter_stage_do_paint (ClutterStage                *stage,
                                              &priv->inverse_projection,
                                              priv->current_clip_planes);
 
+  priv->current_clip_box.x1 = clip_poly[0];
+  priv->current_clip_box.y1 = clip_poly[1];
+  priv->current_clip_box.x2 = clip_poly[4];
+  priv->current_clip_box.y2 = clip_poly[5];
+
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
   clutter_actor_paint (CLUTTER_ACTOR (stage));
@@ -821,9 +860,19 @@ clutter_stage_real_fullscreen (ClutterStage *stage)
                           CLUTTER_ALLOCATION_NONE);
 }
 
+/*< private >
+ * _clutter_stage_queue_event:
+ * @stage: a #ClutterStage
+ * @event: the event to queue
+ * @copy_event: whether @event should be copied; if %FALSE, the stage
+ *   takes ownership of @event
+ *
+ * Queues @event, to be processed at the beginning of the next frame.
+ */
 void
 _clutter_stage_queue_event (ClutterStage *stage,
-			    ClutterEvent *event)
+			    ClutterEvent *event,
+			    gboolean      copy_event)
 {
   ClutterStagePrivate *priv;
   gboolean first_event;
@@ -835,7 +884,10 @@ _clutter_stage_queue_event (ClutterStage *stage,
 
   first_event = priv->event_queue->length == 0;
 
-  g_queue_push_tail (priv->event_queue, clutter_event_copy (event));
+  if (copy_event)
+    event = clutter_event_copy (event);
+
+  g_queue_push_tail (priv->event_queue, event);
 
   if (first_event)
     {
@@ -876,11 +928,105 @@ _clutter_stage_has_queued_events (ClutterStage *stage)
   return priv->event_queue->length > 0;
 }
 
+/* adds the point that processing @event is going to pick, if any */
+static void
+clutter_stage_add_pick_point (ClutterStage *stage,
+                              ClutterEvent *event,
+                              GArray       *pick_points)
+{
+  ClutterInputDevice *device;
+  ClutterPoint point;
+
+  if (event->any.source != NULL)
+    return;
+
+  switch (event->type)
+    {
+    case CLUTTER_MOTION:
+    case CLUTTER_TOUCH_UPDATE:
+      if (!stage->priv->motion_events_enabled)
+        return;
+      break;
+
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_SCROLL:
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      break;
+
+    default:
+      return;
+    }
+
+  /* the devices pick at their own coordinates */
+  device = clutter_event_get_device (event);
+  if (device != NULL)
+    {
+      if (clutter_input_device_get_device_type (device) == CLUTTER_KEYBOARD_DEVICE)
+        return;
+
+      clutter_input_device_get_coords (device,
+                                       clutter_event_get_event_sequence (event),
+                                       &point);
+    }
+  else
+    clutter_event_get_position (event, &point);
+
+  point.x = (gint) point.x;
+  point.y = (gint) point.y;
+
+  if (pick_points->len > 0)
+    {
+      const ClutterPoint *last;
+
+      last = &g_array_index (pick_points, ClutterPoint, pick_points->len - 1);
+      if (last->x == point.x && last->y == point.y)
+        return;
+    }
+
+  g_array_append_val (pick_points, point);
+}
+
+/* finds the next touch update of the same sequence as @event inside
+ * the queued events following @link; the touch updates of the other
+ * sequences are skipped, so that the updates of interleaved touch
+ * points can be coalesced as well */
+static ClutterEvent *
+find_next_touch_update (GList              *link,
+                        const ClutterEvent *event)
+{
+  ClutterInputDevice *device = clutter_event_get_device (event);
+  GList *l;
+
+  for (l = link->next; l != NULL; l = l->next)
+    {
+      ClutterEvent *next_event = l->data;
+      ClutterInputDevice *next_device;
+
+      if (next_event->type != CLUTTER_TOUCH_UPDATE)
+        return NULL;
+
+      if (next_event->touch.sequence != event->touch.sequence)
+        continue;
+
+      next_device = clutter_event_get_device (next_event);
+      if (device != NULL && next_device != NULL && device != next_device)
+        return NULL;
+
+      return next_event;
+    }
+
+  return NULL;
+}
+
 void
 _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
   GList *events, *l;
+  GArray *pick_points;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
@@ -920,36 +1066,79 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
       if (device != NULL && next_device != NULL)
         check_device = TRUE;
 
-      /* Skip consecutive motion events coming from the same device */
+      /* Skip consecutive motion events coming from the same device;
+       * the next event keeps their sample inside its motion history,
+       * so the motion events before a leave event are not dropped */
       if (priv->throttle_motion_events && next_event != NULL)
         {
           if (event->type == CLUTTER_MOTION &&
-              (next_event->type == CLUTTER_MOTION ||
-               next_event->type == CLUTTER_LEAVE) &&
+              next_event->type == CLUTTER_MOTION &&
               (!check_device || (device == next_device)))
             {
               CLUTTER_NOTE (EVENT,
                             "Omitting motion event at %d, %d",
                             (int) event->motion.x,
                             (int) event->motion.y);
-              goto next_event;
+
+              _clutter_event_coalesce_motion (next_event, event);
+
+              goto drop_event;
             }
           else if (event->type == CLUTTER_TOUCH_UPDATE &&
-                   (next_event->type == CLUTTER_TOUCH_UPDATE ||
-                    next_event->type == CLUTTER_LEAVE) &&
-                   (!check_device || (device == next_device)))
+                   (next_event = find_next_touch_update (l, event)) != NULL)
             {
               CLUTTER_NOTE (EVENT,
                             "Omitting touch update event at %d, %d",
                             (int) event->touch.x,
                             (int) event->touch.y);
-              goto next_event;
+
+              _clutter_event_coalesce_motion (next_event, event);
+
+              goto drop_event;
             }
         }
 
-      _clutter_process_event (event);
+      continue;
 
-    next_event:
+    drop_event:
+      clutter_event_free (event);
+      l->data = NULL;
+    }
+
+  /* resolve the actors underneath all the pointers and touch points
+   * with a single pick render; the following picks will reuse it, as
+   * long as the event handlers do not change the scene */
+  pick_points = g_array_new (FALSE, FALSE, sizeof (ClutterPoint));
+
+  for (l = events; l != NULL; l = l->next)
+    {
+      if (l->data != NULL)
+        clutter_stage_add_pick_point (stage, l->data, pick_points);
+    }
+
+  if (pick_points->len > 1)
+    {
+      ClutterActor **actors = g_new (ClutterActor *, pick_points->len);
+
+      _clutter_stage_do_pick_points (stage,
+                                     (ClutterPoint *) pick_points->data,
+                                     pick_points->len,
+                                     CLUTTER_PICK_REACTIVE,
+                                     actors);
+
+      g_free (actors);
+    }
+
+  g_array_free (pick_points, TRUE);
+
+  for (l = events; l != NULL; l = l->next)
+    {
+      ClutterEvent *event = l->data;
+
+      if (event == NULL)
+        continue;
+
+      _clutter_process_event (event);
       clutter_event_free (event);
     }
 
@@ -975,7 +1164,104 @@ _clutter_stage_needs_update (ClutterStage *stage)
 
   priv = stage->priv;
 
-  return priv->relayout_pending || priv->redraw_pending;
+  return priv->relayout_pending ||
+         priv->redraw_pending ||
+         priv->pending_relayout_roots->len > 0;
+}
+
+/*< private >
+ * _clutter_stage_queue_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: a relayout root inside @stage
+ *
+ * Queues a relayout of @actor alone; the allocation of @actor will
+ * be recomputed using the same box that its parent assigned to it
+ * during the last allocation of the stage.
+ *
+ * This is used by relayout roots, i.e. actors whose size request
+ * does not depend on their children, to avoid propagating the
+ * relayouts queued by their children up to the stage.
+ */
+void
+_clutter_stage_queue_relayout_root (ClutterStage *stage,
+                                    ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  guint i;
+
+  for (i = 0; i < priv->pending_relayout_roots->len; i++)
+    {
+      if (g_ptr_array_index (priv->pending_relayout_roots, i) == actor)
+        return;
+    }
+
+  CLUTTER_NOTE (LAYOUT, "Queueing relayout of root '%s'",
+                _clutter_actor_get_debug_name (actor));
+
+  g_ptr_array_add (priv->pending_relayout_roots, g_object_ref (actor));
+
+  _clutter_stage_schedule_update (stage);
+}
+
+static guint
+get_actor_depth (ClutterActor *actor)
+{
+  guint depth = 0;
+
+  while ((actor = clutter_actor_get_parent (actor)) != NULL)
+    depth += 1;
+
+  return depth;
+}
+
+static gint
+compare_actor_depth (gconstpointer a,
+                     gconstpointer b)
+{
+  guint depth_a = get_actor_depth (*(ClutterActor **) a);
+  guint depth_b = get_actor_depth (*(ClutterActor **) b);
+
+  if (depth_a < depth_b)
+    return -1;
+
+  if (depth_a > depth_b)
+    return 1;
+
+  return 0;
+}
+
+static void
+clutter_stage_allocate_relayout_roots (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  GPtrArray *roots;
+  guint i;
+
+  if (priv->pending_relayout_roots->len == 0)
+    return;
+
+  /* allocating a root might queue new relayouts, so we steal the
+   * array of pending roots
+   */
+  roots = priv->pending_relayout_roots;
+  priv->pending_relayout_roots = g_ptr_array_new ();
+
+  /* allocate the outermost roots first, since they may also allocate
+   * the roots they contain
+   */
+  g_ptr_array_sort (roots, compare_actor_depth);
+
+  for (i = 0; i < roots->len; i++)
+    {
+      ClutterActor *root = g_ptr_array_index (roots, i);
+
+      if (_clutter_actor_get_stage_internal (root) == CLUTTER_ACTOR (stage))
+        _clutter_actor_allocate_relayout_root (root);
+
+      g_object_unref (root);
+    }
+
+  g_ptr_array_free (roots, TRUE);
 }
 
 void
@@ -985,17 +1271,23 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
   ClutterStagePrivate *priv = stage->priv;
   gfloat natural_width, natural_height;
   ClutterActorBox box = { 0, };
+  gint64 timings_start;
   CLUTTER_STATIC_TIMER (relayout_timer,
                         "Mainloop", /* no parent */
                         "Layouting",
                         "The time spent reallocating the stage",
                         0 /* no application private data */);
 
-  if (!priv->relayout_pending)
+  if (!priv->relayout_pending && priv->pending_relayout_roots->len == 0)
     return;
 
   /* avoid reentrancy */
-  if (!CLUTTER_ACTOR_IN_RELAYOUT (stage))
+  if (CLUTTER_ACTOR_IN_RELAYOUT (stage))
+    return;
+
+  timings_start = _clutter_frame_timings_get_time ();
+
+  if (priv->relayout_pending)
     {
       priv->relayout_pending = FALSE;
 
@@ -1024,6 +1316,16 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
       CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, relayout_timer);
     }
+
+  /* the allocation of the stage does not reach the relayout roots
+   * if none of their ancestors changed, so we always need to check
+   */
+  CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+  clutter_stage_allocate_relayout_roots (stage);
+  CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+
+  _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_RELAYOUT,
+                                    timings_start);
 }
 
 static gboolean
@@ -1044,6 +1346,24 @@ _clutter_stage_set_pick_buffer_valid (ClutterStage   *stage,
 {
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
+  if (!valid || stage->priv->pick_buffer_mode != mode)
+    {
+      if (stage->priv->pick_points != NULL)
+        g_array_set_size (stage->priv->pick_points, 0);
+
+      if (stage->priv->pick_data != NULL)
+        {
+          CoglBuffer *buffer;
+
+          buffer = COGL_BUFFER (cogl_bitmap_get_buffer (stage->priv->pick_bitmap));
+          cogl_buffer_unmap (buffer);
+
+          stage->priv->pick_data = NULL;
+        }
+
+      stage->priv->pick_buffer_offscreen = FALSE;
+    }
+
   stage->priv->have_valid_pick_buffer = !!valid;
   stage->priv->pick_buffer_mode = mode;
 }
@@ -1054,6 +1374,8 @@ clutter_stage_do_redraw (ClutterStage *stage)
   ClutterBackend *backend = clutter_get_default_backend ();
   ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
+  gint64 timings_start;
+  gboolean prerender_pick;
 
   CLUTTER_STATIC_COUNTER (redraw_counter,
                           "clutter_stage_do_redraw counter",
@@ -1078,6 +1400,9 @@ clutter_stage_do_redraw (ClutterStage *stage)
   _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
   priv->picks_per_frame = 0;
 
+  prerender_pick = priv->full_picks_per_frame > 0;
+  priv->full_picks_per_frame = 0;
+
   _clutter_backend_ensure_context (backend, stage);
 
   if (_clutter_context_get_show_fps ())
@@ -1090,11 +1415,23 @@ clutter_stage_do_redraw (ClutterStage *stage)
 
   CLUTTER_COUNTER_INC (_clutter_uprof_context, redraw_counter);
   CLUTTER_TIMER_START (_clutter_uprof_context, redraw_timer);
+  timings_start = _clutter_frame_timings_get_time ();
 
   _clutter_stage_window_redraw (priv->impl);
 
+  _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_PAINT, timings_start);
   CLUTTER_TIMER_STOP (_clutter_uprof_context, redraw_timer);
 
+  /* if the last frame needed a full pick, the next one is likely to
+   * need one as well, so we render it right away; this gives the read
+   * back of the pick buffer time to complete before the next events
+   * are processed */
+  if (prerender_pick)
+    {
+      clutter_stage_render_offscreen_pick (stage, CLUTTER_PICK_REACTIVE);
+      priv->full_picks_per_frame = 0;
+    }
+
   if (_clutter_context_get_show_fps ())
     {
       priv->timer_n_frames += 1;
@@ -1331,6 +1668,299 @@ read_pixels_to_file (char *filename_stem,
   read_count++;
 }
 
+typedef struct _PickPoint {
+  gint x, y;
+  guchar pixel[4];
+} PickPoint;
+
+/* the maximum number of pixels read at once by a batched pick; past
+ * this size, each point is read on its own */
+#define MAX_PICK_READ_AREA      (256 * 256)
+
+/* the maximum number of pixels kept from the last batched pick; they
+ * are looked up linearly, and a frame only has a handful of pointers
+ * and touch points */
+#define MAX_PICK_POINTS         32
+
+static ClutterActor *
+clutter_stage_actor_from_pick_pixel (ClutterStage *stage,
+                                     const guchar *pixel)
+{
+  guint32 id_;
+
+  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
+    return CLUTTER_ACTOR (stage);
+
+  id_ = _clutter_pixel_to_id ((guchar *) pixel);
+
+  return _clutter_get_actor_by_id (stage, id_);
+}
+
+/* renders the scene in pick mode into the current framebuffer, using
+ * whatever clip and viewport are currently set */
+static void
+clutter_stage_paint_pick (ClutterStage    *stage,
+                          ClutterPickMode  mode)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+  CoglColor stage_pick_id;
+  gboolean dither_enabled_save;
+  CoglFramebuffer *fb;
+
+  CLUTTER_STATIC_TIMER (pick_clear,
+                        "Picking", /* parent */
+                        "Stage clear (pick)",
+                        "The time spent clearing stage for picking",
+                        0 /* no application private data */);
+  CLUTTER_STATIC_TIMER (pick_paint,
+                        "Picking", /* parent */
+                        "Painting actors (pick mode)",
+                        "The time spent painting actors in pick mode",
+                        0 /* no application private data */);
+
+  cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
+  CLUTTER_TIMER_START (_clutter_uprof_context, pick_clear);
+  cogl_clear (&stage_pick_id,
+	      COGL_BUFFER_BIT_COLOR |
+	      COGL_BUFFER_BIT_DEPTH);
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_clear);
+
+  /* Disable dithering (if any) when doing the painting in pick mode */
+  fb = cogl_get_draw_framebuffer ();
+  dither_enabled_save = cogl_framebuffer_get_dither_enabled (fb);
+  cogl_framebuffer_set_dither_enabled (fb, FALSE);
+
+  /* Render the entire scence in pick mode - just single colored silhouette's
+   * are drawn offscreen (as we never swap buffers)
+  */
+  CLUTTER_TIMER_START (_clutter_uprof_context, pick_paint);
+  context->pick_mode = mode;
+  _clutter_stage_do_paint (stage, NULL);
+  context->pick_mode = CLUTTER_PICK_NONE;
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_paint);
+
+  /* Restore whether GL_DITHER was enabled */
+  cogl_framebuffer_set_dither_enabled (fb, dither_enabled_save);
+}
+
+static gboolean
+clutter_stage_lookup_pick_point (ClutterStage *stage,
+                                 gint          x,
+                                 gint          y,
+                                 guchar       *pixel)
+{
+  GArray *pick_points = stage->priv->pick_points;
+  guint i;
+
+  if (pick_points == NULL)
+    return FALSE;
+
+  for (i = 0; i < pick_points->len; i++)
+    {
+      const PickPoint *point = &g_array_index (pick_points, PickPoint, i);
+
+      if (point->x == x && point->y == y)
+        {
+          memcpy (pixel, point->pixel, 4);
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static void
+clutter_stage_release_pick_framebuffer (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  /* unmaps the pick data, if needed */
+  _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
+
+  if (priv->pick_bitmap != NULL)
+    {
+      cogl_object_unref (priv->pick_bitmap);
+      priv->pick_bitmap = NULL;
+    }
+
+  if (priv->pick_framebuffer != NULL)
+    {
+      cogl_object_unref (priv->pick_framebuffer);
+      priv->pick_framebuffer = NULL;
+    }
+
+  if (priv->pick_texture != NULL)
+    {
+      cogl_object_unref (priv->pick_texture);
+      priv->pick_texture = NULL;
+    }
+}
+
+static gboolean
+clutter_stage_ensure_pick_framebuffer (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterBackend *backend;
+  cairo_rectangle_int_t geom;
+  CoglOffscreen *offscreen;
+
+  if (priv->pick_offscreen_failed)
+    return FALSE;
+
+  /* the pick buffers are dumped from the back buffer */
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS))
+    return FALSE;
+
+  _clutter_stage_window_get_geometry (priv->impl, &geom);
+
+  if (geom.width <= 0 || geom.height <= 0)
+    return FALSE;
+
+  if (priv->pick_framebuffer != NULL &&
+      cogl_bitmap_get_width (priv->pick_bitmap) == geom.width &&
+      cogl_bitmap_get_height (priv->pick_bitmap) == geom.height)
+    return TRUE;
+
+  clutter_stage_release_pick_framebuffer (stage);
+
+  CLUTTER_NOTE (PICK, "Creating a %dx%d offscreen pick buffer",
+                geom.width,
+                geom.height);
+
+  priv->pick_texture =
+    cogl_texture_new_with_size (geom.width, geom.height,
+                                COGL_TEXTURE_NO_SLICING,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (priv->pick_texture == NULL)
+    goto fail;
+
+  offscreen = cogl_offscreen_new_to_texture (priv->pick_texture);
+  if (offscreen == NULL)
+    goto fail;
+
+  priv->pick_framebuffer = COGL_FRAMEBUFFER (offscreen);
+
+  /* the bitmap is backed by a pixel buffer, if the driver supports
+   * them, which turns the read back into an asynchronous copy */
+  backend = clutter_get_default_backend ();
+  priv->pick_bitmap =
+    cogl_bitmap_new_with_size (clutter_backend_get_cogl_context (backend),
+                               geom.width, geom.height,
+                               COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+
+  return TRUE;
+
+fail:
+  CLUTTER_NOTE (PICK, "Unable to create the offscreen pick buffer; "
+                "picking in the back buffer");
+
+  clutter_stage_release_pick_framebuffer (stage);
+  priv->pick_offscreen_failed = TRUE;
+
+  return FALSE;
+}
+
+/* renders the scene in pick mode into the offscreen pick framebuffer,
+ * and starts reading it back into the pick bitmap; the bitmap is only
+ * mapped by the first pick that needs its contents, which gives the
+ * GPU a chance to complete the copy in the meantime */
+static gboolean
+clutter_stage_render_offscreen_pick (ClutterStage    *stage,
+                                     ClutterPickMode  mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gboolean res;
+
+  if (!clutter_stage_ensure_pick_framebuffer (stage))
+    return FALSE;
+
+  /* the pixel buffer cannot be written while mapped */
+  _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
+
+  CLUTTER_NOTE (PICK, "Performing offscreen pick");
+
+  cogl_push_framebuffer (priv->pick_framebuffer);
+
+  cogl_framebuffer_set_viewport (priv->pick_framebuffer,
+                                 priv->viewport[0],
+                                 priv->viewport[1],
+                                 priv->viewport[2],
+                                 priv->viewport[3]);
+  cogl_framebuffer_set_projection_matrix (priv->pick_framebuffer,
+                                          &priv->projection);
+
+  clutter_stage_paint_pick (stage, mode);
+
+  res = cogl_framebuffer_read_pixels_into_bitmap (priv->pick_framebuffer,
+                                                  0, 0,
+                                                  COGL_READ_PIXELS_COLOR_BUFFER,
+                                                  priv->pick_bitmap);
+
+  cogl_pop_framebuffer ();
+
+  if (!res)
+    {
+      clutter_stage_release_pick_framebuffer (stage);
+      priv->pick_offscreen_failed = TRUE;
+
+      return FALSE;
+    }
+
+  priv->full_picks_per_frame += 1;
+
+  /* the back buffer is left untouched, so there is no need to call
+   * _clutter_stage_window_dirty_back_buffer() */
+  _clutter_stage_set_pick_buffer_valid (stage, TRUE, mode);
+  priv->pick_buffer_offscreen = TRUE;
+
+  return TRUE;
+}
+
+/* reads a pixel of the offscreen pick buffer, mapping the pick bitmap
+ * if needed; the bitmap stays mapped until the pick buffer is
+ * invalidated, so the following picks only read from memory */
+static gboolean
+clutter_stage_read_offscreen_pick (ClutterStage *stage,
+                                   gint          x,
+                                   gint          y,
+                                   guchar       *pixel)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gint rowstride;
+
+  g_assert (priv->pick_buffer_offscreen);
+
+  if (x < 0 || x >= cogl_bitmap_get_width (priv->pick_bitmap) ||
+      y < 0 || y >= cogl_bitmap_get_height (priv->pick_bitmap))
+    {
+      memset (pixel, 0xff, 4);
+      return TRUE;
+    }
+
+  if (priv->pick_data == NULL)
+    {
+      CoglBuffer *buffer;
+
+      buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->pick_bitmap));
+      priv->pick_data = cogl_buffer_map (buffer, COGL_BUFFER_ACCESS_READ, 0);
+      if (priv->pick_data == NULL)
+        {
+          CLUTTER_NOTE (PICK, "Unable to map the offscreen pick buffer; "
+                        "picking in the back buffer");
+
+          clutter_stage_release_pick_framebuffer (stage);
+          priv->pick_offscreen_failed = TRUE;
+
+          return FALSE;
+        }
+    }
+
+  rowstride = cogl_bitmap_get_rowstride (priv->pick_bitmap);
+  memcpy (pixel, priv->pick_data + y * rowstride + x * 4, 4);
+
+  return TRUE;
+}
+
 ClutterActor *
 _clutter_stage_do_pick (ClutterStage   *stage,
                         gint            x,
@@ -1340,11 +1970,9 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   ClutterStagePrivate *priv;
   ClutterMainContext *context;
   guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
-  CoglColor stage_pick_id;
-  gboolean dither_enabled_save;
-  CoglFramebuffer *fb;
   ClutterActor *actor;
   gboolean is_clipped;
+  gboolean res;
   gint read_x;
   gint read_y;
 
@@ -1352,21 +1980,16 @@ _clutter_stage_do_pick (ClutterStage   *stage,
                           "_clutter_stage_do_pick counter",
                           "Increments for each full pick run",
                           0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (geometric_pick_counter,
+                          "_clutter_stage_do_pick geometric counter",
+                          "Increments for each pick resolved without "
+                          "rendering",
+                          0 /* no application private data */);
   CLUTTER_STATIC_TIMER (pick_timer,
                         "Mainloop", /* parent */
                         "Picking",
                         "The time spent picking",
                         0 /* no application private data */);
-  CLUTTER_STATIC_TIMER (pick_clear,
-                        "Picking", /* parent */
-                        "Stage clear (pick)",
-                        "The time spent clearing stage for picking",
-                        0 /* no application private data */);
-  CLUTTER_STATIC_TIMER (pick_paint,
-                        "Picking", /* parent */
-                        "Painting actors (pick mode)",
-                        "The time spent painting actors in pick mode",
-                        0 /* no application private data */);
   CLUTTER_STATIC_TIMER (pick_read,
                         "Picking", /* parent */
                         "Read Pixels",
@@ -1385,17 +2008,54 @@ _clutter_stage_do_pick (ClutterStage   *stage,
     _clutter_profile_resume ();
 #endif /* CLUTTER_ENABLE_PROFILE */
 
-  CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
+  _clutter_frame_timings_add_pick ();
+
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_timer);
 
+  /* If the scene only contains actors using the default pick silhouette
+   * we can find the actor by testing the transformed allocations on the
+   * CPU, and avoid rendering and reading back the pick buffer entirely */
+  if (priv->geometric_picking &&
+      _clutter_actor_pick_geometry (CLUTTER_ACTOR (stage), mode, x, y, &actor))
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, geometric_pick_counter);
+      CLUTTER_NOTE (PICK, "Performing geometric pick at %i,%i", x, y);
+      goto out;
+    }
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
+
   context = _clutter_context_get_default ();
   clutter_stage_ensure_current (stage);
 
   /* It's possible that we currently have a static scene and have renderered a
    * full, unclipped pick buffer. If so we can simply continue to read from
    * this cached buffer until the scene next changes. */
+  if (_clutter_stage_get_pick_buffer_valid (stage, mode) &&
+      priv->pick_buffer_offscreen)
+    {
+      CLUTTER_TIMER_START (_clutter_uprof_context, pick_read);
+      res = clutter_stage_read_offscreen_pick (stage, x, y, pixel);
+      CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_read);
+
+      if (res)
+        {
+          CLUTTER_NOTE (PICK, "Reusing offscreen pick buffer to fetch "
+                        "actor at %i,%i", x, y);
+          goto check_pixel;
+        }
+    }
+
   if (_clutter_stage_get_pick_buffer_valid (stage, mode))
     {
+      /* the pixel might have been read by a batched pick already */
+      if (clutter_stage_lookup_pick_point (stage, x, y, pixel))
+        {
+          CLUTTER_NOTE (PICK, "Reusing batched pick to fetch actor at %i,%i",
+                        x, y);
+          goto check_pixel;
+        }
+
       CLUTTER_TIMER_START (_clutter_uprof_context, pick_read);
       cogl_read_pixels (x, y, 1, 1,
                         COGL_READ_PIXELS_COLOR_BUFFER,
@@ -1418,7 +2078,20 @@ _clutter_stage_do_pick (ClutterStage   *stage,
 
   /* If we are seeing multiple picks per frame that means the scene is static
    * so we promote to doing a non-scissored pick render so that all subsequent
-   * picks for the same static scene won't require additional renders */
+   * picks for the same static scene won't require additional renders; the
+   * render goes to the offscreen pick buffer, if possible, so that the back
+   * buffer is left intact */
+  if (priv->picks_per_frame >= 2 &&
+      clutter_stage_render_offscreen_pick (stage, mode))
+    {
+      CLUTTER_TIMER_START (_clutter_uprof_context, pick_read);
+      res = clutter_stage_read_offscreen_pick (stage, x, y, pixel);
+      CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_read);
+
+      if (res)
+        goto check_pixel;
+    }
+
   if (priv->picks_per_frame < 2)
     {
        gint dirty_x;
@@ -1445,29 +2118,10 @@ _clutter_stage_do_pick (ClutterStage   *stage,
       is_clipped = FALSE;
     }
 
-  CLUTTER_NOTE (PICK, "Performing %s pick at %i,%i",
-                is_clipped ? "clipped" : "full", x, y);
-
-  cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
-  CLUTTER_TIMER_START (_clutter_uprof_context, pick_clear);
-  cogl_clear (&stage_pick_id,
-	      COGL_BUFFER_BIT_COLOR |
-	      COGL_BUFFER_BIT_DEPTH);
-  CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_clear);
-
-  /* Disable dithering (if any) when doing the painting in pick mode */
-  fb = cogl_get_draw_framebuffer ();
-  dither_enabled_save = cogl_framebuffer_get_dither_enabled (fb);
-  cogl_framebuffer_set_dither_enabled (fb, FALSE);
+  CLUTTER_NOTE (PICK, "Performing %s pick at %i,%i",
+                is_clipped ? "clipped" : "full", x, y);
 
-  /* Render the entire scence in pick mode - just single colored silhouette's
-   * are drawn offscreen (as we never swap buffers)
-  */
-  CLUTTER_TIMER_START (_clutter_uprof_context, pick_paint);
-  context->pick_mode = mode;
-  _clutter_stage_do_paint (stage, NULL);
-  context->pick_mode = CLUTTER_PICK_NONE;
-  CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_paint);
+  clutter_stage_paint_pick (stage, mode);
 
   /* Read the color of the screen co-ords pixel. RGBA_8888_PRE is used
      even though we don't care about the alpha component because under
@@ -1497,9 +2151,6 @@ _clutter_stage_do_pick (ClutterStage   *stage,
       g_free (file_name);
     }
 
-  /* Restore whether GL_DITHER was enabled */
-  cogl_framebuffer_set_dither_enabled (fb, dither_enabled_save);
-
   if (is_clipped)
   {
      if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
@@ -1516,20 +2167,13 @@ _clutter_stage_do_pick (ClutterStage   *stage,
     _clutter_stage_window_dirty_back_buffer (priv->impl);
 
     _clutter_stage_set_pick_buffer_valid (stage, TRUE, mode);
+    priv->full_picks_per_frame += 1;
   }
 
 check_pixel:
-  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
-    {
-      actor = CLUTTER_ACTOR (stage);
-    }
-  else
-    {
-      guint32 id_ = _clutter_pixel_to_id (pixel);
-
-      actor = _clutter_get_actor_by_id (stage, id_);
-    }
+  actor = clutter_stage_actor_from_pick_pixel (stage, pixel);
 
+out:
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_timer);
 
 #ifdef CLUTTER_ENABLE_PROFILE
@@ -1540,6 +2184,216 @@ check_pixel:
   return actor;
 }
 
+/*< private >
+ * _clutter_stage_do_pick_points:
+ * @stage: a #ClutterStage
+ * @points: (array length=n_points): the points to pick, in stage
+ *   coordinates
+ * @n_points: the number of points
+ * @mode: the #ClutterPickMode
+ * @actors: (out caller-allocates) (array length=n_points): return
+ *   location for the actors at each point
+ *
+ * Picks the actors at @n_points points at once.
+ *
+ * The points that cannot be resolved geometrically are resolved using
+ * a single, unclipped render of the pick buffer. If the pick buffer is
+ * rendered offscreen, the points are read from its CPU-side copy;
+ * otherwise, the render is followed by a single read of the region
+ * bounding them (or by one read per point, if the region is too big),
+ * and the pixels are kept until the pick buffer is invalidated, so
+ * that _clutter_stage_do_pick() can resolve the same points without
+ * reading them again.
+ */
+void
+_clutter_stage_do_pick_points (ClutterStage       *stage,
+                               const ClutterPoint *points,
+                               guint               n_points,
+                               ClutterPickMode     mode,
+                               ClutterActor      **actors)
+{
+  ClutterStagePrivate *priv;
+  ClutterMainContext *context;
+  cairo_rectangle_int_t geom;
+  gint x1, y1, x2, y2;
+  guint *pending;
+  guint i, n_pending;
+
+  CLUTTER_STATIC_COUNTER (batch_pick_counter,
+                          "_clutter_stage_do_pick_points counter",
+                          "Increments for each batched pick render",
+                          0 /* no application private data */);
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (n_points == 0 || points != NULL);
+  g_return_if_fail (n_points == 0 || actors != NULL);
+
+  priv = stage->priv;
+
+  if (n_points == 0)
+    return;
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
+    {
+      for (i = 0; i < n_points; i++)
+        actors[i] = CLUTTER_ACTOR (stage);
+
+      return;
+    }
+
+  _clutter_stage_window_get_geometry (priv->impl, &geom);
+
+  pending = g_new (guint, n_points);
+  n_pending = 0;
+
+  x1 = y1 = G_MAXINT;
+  x2 = y2 = G_MININT;
+
+  for (i = 0; i < n_points; i++)
+    {
+      gint x = points[i].x;
+      gint y = points[i].y;
+
+      actors[i] = NULL;
+
+      if (priv->geometric_picking &&
+          _clutter_actor_pick_geometry (CLUTTER_ACTOR (stage), mode,
+                                        x, y,
+                                        &actors[i]))
+        continue;
+
+      /* the pick buffer only covers the stage */
+      if (x < 0 || x >= geom.width || y < 0 || y >= geom.height)
+        {
+          actors[i] = CLUTTER_ACTOR (stage);
+          continue;
+        }
+
+      pending[n_pending++] = i;
+
+      x1 = MIN (x1, x);
+      y1 = MIN (y1, y);
+      x2 = MAX (x2, x + 1);
+      y2 = MAX (y2, y + 1);
+    }
+
+  if (n_pending == 0)
+    goto out;
+
+  context = _clutter_context_get_default ();
+  clutter_stage_ensure_current (stage);
+
+  if (!_clutter_stage_get_pick_buffer_valid (stage, mode))
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, batch_pick_counter);
+      CLUTTER_NOTE (PICK, "Performing batched pick of %u points", n_pending);
+
+      _clutter_frame_timings_add_pick ();
+
+      _clutter_backend_ensure_context (context->backend, stage);
+      _clutter_stage_maybe_setup_viewport (stage);
+
+      if (!clutter_stage_render_offscreen_pick (stage, mode))
+        {
+          clutter_stage_paint_pick (stage, mode);
+
+          /* Notify the backend that we have trashed the contents of
+           * the back buffer... */
+          _clutter_stage_window_dirty_back_buffer (priv->impl);
+
+          _clutter_stage_set_pick_buffer_valid (stage, TRUE, mode);
+          priv->full_picks_per_frame += 1;
+        }
+    }
+
+  if (priv->pick_buffer_offscreen)
+    {
+      for (i = 0; i < n_pending; i++)
+        {
+          const ClutterPoint *point = &points[pending[i]];
+          guchar pixel[4];
+
+          /* if the pick buffer could not be mapped, the point is
+           * picked on its own */
+          if (priv->pick_buffer_offscreen &&
+              clutter_stage_read_offscreen_pick (stage,
+                                                 point->x, point->y,
+                                                 pixel))
+            actors[pending[i]] =
+              clutter_stage_actor_from_pick_pixel (stage, pixel);
+          else
+            actors[pending[i]] =
+              _clutter_stage_do_pick (stage, point->x, point->y, mode);
+        }
+
+      goto out;
+    }
+
+  /* only the pixels of the last batch are kept */
+  if (priv->pick_points == NULL)
+    priv->pick_points = g_array_new (FALSE, FALSE, sizeof (PickPoint));
+  else
+    g_array_set_size (priv->pick_points, 0);
+
+  if ((x2 - x1) * (y2 - y1) <= MAX_PICK_READ_AREA)
+    {
+      gint width = x2 - x1, height = y2 - y1;
+      guchar *region;
+
+      region = g_malloc (width * height * 4);
+      cogl_read_pixels (x1, y1, width, height,
+                        COGL_READ_PIXELS_COLOR_BUFFER,
+                        COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                        region);
+
+      for (i = 0; i < n_pending; i++)
+        {
+          const ClutterPoint *point = &points[pending[i]];
+          PickPoint pick_point;
+          gint offset;
+
+          pick_point.x = point->x;
+          pick_point.y = point->y;
+
+          offset = ((pick_point.y - y1) * width + (pick_point.x - x1)) * 4;
+          memcpy (pick_point.pixel, region + offset, 4);
+
+          if (priv->pick_points->len < MAX_PICK_POINTS)
+            g_array_append_val (priv->pick_points, pick_point);
+
+          actors[pending[i]] =
+            clutter_stage_actor_from_pick_pixel (stage, pick_point.pixel);
+        }
+
+      g_free (region);
+    }
+  else
+    {
+      for (i = 0; i < n_pending; i++)
+        {
+          const ClutterPoint *point = &points[pending[i]];
+          PickPoint pick_point;
+
+          pick_point.x = point->x;
+          pick_point.y = point->y;
+
+          cogl_read_pixels (pick_point.x, pick_point.y, 1, 1,
+                            COGL_READ_PIXELS_COLOR_BUFFER,
+                            COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                            pick_point.pixel);
+
+          if (priv->pick_points->len < MAX_PICK_POINTS)
+            g_array_append_val (priv->pick_points, pick_point);
+
+          actors[pending[i]] =
+            clutter_stage_actor_from_pick_pixel (stage, pick_point.pixel);
+        }
+    }
+
+out:
+  g_free (pending);
+}
+
 
 
 static gboolean
@@ -1756,6 +2610,11 @@ clutter_stage_dispose (GObject *object)
                     (GDestroyNotify) free_queue_redraw_entry);
   priv->pending_queue_redraws = NULL;
 
+  g_ptr_array_foreach (priv->pending_relayout_roots,
+                       (GFunc) g_object_unref,
+                       NULL);
+  g_ptr_array_set_size (priv->pending_relayout_roots, 0);
+
   /* this will release the reference on the stage */
   stage_manager = clutter_stage_manager_get_default ();
   _clutter_stage_manager_remove_stage (stage_manager, stage);
@@ -1776,8 +2635,18 @@ clutter_stage_finalize (GObject *object)
 
   g_array_free (priv->paint_volume_stack, TRUE);
 
+  g_ptr_array_free (priv->pending_relayout_roots, TRUE);
+
   _clutter_id_pool_free (priv->pick_id_pool);
 
+  clutter_stage_release_pick_framebuffer (stage);
+
+  if (priv->paint_box_index != NULL)
+    _clutter_spatial_index_free (priv->paint_box_index);
+
+  if (priv->pick_points != NULL)
+    g_array_free (priv->pick_points, TRUE);
+
   if (priv->fps_timer != NULL)
     g_timer_destroy (priv->fps_timer);
 
@@ -2112,6 +2981,8 @@ clutter_stage_init (ClutterStage *self)
 
   priv->event_queue = g_queue_new ();
 
+  priv->pending_relayout_roots = g_ptr_array_new ();
+
   priv->is_fullscreen = FALSE;
   priv->is_user_resizable = FALSE;
   priv->is_cursor_visible = TRUE;
@@ -2279,6 +3150,8 @@ void
 _clutter_stage_dirty_projection (ClutterStage *stage)
 {
   stage->priv->dirty_projection = TRUE;
+
+  clutter_stage_clear_paint_boxes (stage);
 }
 
 /*
@@ -2356,6 +3229,8 @@ void
 _clutter_stage_dirty_viewport (ClutterStage *stage)
 {
   stage->priv->dirty_viewport = TRUE;
+
+  clutter_stage_clear_paint_boxes (stage);
 }
 
 /*
@@ -3565,6 +4440,228 @@ _clutter_stage_get_clip (ClutterStage *stage)
   return stage->priv->current_clip_planes;
 }
 
+static void
+clutter_stage_get_paint_box_bounds (ClutterStage    *stage,
+                                    ClutterActorBox *bounds)
+{
+  cairo_rectangle_int_t geom;
+
+  _clutter_stage_window_get_geometry (stage->priv->impl, &geom);
+  bounds->x1 = 0;
+  bounds->y1 = 0;
+  bounds->x2 = MAX (geom.width, 1);
+  bounds->y2 = MAX (geom.height, 1);
+}
+
+static void
+clutter_stage_remove_paint_box (ClutterStage *stage,
+                                ClutterActor *actor)
+{
+  if (_clutter_spatial_index_remove (stage->priv->paint_box_index, actor))
+    _clutter_actor_set_has_paint_box (actor, FALSE);
+}
+
+static void
+clear_paint_box_cb (gpointer               item,
+                    const ClutterActorBox *box,
+                    gpointer               user_data)
+{
+  _clutter_actor_set_has_paint_box (item, FALSE);
+}
+
+/* Discards every paint box, e.g. because the viewport or the projection
+ * changed, which moves all of them.
+ */
+static void
+clutter_stage_clear_paint_boxes (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActorBox bounds;
+
+  if (priv->paint_box_index == NULL ||
+      _clutter_spatial_index_get_n_items (priv->paint_box_index) == 0)
+    return;
+
+  _clutter_spatial_index_foreach (priv->paint_box_index,
+                                  clear_paint_box_cb,
+                                  NULL);
+
+  clutter_stage_get_paint_box_bounds (stage, &bounds);
+  _clutter_spatial_index_reset (priv->paint_box_index, &bounds);
+}
+
+/* Changing the state of an actor changes its paint box, as well as the
+ * paint box of all its parents, since their paint volume includes the
+ * paint volume of the actor. The paint boxes of the children of the
+ * actor only change if its transformation changed, which the actors
+ * check lazily when looking up their paint box, so we do not need to
+ * visit them here.
+ */
+static void
+clutter_stage_invalidate_paint_boxes (ClutterStage *stage,
+                                      ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActor *iter;
+
+  if (priv->paint_box_index == NULL ||
+      _clutter_spatial_index_get_n_items (priv->paint_box_index) == 0)
+    return;
+
+  /* a redraw of the whole stage is queued when the viewport or the
+   * projection change */
+  if (actor == CLUTTER_ACTOR (stage))
+    {
+      clutter_stage_clear_paint_boxes (stage);
+      return;
+    }
+
+  for (iter = actor; iter != NULL; iter = clutter_actor_get_parent (iter))
+    clutter_stage_remove_paint_box (stage, iter);
+}
+
+/*< private >
+ * _clutter_stage_update_actor_paint_box:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor
+ * @pv: the paint volume of @actor, in eye coordinates, or %NULL
+ *
+ * Stores the window-space bounding box of @pv as the paint box of
+ * @actor, so that later paints and picks can skip @actor and its
+ * children without visiting them.
+ *
+ * The paint box is retained until @actor, one of its parents or one
+ * of its children queue a redraw, so this function will only compute
+ * the box if there is none stored for @actor already.
+ */
+void
+_clutter_stage_update_actor_paint_box (ClutterStage       *stage,
+                                       ClutterActor       *actor,
+                                       ClutterPaintVolume *pv)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActorBox box;
+
+  if (pv == NULL)
+    {
+      _clutter_stage_remove_actor_paint_box (stage, actor);
+      return;
+    }
+
+  if (priv->paint_box_index == NULL ||
+      _clutter_spatial_index_get_n_items (priv->paint_box_index) == 0)
+    {
+      ClutterActorBox bounds;
+
+      /* the bounds of the index are only an optimization, since the
+       * boxes outside of them will be stored at the root; we reset
+       * them whenever the index is empty, e.g. after a full redraw */
+      clutter_stage_get_paint_box_bounds (stage, &bounds);
+
+      if (priv->paint_box_index == NULL)
+        priv->paint_box_index = _clutter_spatial_index_new (&bounds);
+      else
+        _clutter_spatial_index_reset (priv->paint_box_index, &bounds);
+    }
+  else if (_clutter_spatial_index_lookup (priv->paint_box_index, actor, NULL))
+    return;
+
+  _clutter_paint_volume_get_stage_paint_box (pv, stage, &box);
+  _clutter_spatial_index_insert (priv->paint_box_index, actor, &box);
+  _clutter_actor_set_has_paint_box (actor, TRUE);
+}
+
+void
+_clutter_stage_remove_actor_paint_box (ClutterStage *stage,
+                                       ClutterActor *actor)
+{
+  if (stage->priv->paint_box_index != NULL)
+    clutter_stage_remove_paint_box (stage, actor);
+}
+
+/*< private >
+ * _clutter_stage_get_actor_paint_box:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor
+ * @box: (out): return location for the paint box of @actor
+ *
+ * Retrieves the paint box stored for @actor.
+ *
+ * Return value: %TRUE if a paint box is stored for @actor
+ */
+gboolean
+_clutter_stage_get_actor_paint_box (ClutterStage    *stage,
+                                    ClutterActor    *actor,
+                                    ClutterActorBox *box)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->paint_box_index == NULL)
+    return FALSE;
+
+  return _clutter_spatial_index_lookup (priv->paint_box_index, actor, box);
+}
+
+/*< private >
+ * _clutter_stage_get_paint_box_index:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the index of the paint boxes of the actors of @stage.
+ *
+ * Return value: (transfer none): the index, or %NULL
+ */
+ClutterSpatialIndex *
+_clutter_stage_get_paint_box_index (ClutterStage *stage)
+{
+  return stage->priv->paint_box_index;
+}
+
+/*< private >
+ * _clutter_stage_paint_box_is_clipped:
+ * @stage: a #ClutterStage
+ * @box: a paint box
+ *
+ * Checks whether @box lies completely outside the clip of the
+ * current paint.
+ *
+ * Return value: %TRUE if the actor owning @box, and its children,
+ *   can be skipped
+ */
+gboolean
+_clutter_stage_paint_box_is_clipped (ClutterStage          *stage,
+                                     const ClutterActorBox *box)
+{
+  const ClutterActorBox *clip = &stage->priv->current_clip_box;
+
+  return box->x2 <= clip->x1 || box->x1 >= clip->x2 ||
+         box->y2 <= clip->y1 || box->y1 >= clip->y2;
+}
+
+/*< private >
+ * _clutter_stage_query_paint_boxes:
+ * @stage: a #ClutterStage
+ * @func: the function to call for each actor
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each actor whose stored paint box intersects the
+ * clip of the current paint.
+ */
+void
+_clutter_stage_query_paint_boxes (ClutterStage            *stage,
+                                  ClutterSpatialIndexFunc  func,
+                                  gpointer                 user_data)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->paint_box_index == NULL)
+    return;
+
+  _clutter_spatial_index_query_box (priv->paint_box_index,
+                                    &priv->current_clip_box,
+                                    func,
+                                    user_data);
+}
+
 /* When an actor queues a redraw we add it to a list on the stage that
  * gets processed once all updates to the stage have been finished.
  *
@@ -3619,6 +4716,12 @@ _clutter_stage_queue_actor_redraw (ClutterStage *stage,
    */
   _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
 
+  /* The same assumption holds for the paint boxes we store in the index;
+   * we only need to do this the first time an actor queues a redraw in
+   * a frame, as the boxes will not be stored again until the next paint */
+  if (entry == NULL)
+    clutter_stage_invalidate_paint_boxes (stage, actor);
+
   if (entry)
     {
       /* Ignore all requests to queue a redraw for an actor if a full
@@ -3847,6 +4950,55 @@ clutter_stage_get_motion_events_enabled (ClutterStage *stage)
   return stage->priv->motion_events_enabled;
 }
 
+/**
+ * clutter_stage_set_geometric_picking:
+ * @stage: a #ClutterStage
+ * @enabled: %TRUE to enable geometric picking
+ *
+ * Sets whether the @stage should try to find the actor underneath
+ * a given point by testing the transformed allocation of each actor,
+ * instead of rendering the scene into a pick buffer and reading it
+ * back from the GPU.
+ *
+ * The geometric pick honours the paint order and the clip of each
+ * actor, and returns the same actor as the pick buffer for all the
+ * actors using the default #ClutterActorClass.pick implementation.
+ * If an actor overrides it, or has a #ClutterEffect overriding the
+ * #ClutterEffectClass.pick virtual function, the @stage will fall
+ * back to rendering the pick buffer.
+ *
+ * The default is %FALSE.
+ *
+ *
+ */
+void
+clutter_stage_set_geometric_picking (ClutterStage *stage,
+                                     gboolean      enabled)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  stage->priv->geometric_picking = !!enabled;
+}
+
+/**
+ * clutter_stage_get_geometric_picking:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set using clutter_stage_set_geometric_picking().
+ *
+ * Return value: %TRUE if the @stage picks actors geometrically,
+ *   and %FALSE otherwise
+ *
+ *
+ */
+gboolean
+clutter_stage_get_geometric_picking (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->geometric_picking;
+}
+
 /* NB: The presumption shouldn't be that a stage can't be comprised
  * of multiple internal framebuffers, so instead of simply naming
  * this function _clutter_stage_get_framebuffer(), the "active"
@@ -177,6 +177,10 @@ guchar *        clutter_stage_read_pixels                       (ClutterStage
 void            clutter_stage_get_redraw_clip_bounds            (ClutterStage          *stage,
                                                                  cairo_rectangle_int_t *clip);
 
+void            clutter_stage_set_geometric_picking             (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+gboolean        clutter_stage_get_geometric_picking             (ClutterStage          *stage);
+
 void            clutter_stage_ensure_current                    (ClutterStage          *stage);
 void            clutter_stage_ensure_viewport                   (ClutterStage          *stage);
 void            clutter_stage_ensure_redraw                     (ClutterStage          *stage);
@@ -275,6 +275,7 @@ enum
 static guint text_signals[LAST_SIGNAL] = { 0, };
 
 static void clutter_text_settings_changed_cb (ClutterText *text);
+static void shared_layout_cache_clear (void);
 static void buffer_connect_signals (ClutterText *self);
 static void buffer_disconnect_signals (ClutterText *self);
 static ClutterTextBuffer *get_buffer (ClutterText *self);
@@ -626,6 +627,9 @@ clutter_text_settings_changed_cb (ClutterText *text)
       g_free (font_name);
     }
 
+  /* the font options of the Pango context might have changed */
+  shared_layout_cache_clear ();
+
   clutter_text_dirty_cache (text);
   clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
 }
@@ -639,6 +643,286 @@ clutter_text_direction_changed_cb (GObject    *gobject,
   /* no need to queue a relayout: set_text_direction() will do that for us */
 }
 
+/*
+ * Shared layout cache
+ *
+ * Layouts are shared between all the ClutterText actors using the same
+ * display text, attributes, font and layout parameters, and evicted in
+ * least recently used order once their estimated size exceeds the size
+ * returned by _clutter_get_text_layout_cache_size().
+ */
+
+typedef struct _SharedLayoutKey         SharedLayoutKey;
+typedef struct _SharedLayout            SharedLayout;
+
+struct _SharedLayoutKey
+{
+  PangoContext *context;
+  gchar *text;
+  PangoAttrList *attrs;
+  PangoFontDescription *font_desc;
+
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap_mode;
+  PangoAlignment alignment;
+
+  guint justify          : 1;
+  guint single_line_mode : 1;
+};
+
+struct _SharedLayout
+{
+  SharedLayoutKey key;
+
+  PangoLayout *layout;
+
+  /* the estimated size of the layout */
+  gsize cost;
+
+  /* the link inside shared_layouts_lru */
+  GList *link;
+};
+
+/* the estimated overhead of a layout, and the estimated size of the
+ * line and glyph data for each byte of its text */
+#define SHARED_LAYOUT_BASE_COST         512
+#define SHARED_LAYOUT_BYTE_COST         48
+
+static GHashTable *shared_layouts = NULL;
+static GQueue shared_layouts_lru = G_QUEUE_INIT;
+static gsize shared_layouts_cost = 0;
+
+static gint
+compare_attributes (gconstpointer a,
+                    gconstpointer b)
+{
+  return pango_attribute_equal (a, b) ? 0 : 1;
+}
+
+static gboolean
+attr_list_equal (PangoAttrList *a,
+                 PangoAttrList *b)
+{
+  PangoAttrIterator *iter_a, *iter_b;
+  gboolean retval = TRUE;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  iter_a = pango_attr_list_get_iterator (a);
+  iter_b = pango_attr_list_get_iterator (b);
+
+  while (retval)
+    {
+      gint start_a, end_a, start_b, end_b;
+      GSList *attrs_a, *attrs_b, *l;
+      gboolean has_next_a, has_next_b;
+
+      pango_attr_iterator_range (iter_a, &start_a, &end_a);
+      pango_attr_iterator_range (iter_b, &start_b, &end_b);
+
+      if (start_a != start_b || end_a != end_b)
+        {
+          retval = FALSE;
+          break;
+        }
+
+      attrs_a = pango_attr_iterator_get_attrs (iter_a);
+      attrs_b = pango_attr_iterator_get_attrs (iter_b);
+
+      if (g_slist_length (attrs_a) != g_slist_length (attrs_b))
+        retval = FALSE;
+
+      for (l = attrs_a; retval && l != NULL; l = l->next)
+        {
+          if (g_slist_find_custom (attrs_b, l->data, compare_attributes) == NULL)
+            retval = FALSE;
+        }
+
+      g_slist_free_full (attrs_a, (GDestroyNotify) pango_attribute_destroy);
+      g_slist_free_full (attrs_b, (GDestroyNotify) pango_attribute_destroy);
+
+      has_next_a = pango_attr_iterator_next (iter_a);
+      has_next_b = pango_attr_iterator_next (iter_b);
+
+      if (has_next_a != has_next_b)
+        retval = FALSE;
+      else if (!has_next_a)
+        break;
+    }
+
+  pango_attr_iterator_destroy (iter_a);
+  pango_attr_iterator_destroy (iter_b);
+
+  return retval;
+}
+
+static guint
+shared_layout_key_hash (gconstpointer data)
+{
+  const SharedLayoutKey *key = data;
+  guint hash;
+
+  /* the attributes are only checked for equality */
+  hash = g_str_hash (key->text);
+  hash ^= pango_font_description_hash (key->font_desc);
+  hash ^= g_direct_hash (key->context);
+  hash = hash * 31 + (guint) key->width;
+  hash = hash * 31 + (guint) key->height;
+  hash = hash * 31 + (key->ellipsize << 8 |
+                      key->wrap_mode << 4 |
+                      key->alignment << 2 |
+                      key->justify << 1 |
+                      key->single_line_mode);
+
+  return hash;
+}
+
+static gboolean
+shared_layout_key_equal (gconstpointer a,
+                         gconstpointer b)
+{
+  const SharedLayoutKey *key_a = a;
+  const SharedLayoutKey *key_b = b;
+
+  return key_a->context == key_b->context &&
+         key_a->width == key_b->width &&
+         key_a->height == key_b->height &&
+         key_a->ellipsize == key_b->ellipsize &&
+         key_a->wrap_mode == key_b->wrap_mode &&
+         key_a->alignment == key_b->alignment &&
+         key_a->justify == key_b->justify &&
+         key_a->single_line_mode == key_b->single_line_mode &&
+         strcmp (key_a->text, key_b->text) == 0 &&
+         pango_font_description_equal (key_a->font_desc, key_b->font_desc) &&
+         attr_list_equal (key_a->attrs, key_b->attrs);
+}
+
+static void
+shared_layout_free (gpointer data)
+{
+  SharedLayout *shared = data;
+
+  g_object_unref (shared->key.context);
+  g_free (shared->key.text);
+  if (shared->key.attrs != NULL)
+    pango_attr_list_unref (shared->key.attrs);
+  pango_font_description_free (shared->key.font_desc);
+
+  g_object_unref (shared->layout);
+
+  g_slice_free (SharedLayout, shared);
+}
+
+static void
+shared_layout_cache_clear (void)
+{
+  if (shared_layouts == NULL)
+    return;
+
+  /* the hash table owns the entries */
+  g_queue_clear (&shared_layouts_lru);
+  g_hash_table_remove_all (shared_layouts);
+  shared_layouts_cost = 0;
+}
+
+/* whether the layouts of @self can be shared with other actors; the
+ * layouts of editable actors change too often to be worth sharing,
+ * and they depend on the preedit string
+ */
+static inline gboolean
+clutter_text_can_share_layout (ClutterText *self)
+{
+  return !self->priv->editable &&
+         _clutter_get_text_layout_cache_size () > 0;
+}
+
+static PangoLayout *
+clutter_text_lookup_shared_layout (ClutterText        *self,
+                                   gint                width,
+                                   gint                height,
+                                   PangoEllipsizeMode  ellipsize,
+                                   SharedLayoutKey    *key)
+{
+  ClutterTextPrivate *priv = self->priv;
+  SharedLayout *shared;
+
+  clutter_text_ensure_effective_attributes (self);
+
+  key->context = clutter_actor_get_pango_context (CLUTTER_ACTOR (self));
+  key->text = clutter_text_get_display_text (self);
+  key->attrs = priv->effective_attrs;
+  key->font_desc = priv->font_desc;
+  key->width = width;
+  key->height = height;
+  key->ellipsize = ellipsize;
+  key->wrap_mode = priv->wrap_mode;
+  key->alignment = priv->alignment;
+  key->justify = priv->justify;
+  key->single_line_mode = priv->single_line_mode;
+
+  if (shared_layouts == NULL)
+    return NULL;
+
+  shared = g_hash_table_lookup (shared_layouts, key);
+  if (shared == NULL)
+    return NULL;
+
+  /* move the layout to the head of the LRU list */
+  g_queue_unlink (&shared_layouts_lru, shared->link);
+  g_queue_push_head_link (&shared_layouts_lru, shared->link);
+
+  return shared->layout;
+}
+
+/* takes ownership of the text inside @key */
+static void
+clutter_text_insert_shared_layout (SharedLayoutKey *key,
+                                   PangoLayout     *layout)
+{
+  gsize cache_size = _clutter_get_text_layout_cache_size ();
+  SharedLayout *shared;
+
+  if (shared_layouts == NULL)
+    shared_layouts = g_hash_table_new_full (shared_layout_key_hash,
+                                            shared_layout_key_equal,
+                                            NULL,
+                                            shared_layout_free);
+
+  shared = g_slice_new (SharedLayout);
+  shared->key = *key;
+  shared->key.context = g_object_ref (key->context);
+  shared->key.font_desc = pango_font_description_copy (key->font_desc);
+  if (key->attrs != NULL)
+    shared->key.attrs = pango_attr_list_ref (key->attrs);
+
+  shared->layout = g_object_ref (layout);
+  shared->cost = SHARED_LAYOUT_BASE_COST
+               + strlen (key->text) * SHARED_LAYOUT_BYTE_COST;
+
+  g_queue_push_head (&shared_layouts_lru, shared);
+  shared->link = shared_layouts_lru.head;
+
+  g_hash_table_replace (shared_layouts, &shared->key, shared);
+  shared_layouts_cost += shared->cost;
+
+  /* evict the least recently used layouts; the layouts still used by
+   * an actor will stay alive until the actor drops them */
+  while (shared_layouts_cost > cache_size &&
+         shared_layouts_lru.length > 1)
+    {
+      SharedLayout *oldest = g_queue_pop_tail (&shared_layouts_lru);
+
+      shared_layouts_cost -= oldest->cost;
+      g_hash_table_remove (shared_layouts, &oldest->key);
+    }
+}
+
 /*
  * clutter_text_create_layout:
  * @text: a #ClutterText
@@ -671,6 +955,14 @@ clutter_text_create_layout (ClutterText *text,
                           "Text layout cache miss counter",
                           "Increments for each layout cache miss",
                           0);
+  CLUTTER_STATIC_COUNTER (text_shared_cache_hit_counter,
+                          "Shared text layout cache hit counter",
+                          "Increments for each shared layout cache hit",
+                          0);
+  CLUTTER_STATIC_COUNTER (text_shared_cache_miss_counter,
+                          "Shared text layout cache miss counter",
+                          "Increments for each shared layout cache miss",
+                          0);
 
   /* First determine the width, height, and ellipsize mode that
    * we need for the layout. The ellipsize mode depends on
@@ -823,14 +1115,46 @@ clutter_text_create_layout (ClutterText *text,
   CLUTTER_COUNTER_INC (_clutter_uprof_context, text_cache_miss_counter);
 
   /* If we make it here then we didn't have a cached version so we
-     need to recreate the layout */
+     need to recreate the layout, unless another actor already did */
   if (oldest_cache->layout)
     g_object_unref (oldest_cache->layout);
 
-  oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+  if (clutter_text_can_share_layout (text))
+    {
+      SharedLayoutKey key;
+      PangoLayout *shared;
+
+      shared = clutter_text_lookup_shared_layout (text, width, height,
+                                                  ellipsize,
+                                                  &key);
+      if (shared != NULL)
+        {
+          CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                               text_shared_cache_hit_counter);
+
+          oldest_cache->layout = g_object_ref (shared);
+          g_free (key.text);
+        }
+      else
+        {
+          CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                               text_shared_cache_miss_counter);
+
+          oldest_cache->layout =
+            clutter_text_create_layout_no_cache (text, width, height, ellipsize);
 
-  cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+          cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+
+          clutter_text_insert_shared_layout (&key, oldest_cache->layout);
+        }
+    }
+  else
+    {
+      oldest_cache->layout =
+        clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+
+      cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+    }
 
   /* Mark the 'time' this cache was created and advance the time */
   oldest_cache->age = priv->cache_age++;
@@ -496,6 +496,10 @@ typedef struct
 G_LOCK_DEFINE_STATIC (progress_funcs);
 static GHashTable *progress_funcs = NULL;
 
+/* set when a progress function replaces the default interpolation of
+ * a type, see _clutter_has_custom_progress_functions() */
+static gboolean progress_funcs_custom = FALSE;
+
 gboolean
 _clutter_has_progress_function (GType gtype)
 {
@@ -507,6 +511,24 @@ _clutter_has_progress_function (GType gtype)
   return g_hash_table_lookup (progress_funcs, type_name) != NULL;
 }
 
+/*< private >
+ * _clutter_has_custom_progress_functions:
+ *
+ * Checks whether a progress function has been registered for a
+ * fundamental type, or has replaced or unset the progress function
+ * that Clutter registers for its own types.
+ *
+ * Code interpolating values without going through #ClutterInterval
+ * must not bypass the progress functions if this returns %TRUE.
+ *
+ * Return value: %TRUE if custom progress functions are in use
+ */
+gboolean
+_clutter_has_custom_progress_functions (void)
+{
+  return progress_funcs_custom;
+}
+
 gboolean
 _clutter_run_progress_function (GType gtype,
                                 const GValue *initial,
@@ -610,6 +632,9 @@ clutter_interval_register_progress_func (GType               value_type,
   progress_func =
     g_hash_table_lookup (progress_funcs, type_name);
 
+  if (progress_func != NULL || G_TYPE_IS_FUNDAMENTAL (value_type))
+    progress_funcs_custom = TRUE;
+
   if (G_UNLIKELY (progress_func))
     {
       if (func == NULL)
@@ -65,6 +65,7 @@
 #include "clutter-feature.h"
 #include "clutter-fixed-layout.h"
 #include "clutter-flow-layout.h"
+#include "clutter-frame-timings.h"
 #include "clutter-gesture-action.h"
 #include "clutter-grid-layout.h"
 #include "clutter-image.h"
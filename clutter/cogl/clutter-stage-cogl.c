@@ -42,6 +42,7 @@
 #include "clutter-event.h"
 #include "clutter-enum-types.h"
 #include "clutter-feature.h"
+#include "clutter-frame-timings-private.h"
 #include "clutter-main.h"
 #include "clutter-private.h"
 #include "clutter-profile.h"
@@ -322,6 +323,25 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
     return FALSE;
 }
 
+/* Keeps the number of rectangles of @region inside the budget
+ * returned by _clutter_get_max_redraw_rects(). Each rectangle
+ * requires a separate traversal of the scene graph, so past a
+ * certain number of rectangles it's cheaper to just redraw the
+ * extents of the region.
+ */
+static void
+clutter_stage_cogl_limit_region (cairo_region_t *region)
+{
+  cairo_rectangle_int_t extents;
+
+  if (cairo_region_num_rectangles (region) <=
+      (int) _clutter_get_max_redraw_rects ())
+    return;
+
+  cairo_region_get_extents (region, &extents);
+  cairo_region_union_rectangle (region, &extents);
+}
+
 /* A redraw clip represents (in stage coordinates) the bounding box of
  * something that needs to be redraw. Typically they are added to the
  * StageWindow as a result of clutter_actor_queue_clipped_redraw() by
@@ -331,10 +351,12 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
  * A NULL stage_clip means the whole stage needs to be redrawn.
  *
  * What we do with this information:
- * - we keep track of the bounding box for all redraw clips
- * - when we come to redraw; we scissor the redraw to that box and use
- *   glBlitFramebuffer to present the redraw to the front
- *   buffer.
+ * - we keep track of the region covered by all redraw clips, as
+ *   long as it can be described by a small number of rectangles,
+ *   and of its bounding box
+ * - when we come to redraw; we scissor the redraw to each rectangle
+ *   of the region and use glBlitFramebuffer to present the redraw
+ *   to the front buffer.
  */
 static void
 clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
@@ -363,12 +385,20 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (!stage_cogl->initialized_redraw_clip)
     {
       stage_cogl->bounding_redraw_clip = *stage_clip;
+
+      if (stage_cogl->redraw_region != NULL)
+        cairo_region_destroy (stage_cogl->redraw_region);
+
+      stage_cogl->redraw_region = cairo_region_create_rectangle (stage_clip);
     }
   else if (stage_cogl->bounding_redraw_clip.width > 0)
     {
       _clutter_util_rectangle_union (&stage_cogl->bounding_redraw_clip,
                                      stage_clip,
                                      &stage_cogl->bounding_redraw_clip);
+
+      cairo_region_union_rectangle (stage_cogl->redraw_region, stage_clip);
+      clutter_stage_cogl_limit_region (stage_cogl->redraw_region);
     }
 
   stage_cogl->initialized_redraw_clip = TRUE;
@@ -382,7 +412,7 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
 
   if (stage_cogl->using_clipped_redraw)
     {
-      *stage_clip = stage_cogl->bounding_redraw_clip;
+      *stage_clip = stage_cogl->current_redraw_clip;
 
       return TRUE;
     }
@@ -390,6 +420,63 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
   return FALSE;
 }
 
+static void
+clutter_stage_cogl_draw_redraw_outlines (ClutterStageCogl *stage_cogl,
+                                         cairo_region_t   *region)
+{
+  CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
+  CoglContext *ctx = cogl_framebuffer_get_context (fb);
+  static CoglPipeline *outline = NULL;
+  ClutterActor *actor = CLUTTER_ACTOR (stage_cogl->wrapper);
+  CoglMatrix modelview;
+  int n_rects, i;
+
+  if (outline == NULL)
+    {
+      outline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
+    }
+
+  cogl_framebuffer_push_matrix (fb);
+  cogl_matrix_init_identity (&modelview);
+  _clutter_actor_apply_modelview_transform (actor, &modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+
+  n_rects = cairo_region_num_rectangles (region);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t clip;
+      CoglPrimitive *prim;
+      float x_1, x_2, y_1, y_2;
+
+      cairo_region_get_rectangle (region, i, &clip);
+
+      x_1 = clip.x;
+      x_2 = clip.x + clip.width;
+      y_1 = clip.y;
+      y_2 = clip.y + clip.height;
+
+      {
+        CoglVertexP2 quad[4] = {
+          { x_1, y_1 },
+          { x_2, y_1 },
+          { x_2, y_2 },
+          { x_1, y_2 }
+        };
+
+        prim = cogl_primitive_new_p2 (ctx,
+                                      COGL_VERTICES_MODE_LINE_LOOP,
+                                      4, /* n_vertices */
+                                      quad);
+      }
+
+      cogl_framebuffer_draw_primitive (fb, outline, prim);
+      cogl_object_unref (prim);
+    }
+
+  cogl_framebuffer_pop_matrix (fb);
+}
+
 /* XXX: This is basically identical to clutter_stage_glx_redraw */
 static void
 clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
@@ -400,8 +487,12 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   gboolean can_blit_sub_buffer;
   gboolean has_buffer_age;
   ClutterActor *wrapper;
-  cairo_rectangle_int_t *clip_region;
+  cairo_region_t *clip_region;
+  cairo_rectangle_int_t clip_extents;
+  int *copy_area;
+  int n_rects, i;
   gboolean force_swap;
+  gint64 timings_start;
 
   CLUTTER_STATIC_TIMER (painting_timer,
                         "Redrawing", /* parent */
@@ -431,17 +522,19 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   has_buffer_age = cogl_clutter_winsys_has_feature (COGL_WINSYS_FEATURE_BUFFER_AGE);
 
+  clip_region = NULL;
   may_use_clipped_redraw = FALSE;
   if (_clutter_stage_window_can_clip_redraws (stage_window) &&
       can_blit_sub_buffer &&
       /* NB: a zero width redraw clip == full stage redraw */
       stage_cogl->bounding_redraw_clip.width != 0 &&
+      stage_cogl->redraw_region != NULL &&
       /* some drivers struggle to get going and produce some junk
        * frames when starting up... */
       stage_cogl->frame_count > 3)
     {
       may_use_clipped_redraw = TRUE;
-      clip_region = &stage_cogl->bounding_redraw_clip;
+      clip_region = cairo_region_copy (stage_cogl->redraw_region);
     }
 
   if (may_use_clipped_redraw &&
@@ -458,44 +551,44 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       if (has_buffer_age)
       {
         int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen);
-        cairo_rectangle_int_t *current_damage;
-
-        current_damage = g_new0 (cairo_rectangle_int_t, 1);
-        current_damage->x = clip_region->x;
-        current_damage->y = clip_region->y;
-        current_damage->width = clip_region->width;
-        current_damage->height = clip_region->height;
 
-        stage_cogl->damage_history = g_slist_prepend (stage_cogl->damage_history, current_damage);
+        stage_cogl->damage_history = g_slist_prepend (stage_cogl->damage_history,
+                                                      cairo_region_copy (clip_region));
 
         if (age != 0 && !stage_cogl->dirty_backbuffer && g_slist_length (stage_cogl->damage_history) >= age)
           {
-            int i = 0;
             GSList *tmp = NULL;
+
+            i = 0;
             for (tmp = stage_cogl->damage_history; tmp; tmp = tmp->next)
               {
-                _clutter_util_rectangle_union (clip_region, tmp->data, clip_region);
+                cairo_region_union (clip_region, tmp->data);
                 i++;
                 if (i == age)
                   {
-                    g_slist_free_full (tmp->next, g_free);
+                    g_slist_free_full (tmp->next, (GDestroyNotify) cairo_region_destroy);
                     tmp->next = NULL;
                   }
               }
 
+            clutter_stage_cogl_limit_region (clip_region);
+
             force_swap = TRUE;
 
-            CLUTTER_NOTE (CLIPPING, "Reusing back buffer - repairing region: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
+            cairo_region_get_extents (clip_region, &clip_extents);
+            CLUTTER_NOTE (CLIPPING, "Reusing back buffer - repairing %d rectangles inside: x=%d, y=%d, width=%d, height=%d\n",
+                    cairo_region_num_rectangles (clip_region),
+                    clip_extents.x,
+                    clip_extents.y,
+                    clip_extents.width,
+                    clip_extents.height);
 
           }
         else if (age == 0 || stage_cogl->dirty_backbuffer)
           {
             CLUTTER_NOTE (CLIPPING, "Invalid back buffer: Resetting damage history list.\n");
-            g_slist_free_full (stage_cogl->damage_history, g_free);
+            g_slist_free_full (stage_cogl->damage_history,
+                               (GDestroyNotify) cairo_region_destroy);
             stage_cogl->damage_history = NULL;
           }
 
@@ -504,7 +597,8 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   else
     {
       CLUTTER_NOTE (CLIPPING, "Unclipped redraw: Resetting damage history list.\n");
-      g_slist_free_full (stage_cogl->damage_history, g_free);
+      g_slist_free_full (stage_cogl->damage_history,
+                         (GDestroyNotify) cairo_region_destroy);
       stage_cogl->damage_history = NULL;
     }
 
@@ -513,22 +607,55 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   if (use_clipped_redraw)
     {
-      CLUTTER_NOTE (CLIPPING,
-                    "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
+      if (G_UNLIKELY (CLUTTER_HAS_DEBUG (CLIPPING)))
+        {
+          cairo_rectangle_int_t geom;
+          gint64 n_pixels = 0;
+
+          _clutter_stage_window_get_geometry (stage_window, &geom);
+
+          n_rects = cairo_region_num_rectangles (clip_region);
+          for (i = 0; i < n_rects; i++)
+            {
+              cairo_rectangle_int_t rect;
+
+              cairo_region_get_rectangle (clip_region, i, &rect);
+              n_pixels += (gint64) rect.width * rect.height;
+            }
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Redrawing %d rectangles covering %" G_GINT64_FORMAT
+                        " pixels (%.2f%% of the stage)\n",
+                        n_rects,
+                        n_pixels,
+                        geom.width > 0 && geom.height > 0
+                          ? 100.0 * n_pixels / ((gint64) geom.width * geom.height)
+                          : 0.0);
+        }
 
       stage_cogl->using_clipped_redraw = TRUE;
 
-      cogl_clip_push_window_rectangle (clip_region->x,
-                                       clip_region->y,
-                                       clip_region->width,
-                                       clip_region->height);
-      _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
-                               clip_region);
-      cogl_clip_pop ();
+      n_rects = cairo_region_num_rectangles (clip_region);
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t *clip = &stage_cogl->current_redraw_clip;
+
+          cairo_region_get_rectangle (clip_region, i, clip);
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
+                        clip->x,
+                        clip->y,
+                        clip->width,
+                        clip->height);
+
+          cogl_clip_push_window_rectangle (clip->x,
+                                           clip->y,
+                                           clip->width,
+                                           clip->height);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip);
+          cogl_clip_pop ();
+        }
 
       stage_cogl->using_clipped_redraw = FALSE;
     }
@@ -542,64 +669,46 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
                       CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS) &&
           may_use_clipped_redraw)
         {
-          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
-                                   clip_region);
+          cairo_region_get_extents (clip_region, &clip_extents);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), &clip_extents);
         }
       else
         _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), NULL);
     }
 
+  /* outline each rectangle of the damaged region, so that it's
+   * possible to see how many pixels are actually being redrawn */
   if (may_use_clipped_redraw &&
       G_UNLIKELY ((clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS)))
+    clutter_stage_cogl_draw_redraw_outlines (stage_cogl,
+                                             stage_cogl->redraw_region);
+
+  CLUTTER_TIMER_STOP (_clutter_uprof_context, painting_timer);
+
+  /* collect the rectangles to present */
+  copy_area = NULL;
+  n_rects = 0;
+  if (use_clipped_redraw)
     {
-      CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
-      CoglContext *ctx = cogl_framebuffer_get_context (fb);
-      static CoglPipeline *outline = NULL;
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
-      ClutterActor *actor = CLUTTER_ACTOR (wrapper);
-      float x_1 = clip->x;
-      float x_2 = clip->x + clip->width;
-      float y_1 = clip->y;
-      float y_2 = clip->y + clip->height;
-      CoglVertexP2 quad[4] = {
-        { x_1, y_1 },
-        { x_2, y_1 },
-        { x_2, y_2 },
-        { x_1, y_2 }
-      };
-      CoglPrimitive *prim;
-      CoglMatrix modelview;
+      n_rects = cairo_region_num_rectangles (clip_region);
+      copy_area = g_newa (int, n_rects * 4);
 
-      if (outline == NULL)
+      for (i = 0; i < n_rects; i++)
         {
-          outline = cogl_pipeline_new (ctx);
-          cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
-        }
+          cairo_rectangle_int_t rect;
 
-      prim = cogl_primitive_new_p2 (ctx,
-                                    COGL_VERTICES_MODE_LINE_LOOP,
-                                    4, /* n_vertices */
-                                    quad);
-
-      cogl_framebuffer_push_matrix (fb);
-      cogl_matrix_init_identity (&modelview);
-      _clutter_actor_apply_modelview_transform (actor, &modelview);
-      cogl_framebuffer_set_modelview_matrix (fb, &modelview);
-      cogl_framebuffer_draw_primitive (COGL_FRAMEBUFFER (stage_cogl->onscreen),
-                                       outline,
-                                       prim);
-      cogl_framebuffer_pop_matrix (fb);
-      cogl_object_unref (prim);
-    }
+          cairo_region_get_rectangle (clip_region, i, &rect);
 
-  CLUTTER_TIMER_STOP (_clutter_uprof_context, painting_timer);
+          copy_area[i * 4 + 0] = rect.x;
+          copy_area[i * 4 + 1] = rect.y;
+          copy_area[i * 4 + 2] = rect.width;
+          copy_area[i * 4 + 3] = rect.height;
+        }
+    }
 
   /* push on the screen */
   if (use_clipped_redraw && !force_swap)
     {
-      cairo_rectangle_int_t *clip = clip_region;
-      int copy_area[4];
-
       /* XXX: It seems there will be a race here in that the stage
        * window may be resized before the cogl_onscreen_swap_region
        * is handled and so we may copy the wrong region. I can't
@@ -608,24 +717,20 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
        * the resize anyway so it should only exhibit temporary
        * artefacts.
        */
-
-      copy_area[0] = clip->x;
-      copy_area[1] = clip->y;
-      copy_area[2] = clip->width;
-      copy_area[3] = clip->height;
-
       CLUTTER_NOTE (BACKEND,
                     "cogl_onscreen_swap_region (onscreen: %p, "
-                                                "x: %d, y: %d, "
-                                                "width: %d, height: %d)",
+                                                "n_rectangles: %d)",
                     stage_cogl->onscreen,
-                    copy_area[0], copy_area[1], copy_area[2], copy_area[3]);
+                    n_rects);
 
 
       CLUTTER_TIMER_START (_clutter_uprof_context, blit_sub_buffer_timer);
+      timings_start = _clutter_frame_timings_get_time ();
 
-      cogl_onscreen_swap_region (stage_cogl->onscreen, copy_area, 1);
+      cogl_onscreen_swap_region (stage_cogl->onscreen, copy_area, n_rects);
 
+      _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_SWAP_WAIT,
+                                        timings_start);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, blit_sub_buffer_timer);
     }
   else
@@ -640,10 +745,24 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
         stage_cogl->pending_swaps++;
 
       CLUTTER_TIMER_START (_clutter_uprof_context, swapbuffers_timer);
-      cogl_onscreen_swap_buffers (stage_cogl->onscreen);
+      timings_start = _clutter_frame_timings_get_time ();
+#if COGL_VERSION_CHECK (1, 16, 0)
+      /* when repairing an older back buffer we can tell the compositor
+       * which parts of the buffer actually changed */
+      if (use_clipped_redraw)
+        cogl_onscreen_swap_buffers_with_damage (stage_cogl->onscreen,
+                                                copy_area, n_rects);
+      else
+#endif
+        cogl_onscreen_swap_buffers (stage_cogl->onscreen);
+      _clutter_frame_timings_add_phase (CLUTTER_FRAME_PHASE_SWAP_WAIT,
+                                        timings_start);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, swapbuffers_timer);
     }
 
+  if (clip_region != NULL)
+    cairo_region_destroy (clip_region);
+
   /* reset the redraw clipping for the next paint... */
   stage_cogl->initialized_redraw_clip = FALSE;
 
@@ -682,10 +801,10 @@ clutter_stage_cogl_get_dirty_pixel (ClutterStageWindow *stage_window,
       }
     else
      {
-        cairo_rectangle_int_t *rect;
-        rect = (cairo_rectangle_int_t *) (stage_cogl->damage_history->data);
-        *x = rect->x;
-        *y = rect->y;
+        cairo_rectangle_int_t rect;
+        cairo_region_get_extents (stage_cogl->damage_history->data, &rect);
+        *x = rect.x;
+        *y = rect.y;
      }
 }
 
@@ -736,12 +855,27 @@ clutter_stage_cogl_set_property (GObject      *gobject,
     }
 }
 
+static void
+clutter_stage_cogl_finalize (GObject *gobject)
+{
+  ClutterStageCogl *self = CLUTTER_STAGE_COGL (gobject);
+
+  if (self->redraw_region != NULL)
+    cairo_region_destroy (self->redraw_region);
+
+  g_slist_free_full (self->damage_history,
+                     (GDestroyNotify) cairo_region_destroy);
+
+  G_OBJECT_CLASS (_clutter_stage_cogl_parent_class)->finalize (gobject);
+}
+
 static void
 _clutter_stage_cogl_class_init (ClutterStageCoglClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->set_property = clutter_stage_cogl_set_property;
+  gobject_class->finalize = clutter_stage_cogl_finalize;
 
   g_object_class_override_property (gobject_class, PROP_WRAPPER, "wrapper");
   g_object_class_override_property (gobject_class, PROP_BACKEND, "backend");
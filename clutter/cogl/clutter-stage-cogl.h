@@ -47,17 +47,24 @@ struct _ClutterStageCogl
    * junk frames to start with. */
   unsigned long frame_count;
 
+  /* the region covered by the redraw clips queued since the last
+   * paint, and its extents; a zero width bounding_redraw_clip means
+   * that a full stage redraw has been queued */
+  cairo_region_t *redraw_region;
   cairo_rectangle_int_t bounding_redraw_clip;
 
+  /* the rectangle of the redraw region currently being painted */
+  cairo_rectangle_int_t current_redraw_clip;
+
   guint initialized_redraw_clip : 1;
 
   /* TRUE if the current paint cycle has a clipped redraw. In that
-     case bounding_redraw_clip specifies the the bounds. */
+     case current_redraw_clip specifies the the bounds. */
   guint using_clipped_redraw : 1;
 
   guint dirty_backbuffer     : 1;
 
-  /* Stores a list of previous damaged areas */
+  /* Stores a list of previous damaged regions */
   GSList *damage_history;
 };
 
@@ -26,14 +26,18 @@
 #endif
 
 #include <linux/input.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <glib.h>
+#include <glib-unix.h>
 #include <gudev/gudev.h>
 
 #include "clutter-backend.h"
@@ -60,6 +64,48 @@ G_DEFINE_TYPE (ClutterDeviceManagerEvdev,
                clutter_device_manager_evdev,
                CLUTTER_TYPE_DEVICE_MANAGER);
 
+/* the size of the ring used to pass the events read by the input
+ * thread to the main loop; it must be a power of two
+ */
+#define EVENT_RING_SIZE         1024
+#define EVENT_RING_MASK         (EVENT_RING_SIZE - 1)
+
+/* the maximum number of events read from a device in one go */
+#define MAX_EVENTS_PER_READ     64
+
+typedef struct _ClutterEvdevReader  ClutterEvdevReader;
+typedef struct _EventRing           EventRing;
+typedef struct _EventRingEntry      EventRingEntry;
+
+struct _EventRingEntry
+{
+  ClutterEvdevReader *reader;
+  struct input_event event;
+};
+
+/*
+ * EventRing: single producer, single consumer ring of input events
+ *
+ * The input thread is the only writer of @head, and the main thread is
+ * the only writer of @tail; both are only ever incremented, and the
+ * position inside @entries is obtained by masking them.
+ */
+struct _EventRing
+{
+  EventRingEntry entries[EVENT_RING_SIZE];
+
+  volatile gint head;
+  volatile gint tail;
+
+  /* set by the main thread when it ran out of events to process, and
+   * needs to be woken up through the wakeup pipe */
+  volatile gint needs_wakeup;
+
+  /* set by the input thread when the ring is full, and it needs to be
+   * woken up through the control pipe once there is space again */
+  volatile gint needs_space;
+};
+
 struct _ClutterDeviceManagerEvdevPrivate
 {
   GUdevClient *udev_client;
@@ -68,7 +114,21 @@ struct _ClutterDeviceManagerEvdevPrivate
   gboolean released;
 
   GSList *devices;          /* list of ClutterInputDeviceEvdevs */
-  GSList *event_sources;    /* list of the event sources */
+
+  /* list of ClutterEvdevReaders; only modified by the main thread,
+   * while holding readers_lock */
+  GSList *readers;
+  GMutex readers_lock;
+
+  /* the thread reading the input devices */
+  GThread *input_thread;
+  volatile gint quit_input_thread;
+  gint control_pipe[2];     /* wakes up the input thread */
+
+  /* the events read by the input thread */
+  EventRing *ring;
+  gint wakeup_pipe[2];      /* wakes up the main loop */
+  GSource *event_source;
 
   ClutterInputDevice *core_pointer;
   ClutterInputDevice *core_keyboard;
@@ -81,24 +141,47 @@ struct _ClutterDeviceManagerEvdevPrivate
 static const gchar *subsystems[] = { "input", NULL };
 
 /*
- * ClutterEventSource management
+ * Input devices handling
  *
- * The device manager is responsible for managing the GSource when devices
- * appear and disappear from the system.
+ * A dedicated input thread polls all the input devices at once, and
+ * copies the raw evdev events into a lock-free ring, without touching
+ * any other state. The main loop is woken up only when the ring goes
+ * from empty to non-empty, and translates all the pending evdev events
+ * into ClutterEvents in one go; the translation needs the XKB state,
+ * the stages and the event queue, so it stays on the main thread.
  *
- * FIXME: For now, we associate a GSource with every single device. Starting
- * from glib 2.28 we can use g_source_add_child_source() to have a single
- * GSource for the device manager, each device becoming a child source. Revisit
- * this once we depend on glib >= 2.28.
+ * Each device has a ClutterEvdevReader, holding the file descriptor and
+ * the state used when translating its events. The readers are created
+ * and destroyed by the main thread; the input thread only reads from
+ * the file descriptor of a reader while holding the readers lock, and
+ * after checking that the reader is still in the list, so a reader can
+ * be freed once it has been removed from the list and the ring has been
+ * drained.
  */
 
-
 static const char *option_xkb_layout = "us";
 static const char *option_xkb_variant = "";
 static const char *option_xkb_options = "";
 
+struct _ClutterEvdevReader
+{
+  ClutterInputDeviceEvdev *device;    /* back pointer to the evdev device */
+  gint fd;                            /* file descriptor of the /dev node */
+  volatile gint failed;               /* set by the input thread on errors */
+  gboolean monotonic_clock;           /* whether the events use CLOCK_MONOTONIC */
+
+  struct xkb_state *xkb;              /* XKB state object */
+  gint x, y;                          /* last x, y position for pointers */
+  guint32 modifier_state;             /* key modifiers */
+
+  /* EV_REL events are compressed until the next EV_SYN */
+  gint dx, dy;
+  guint32 motion_time;
+  gint64 motion_hardware_time;
+};
+
 /*
- * ClutterEventSource for reading input devices
+ * ClutterEventSource: the main loop side of the input thread
  */
 
 typedef struct _ClutterEventSource  ClutterEventSource;
@@ -107,23 +190,235 @@ struct _ClutterEventSource
 {
   GSource source;
 
-  ClutterInputDeviceEvdev *device;    /* back pointer to the evdev device */
-  GPollFD event_poll_fd;              /* file descriptor of the /dev node */
-  struct xkb_state *xkb;              /* XKB state object */
-  gint x, y;                          /* last x, y position for pointers */
-  guint32 modifier_state;             /* key modifiers */
+  ClutterDeviceManagerEvdev *manager_evdev;
+  GPollFD event_poll_fd;              /* read end of the wakeup pipe */
 };
 
+static void
+wakeup_pipe_write (gint fd)
+{
+  const gchar byte = 0;
+  gssize res;
+
+  do
+    res = write (fd, &byte, 1);
+  while (res < 0 && errno == EINTR);
+
+  /* if the pipe is full there is already a wakeup pending */
+}
+
+static void
+wakeup_pipe_drain (gint fd)
+{
+  gchar buffer[64];
+  gssize res;
+
+  do
+    res = read (fd, buffer, sizeof (buffer));
+  while (res > 0 || (res < 0 && errno == EINTR));
+}
+
+static inline gboolean
+event_ring_is_empty (EventRing *ring)
+{
+  return g_atomic_int_get (&ring->head) == g_atomic_int_get (&ring->tail);
+}
+
+/* called by the input thread */
+static inline guint
+event_ring_get_space (EventRing *ring)
+{
+  guint head = ring->head;
+  guint tail = g_atomic_int_get (&ring->tail);
+
+  return EVENT_RING_SIZE - (head - tail);
+}
+
+/* called by the input thread; the caller must have checked that
+ * there is enough space for @n_events events */
+static void
+event_ring_push (EventRing                *ring,
+                 ClutterEvdevReader       *reader,
+                 const struct input_event *events,
+                 guint                     n_events)
+{
+  guint head = ring->head;
+  guint i;
+
+  for (i = 0; i < n_events; i++)
+    {
+      EventRingEntry *entry = &ring->entries[(head + i) & EVENT_RING_MASK];
+
+      entry->reader = reader;
+      entry->event = events[i];
+    }
+
+  /* this is a full barrier, so the entries are visible to the main
+   * thread before the new head */
+  g_atomic_int_set (&ring->head, head + n_events);
+}
+
+static gboolean
+input_thread_is_reader (ClutterDeviceManagerEvdevPrivate *priv,
+                        ClutterEvdevReader               *reader)
+{
+  return g_slist_find (priv->readers, reader) != NULL;
+}
+
+/* called by the input thread, with the readers lock held; returns
+ * whether any event was pushed into the ring */
+static gboolean
+input_thread_read_device (ClutterDeviceManagerEvdevPrivate *priv,
+                          ClutterEvdevReader               *reader)
+{
+  struct input_event events[MAX_EVENTS_PER_READ];
+  gboolean retval = FALSE;
+
+  while (TRUE)
+    {
+      guint space, n_events;
+      gssize len;
+
+      space = event_ring_get_space (priv->ring);
+      if (space == 0)
+        break;
+
+      /* never read more events than the ring can hold, so that we
+       * don't have to drop any of them */
+      n_events = MIN (space, MAX_EVENTS_PER_READ);
+
+      len = read (reader->fd, events, n_events * sizeof (struct input_event));
+      if (len < 0 && errno == EINTR)
+        continue;
+
+      if (len < 0 || len % sizeof (struct input_event) != 0)
+        {
+          if (len >= 0 || errno != EAGAIN)
+            g_atomic_int_set (&reader->failed, TRUE);
+
+          break;
+        }
+
+      if (len == 0)
+        break;
+
+      event_ring_push (priv->ring, reader,
+                       events,
+                       len / sizeof (struct input_event));
+      retval = TRUE;
+    }
+
+  return retval;
+}
+
+static gpointer
+input_thread_func (gpointer data)
+{
+  ClutterDeviceManagerEvdevPrivate *priv = data;
+  GArray *poll_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
+  GPtrArray *poll_readers = g_ptr_array_new ();
+
+  while (!g_atomic_int_get (&priv->quit_input_thread))
+    {
+      struct pollfd pfd;
+      gboolean ring_full, wakeup;
+      GSList *l;
+      guint i;
+
+      g_array_set_size (poll_fds, 0);
+      g_ptr_array_set_size (poll_readers, 0);
+
+      pfd.fd = priv->control_pipe[0];
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      g_array_append_val (poll_fds, pfd);
+
+      /* if the ring is full we leave the events inside the kernel
+       * queues until the main thread wakes us up */
+      g_atomic_int_set (&priv->ring->needs_space, TRUE);
+      ring_full = event_ring_get_space (priv->ring) == 0;
+      if (!ring_full)
+        g_atomic_int_set (&priv->ring->needs_space, FALSE);
+
+      g_mutex_lock (&priv->readers_lock);
+
+      for (l = priv->readers; l != NULL && !ring_full; l = l->next)
+        {
+          ClutterEvdevReader *reader = l->data;
+
+          if (g_atomic_int_get (&reader->failed))
+            continue;
+
+          pfd.fd = reader->fd;
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          g_array_append_val (poll_fds, pfd);
+          g_ptr_array_add (poll_readers, reader);
+        }
+
+      g_mutex_unlock (&priv->readers_lock);
+
+      if (poll ((struct pollfd *) poll_fds->data, poll_fds->len, -1) < 0)
+        {
+          if (errno != EINTR)
+            g_critical ("Unable to poll the input devices: %s",
+                        g_strerror (errno));
+
+          continue;
+        }
+
+      if (g_array_index (poll_fds, struct pollfd, 0).revents != 0)
+        wakeup_pipe_drain (priv->control_pipe[0]);
+
+      wakeup = FALSE;
+
+      g_mutex_lock (&priv->readers_lock);
+
+      for (i = 1; i < poll_fds->len; i++)
+        {
+          ClutterEvdevReader *reader = g_ptr_array_index (poll_readers, i - 1);
+
+          if (g_array_index (poll_fds, struct pollfd, i).revents == 0)
+            continue;
+
+          /* the reader might have been removed while we were polling */
+          if (!input_thread_is_reader (priv, reader))
+            continue;
+
+          if (input_thread_read_device (priv, reader))
+            wakeup = TRUE;
+
+          if (g_atomic_int_get (&reader->failed))
+            wakeup = TRUE;
+        }
+
+      g_mutex_unlock (&priv->readers_lock);
+
+      /* wake up the main loop only if it ran out of events */
+      if (wakeup &&
+          g_atomic_int_compare_and_exchange (&priv->ring->needs_wakeup,
+                                             TRUE, FALSE))
+        wakeup_pipe_write (priv->wakeup_pipe[1]);
+    }
+
+  g_array_free (poll_fds, TRUE);
+  g_ptr_array_free (poll_readers, TRUE);
+
+  return NULL;
+}
+
 static gboolean
 clutter_event_prepare (GSource *source,
                        gint    *timeout)
 {
+  ClutterEventSource *event_source = (ClutterEventSource *) source;
   gboolean retval;
 
   _clutter_threads_acquire_lock ();
 
   *timeout = -1;
-  retval = clutter_events_pending ();
+  retval = (clutter_events_pending () ||
+            !event_ring_is_empty (event_source->manager_evdev->priv->ring));
 
   _clutter_threads_release_lock ();
 
@@ -139,7 +434,8 @@ clutter_event_check (GSource *source)
   _clutter_threads_acquire_lock ();
 
   retval = ((event_source->event_poll_fd.revents & G_IO_IN) ||
-            clutter_events_pending ());
+            clutter_events_pending () ||
+            !event_ring_is_empty (event_source->manager_evdev->priv->ring));
 
   _clutter_threads_release_lock ();
 
@@ -147,21 +443,26 @@ clutter_event_check (GSource *source)
 }
 
 static void
-queue_event (ClutterEvent *event)
+queue_event (ClutterEvent *event,
+             gint64        hardware_time)
 {
   if (event == NULL)
     return;
 
+  if (hardware_time != 0)
+    _clutter_event_set_hardware_time (event, hardware_time);
+
   _clutter_event_push (event, FALSE);
 }
 
 static void
-notify_key (ClutterEventSource *source,
+notify_key (ClutterEvdevReader *reader,
             guint32             time_,
+            gint64              hardware_time,
             guint32             key,
             guint32             state)
 {
-  ClutterInputDevice *input_device = (ClutterInputDevice *) source->device;
+  ClutterInputDevice *input_device = (ClutterInputDevice *) reader->device;
   ClutterStage *stage;
   ClutterEvent *event = NULL;
 
@@ -172,27 +473,28 @@ notify_key (ClutterEventSource *source,
     return;
 
   /* if we have a mapping for that device, use it to generate the event */
-  if (source->xkb)
+  if (reader->xkb)
   {
     event =
       _clutter_key_event_new_from_evdev (input_device,
                                          stage,
-                                         source->xkb,
+                                         reader->xkb,
                                          time_, key, state);
-    xkb_state_update_key (source->xkb, key, state ? XKB_KEY_DOWN : XKB_KEY_UP);
+    xkb_state_update_key (reader->xkb, key, state ? XKB_KEY_DOWN : XKB_KEY_UP);
   }
 
-  queue_event (event);
+  queue_event (event, hardware_time);
 }
 
 
 static void
-notify_motion (ClutterEventSource *source,
+notify_motion (ClutterEvdevReader *reader,
                guint32             time_,
+               gint64              hardware_time,
                gint                x,
                gint                y)
 {
-  ClutterInputDevice *input_device = (ClutterInputDevice *) source->device;
+  ClutterInputDevice *input_device = (ClutterInputDevice *) reader->device;
   gfloat stage_width, stage_height, new_x, new_y;
   ClutterEvent *event;
   ClutterStage *stage;
@@ -222,26 +524,27 @@ notify_motion (ClutterEventSource *source,
   else
     new_y = y;
 
-  source->x = new_x;
-  source->y = new_y;
+  reader->x = new_x;
+  reader->y = new_y;
 
   event->motion.time = time_;
   event->motion.stage = stage;
   event->motion.device = input_device;
-  event->motion.modifier_state = source->modifier_state;
+  event->motion.modifier_state = reader->modifier_state;
   event->motion.x = new_x;
   event->motion.y = new_y;
 
-  queue_event (event);
+  queue_event (event, hardware_time);
 }
 
 static void
-notify_button (ClutterEventSource *source,
+notify_button (ClutterEvdevReader *reader,
                guint32             time_,
+               gint64              hardware_time,
                guint32             button,
                guint32             state)
 {
-  ClutterInputDevice *input_device = (ClutterInputDevice *) source->device;
+  ClutterInputDevice *input_device = (ClutterInputDevice *) reader->device;
   ClutterEvent *event;
   ClutterStage *stage;
   gint button_nr;
@@ -292,19 +595,164 @@ notify_button (ClutterEventSource *source,
 
   /* Update the modifiers */
   if (state)
-    source->modifier_state |= maskmap[button - BTN_LEFT];
+    reader->modifier_state |= maskmap[button - BTN_LEFT];
   else
-    source->modifier_state &= ~maskmap[button - BTN_LEFT];
+    reader->modifier_state &= ~maskmap[button - BTN_LEFT];
 
   event->button.time = time_;
   event->button.stage = CLUTTER_STAGE (stage);
-  event->button.device = (ClutterInputDevice *) source->device;
-  event->button.modifier_state = source->modifier_state;
+  event->button.device = (ClutterInputDevice *) reader->device;
+  event->button.modifier_state = reader->modifier_state;
   event->button.button = button_nr;
-  event->button.x = source->x;
-  event->button.y = source->y;
+  event->button.x = reader->x;
+  event->button.y = reader->y;
+
+  queue_event (event, hardware_time);
+}
+
+static void
+flush_motion (ClutterEvdevReader *reader)
+{
+  if (reader->dx == 0 && reader->dy == 0)
+    return;
+
+  notify_motion (reader,
+                 reader->motion_time,
+                 reader->motion_hardware_time,
+                 reader->x + reader->dx,
+                 reader->y + reader->dy);
+
+  reader->dx = reader->dy = 0;
+}
+
+static void
+process_evdev_event (ClutterEvdevReader       *reader,
+                     const struct input_event *e)
+{
+  guint32 time_;
+  gint64 hardware_time = 0;
+
+  time_ = e->time.tv_sec * 1000 + e->time.tv_usec / 1000;
+
+  /* the timestamps of the kernel can be compared with the monotonic
+   * clock only if we managed to switch the device to it */
+  if (reader->monotonic_clock)
+    hardware_time = (gint64) e->time.tv_sec * G_USEC_PER_SEC + e->time.tv_usec;
+
+  switch (e->type)
+    {
+    case EV_KEY:
+
+      /* don't repeat mouse buttons */
+      if (e->code >= BTN_MOUSE && e->code < KEY_OK)
+        if (e->value == 2)
+          return;
+
+      switch (e->code)
+        {
+        case BTN_TOUCH:
+        case BTN_TOOL_PEN:
+        case BTN_TOOL_RUBBER:
+        case BTN_TOOL_BRUSH:
+        case BTN_TOOL_PENCIL:
+        case BTN_TOOL_AIRBRUSH:
+        case BTN_TOOL_FINGER:
+        case BTN_TOOL_MOUSE:
+        case BTN_TOOL_LENS:
+          break;
+
+        case BTN_LEFT:
+        case BTN_RIGHT:
+        case BTN_MIDDLE:
+        case BTN_SIDE:
+        case BTN_EXTRA:
+        case BTN_FORWARD:
+        case BTN_BACK:
+        case BTN_TASK:
+          notify_button (reader, time_, hardware_time, e->code, e->value);
+          break;
+
+        default:
+          notify_key (reader, time_, hardware_time, e->code, e->value);
+          break;
+        }
+      break;
+
+    case EV_SYN:
+      if (e->code == SYN_REPORT)
+        flush_motion (reader);
+      break;
+
+    case EV_MSC:
+      /* Nothing to do here? */
+      break;
+
+    case EV_REL:
+      /* compress the EV_REL events in dx/dy */
+      switch (e->code)
+        {
+        case REL_X:
+          reader->dx += e->value;
+          break;
+        case REL_Y:
+          reader->dy += e->value;
+          break;
+        }
+
+      reader->motion_time = time_;
+      reader->motion_hardware_time = hardware_time;
+      break;
+
+    case EV_ABS:
+    default:
+      g_warning ("Unhandled event of type %d", e->type);
+      break;
+    }
+}
+
+/* translates all the events inside the ring; called by the main
+ * thread, with the Clutter lock held */
+static void
+clutter_device_manager_evdev_drain_ring (ClutterDeviceManagerEvdev *manager_evdev)
+{
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+  EventRing *ring = priv->ring;
+  guint head, tail;
+  GSList *l;
+
+  tail = ring->tail;
+
+  while (TRUE)
+    {
+      head = g_atomic_int_get (&ring->head);
+
+      if (head == tail)
+        {
+          /* tell the input thread to wake us up, and check again in
+           * case it pushed new events before seeing the flag */
+          g_atomic_int_set (&ring->needs_wakeup, TRUE);
+
+          head = g_atomic_int_get (&ring->head);
+          if (head == tail)
+            break;
+        }
+
+      for (; tail != head; tail++)
+        {
+          EventRingEntry *entry = &ring->entries[tail & EVENT_RING_MASK];
+
+          process_evdev_event (entry->reader, &entry->event);
+        }
+
+      g_atomic_int_set (&ring->tail, tail);
+
+      if (g_atomic_int_compare_and_exchange (&ring->needs_space, TRUE, FALSE))
+        wakeup_pipe_write (priv->control_pipe[1]);
+    }
 
-  queue_event (event);
+  /* a device might not have sent its EV_SYN yet */
+  for (l = priv->readers; l != NULL; l = l->next)
+    flush_motion (l->data);
 }
 
 static gboolean
@@ -313,131 +761,39 @@ clutter_event_dispatch (GSource     *g_source,
                         gpointer     user_data)
 {
   ClutterEventSource *source = (ClutterEventSource *) g_source;
-  ClutterInputDevice *input_device = (ClutterInputDevice *) source->device;
-  struct input_event ev[8];
+  ClutterDeviceManagerEvdev *manager_evdev = source->manager_evdev;
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
   ClutterEvent *event;
-  gint len, i, dx = 0, dy = 0;
-  uint32_t _time;
-  ClutterStage *stage;
+  GSList *l, *next;
 
   _clutter_threads_acquire_lock ();
 
-  stage = _clutter_input_device_get_stage (input_device);
+  if (source->event_poll_fd.revents & G_IO_IN)
+    wakeup_pipe_drain (source->event_poll_fd.fd);
 
-  /* Don't queue more events if we haven't finished handling the previous batch
-   */
-  if (!clutter_events_pending ())
+  clutter_device_manager_evdev_drain_ring (manager_evdev);
+
+  /* remove the devices the input thread could not read */
+  for (l = priv->readers; l != NULL; l = next)
     {
-       len = read (source->event_poll_fd.fd, &ev, sizeof (ev));
-       if (len < 0 || len % sizeof (ev[0]) != 0)
-       {
-         if (errno != EAGAIN)
-           {
-             ClutterDeviceManager *manager;
-             ClutterInputDevice *device;
-             const gchar *device_path;
-
-             device = CLUTTER_INPUT_DEVICE (source->device);
-
-             if (CLUTTER_HAS_DEBUG (EVENT))
-               {
-                 device_path =
-                   _clutter_input_device_evdev_get_device_path (source->device);
-
-                 CLUTTER_NOTE (EVENT, "Could not read device (%s), removing.",
-                               device_path);
-               }
-
-             /* remove the faulty device */
-             manager = clutter_device_manager_get_default ();
-             _clutter_device_manager_remove_device (manager, device);
-
-           }
-         goto out;
-       }
-
-       /* Drop events if we don't have any stage to forward them to */
-       if (!stage)
-         goto out;
-
-       for (i = 0; i < len / sizeof (ev[0]); i++)
-         {
-           struct input_event *e = &ev[i];
-
-           _time = e->time.tv_sec * 1000 + e->time.tv_usec / 1000;
-           event = NULL;
-
-           switch (e->type)
-             {
-             case EV_KEY:
-
-               /* don't repeat mouse buttons */
-               if (e->code >= BTN_MOUSE && e->code < KEY_OK)
-                 if (e->value == 2)
-                   continue;
-
-               switch (e->code)
-                 {
-                 case BTN_TOUCH:
-                 case BTN_TOOL_PEN:
-                 case BTN_TOOL_RUBBER:
-                 case BTN_TOOL_BRUSH:
-                 case BTN_TOOL_PENCIL:
-                 case BTN_TOOL_AIRBRUSH:
-                 case BTN_TOOL_FINGER:
-                 case BTN_TOOL_MOUSE:
-                 case BTN_TOOL_LENS:
-                   break;
-
-                 case BTN_LEFT:
-                 case BTN_RIGHT:
-                 case BTN_MIDDLE:
-                 case BTN_SIDE:
-                 case BTN_EXTRA:
-                 case BTN_FORWARD:
-                 case BTN_BACK:
-                 case BTN_TASK:
-                   notify_button(source, _time, e->code, e->value);
-                   break;
-
-                 default:
-                   notify_key (source, _time, e->code, e->value);
-                 break;
-                 }
-               break;
-
-             case EV_SYN:
-               /* Nothing to do here? */
-               break;
-
-             case EV_MSC:
-               /* Nothing to do here? */
-               break;
-
-             case EV_REL:
-               /* compress the EV_REL events in dx/dy */
-               switch (e->code)
-                 {
-                 case REL_X:
-                   dx += e->value;
-                   break;
-                 case REL_Y:
-                   dy += e->value;
-                   break;
-                 }
-               break;
-
-             case EV_ABS:
-             default:
-               g_warning ("Unhandled event of type %d", e->type);
-               break;
-             }
-
-           queue_event (event);
-         }
-
-       if (dx != 0 || dy != 0)
-         notify_motion (source, _time, source->x + dx, source->y + dy);
+      ClutterEvdevReader *reader = l->data;
+
+      next = l->next;
+
+      if (g_atomic_int_get (&reader->failed))
+        {
+          ClutterDeviceManager *manager;
+          ClutterInputDevice *device;
+
+          device = CLUTTER_INPUT_DEVICE (reader->device);
+
+          CLUTTER_NOTE (EVENT, "Could not read device (%s), removing.",
+                        _clutter_input_device_evdev_get_device_path (reader->device));
+
+          /* remove the faulty device */
+          manager = CLUTTER_DEVICE_MANAGER (manager_evdev);
+          _clutter_device_manager_remove_device (manager, device);
+        }
     }
 
   /* Pop an event off the queue if any */
@@ -446,11 +802,9 @@ clutter_event_dispatch (GSource     *g_source,
   if (event)
     {
       /* forward the event into clutter for emission etc. */
-      clutter_do_event (event);
-      clutter_event_free (event);
+      _clutter_do_event_take (event);
     }
 
-out:
   _clutter_threads_release_lock ();
 
   return TRUE;
@@ -463,10 +817,27 @@ static GSourceFuncs event_funcs = {
 };
 
 static GSource *
-clutter_event_source_new (ClutterInputDeviceEvdev *input_device)
+clutter_event_source_new (ClutterDeviceManagerEvdev *manager_evdev)
 {
   GSource *source = g_source_new (&event_funcs, sizeof (ClutterEventSource));
   ClutterEventSource *event_source = (ClutterEventSource *) source;
+
+  event_source->manager_evdev = manager_evdev;
+  event_source->event_poll_fd.fd = manager_evdev->priv->wakeup_pipe[0];
+  event_source->event_poll_fd.events = G_IO_IN;
+
+  g_source_set_priority (source, CLUTTER_PRIORITY_EVENTS);
+  g_source_add_poll (source, &event_source->event_poll_fd);
+  g_source_set_can_recurse (source, TRUE);
+  g_source_attach (source, NULL);
+
+  return source;
+}
+
+static ClutterEvdevReader *
+clutter_evdev_reader_new (ClutterInputDeviceEvdev *input_device)
+{
+  ClutterEvdevReader *reader;
   ClutterInputDeviceType type;
   const gchar *node_path;
   gint fd;
@@ -474,7 +845,7 @@ clutter_event_source_new (ClutterInputDeviceEvdev *input_device)
   /* grab the udev input device node and open it */
   node_path = _clutter_input_device_evdev_get_device_path (input_device);
 
-  CLUTTER_NOTE (EVENT, "Creating GSource for device %s", node_path);
+  CLUTTER_NOTE (EVENT, "Creating reader for device %s", node_path);
 
   fd = open (node_path, O_RDONLY | O_NONBLOCK);
   if (fd < 0)
@@ -483,10 +854,19 @@ clutter_event_source_new (ClutterInputDeviceEvdev *input_device)
       return NULL;
     }
 
-  /* setup the source */
-  event_source->device = input_device;
-  event_source->event_poll_fd.fd = fd;
-  event_source->event_poll_fd.events = G_IO_IN;
+  reader = g_slice_new0 (ClutterEvdevReader);
+  reader->device = input_device;
+  reader->fd = fd;
+
+#ifdef EVIOCSCLOCKID
+  {
+    gint clock_id = CLOCK_MONOTONIC;
+
+    /* use the same clock as g_get_monotonic_time(), so that we can
+     * measure the latency of the events */
+    reader->monotonic_clock = ioctl (fd, EVIOCSCLOCKID, &clock_id) == 0;
+  }
+#endif
 
   type =
     clutter_input_device_get_device_type (CLUTTER_INPUT_DEVICE (input_device));
@@ -494,65 +874,55 @@ clutter_event_source_new (ClutterInputDeviceEvdev *input_device)
   if (type == CLUTTER_KEYBOARD_DEVICE)
     {
       /* create the xkb description */
-      event_source->xkb = _clutter_xkb_state_new (NULL,
-                                                  option_xkb_layout,
-                                                  option_xkb_variant,
-                                                  option_xkb_options);
-      if (G_UNLIKELY (event_source->xkb == NULL))
+      reader->xkb = _clutter_xkb_state_new (NULL,
+                                            option_xkb_layout,
+                                            option_xkb_variant,
+                                            option_xkb_options);
+      if (G_UNLIKELY (reader->xkb == NULL))
         {
           g_warning ("Could not compile keymap %s:%s:%s", option_xkb_layout,
                      option_xkb_variant, option_xkb_options);
           close (fd);
-          g_source_unref (source);
+          g_slice_free (ClutterEvdevReader, reader);
           return NULL;
         }
     }
-  else if (type == CLUTTER_POINTER_DEVICE)
-    {
-      event_source->x = 0;
-      event_source->y = 0;
-    }
-
-  /* and finally configure and attach the GSource */
-  g_source_set_priority (source, CLUTTER_PRIORITY_EVENTS);
-  g_source_add_poll (source, &event_source->event_poll_fd);
-  g_source_set_can_recurse (source, TRUE);
-  g_source_attach (source, NULL);
 
-  return source;
+  return reader;
 }
 
 static void
-clutter_event_source_free (ClutterEventSource *source)
+clutter_evdev_reader_free (ClutterEvdevReader *reader)
 {
-  GSource *g_source = (GSource *) source;
   const gchar *node_path;
 
-  node_path = _clutter_input_device_evdev_get_device_path (source->device);
+  node_path = _clutter_input_device_evdev_get_device_path (reader->device);
 
-  CLUTTER_NOTE (EVENT, "Removing GSource for device %s", node_path);
+  CLUTTER_NOTE (EVENT, "Removing reader for device %s", node_path);
 
   /* ignore the return value of close, it's not like we can do something
    * about it */
-  close (source->event_poll_fd.fd);
+  close (reader->fd);
 
-  g_source_destroy (g_source);
-  g_source_unref (g_source);
+  if (reader->xkb != NULL)
+    xkb_state_unref (reader->xkb);
+
+  g_slice_free (ClutterEvdevReader, reader);
 }
 
-static ClutterEventSource *
-find_source_by_device (ClutterDeviceManagerEvdev *manager,
+static ClutterEvdevReader *
+find_reader_by_device (ClutterDeviceManagerEvdev *manager,
                        ClutterInputDevice        *device)
 {
   ClutterDeviceManagerEvdevPrivate *priv = manager->priv;
   GSList *l;
 
-  for (l = priv->event_sources; l; l = g_slist_next (l))
+  for (l = priv->readers; l; l = g_slist_next (l))
     {
-      ClutterEventSource *source = l->data;
+      ClutterEvdevReader *reader = l->data;
 
-      if (source->device == (ClutterInputDeviceEvdev *) device)
-        return source;
+      if (reader->device == (ClutterInputDeviceEvdev *) device)
+        return reader;
     }
 
   return NULL;
@@ -704,7 +1074,7 @@ clutter_device_manager_evdev_add_device (ClutterDeviceManager *manager,
   ClutterInputDeviceType device_type;
   ClutterInputDeviceEvdev *device_evdev;
   gboolean is_pointer, is_keyboard;
-  GSource *source;
+  ClutterEvdevReader *reader;
 
   manager_evdev = CLUTTER_DEVICE_MANAGER_EVDEV (manager);
   priv = manager_evdev->priv;
@@ -723,10 +1093,16 @@ clutter_device_manager_evdev_add_device (ClutterDeviceManager *manager,
   if (is_keyboard && priv->core_keyboard == NULL)
     priv->core_keyboard = device;
 
-  /* Install the GSource for this device */
-  source = clutter_event_source_new (device_evdev);
-  if (G_LIKELY (source))
-    priv->event_sources = g_slist_prepend (priv->event_sources, source);
+  /* Hand the device over to the input thread */
+  reader = clutter_evdev_reader_new (device_evdev);
+  if (G_LIKELY (reader))
+    {
+      g_mutex_lock (&priv->readers_lock);
+      priv->readers = g_slist_prepend (priv->readers, reader);
+      g_mutex_unlock (&priv->readers_lock);
+
+      wakeup_pipe_write (priv->control_pipe[1]);
+    }
 }
 
 static void
@@ -735,7 +1111,7 @@ clutter_device_manager_evdev_remove_device (ClutterDeviceManager *manager,
 {
   ClutterDeviceManagerEvdev *manager_evdev;
   ClutterDeviceManagerEvdevPrivate *priv;
-  ClutterEventSource *source;
+  ClutterEvdevReader *reader;
 
   manager_evdev = CLUTTER_DEVICE_MANAGER_EVDEV (manager);
   priv = manager_evdev->priv;
@@ -743,16 +1119,28 @@ clutter_device_manager_evdev_remove_device (ClutterDeviceManager *manager,
   /* Remove the device */
   priv->devices = g_slist_remove (priv->devices, device);
 
-  /* Remove the source */
-  source = find_source_by_device (manager_evdev, device);
-  if (G_UNLIKELY (source == NULL))
+  /* Remove the reader */
+  reader = find_reader_by_device (manager_evdev, device);
+  if (G_UNLIKELY (reader == NULL))
     {
-      g_warning ("Trying to remove a device without a source installed ?!");
+      g_warning ("Trying to remove a device without a reader installed ?!");
       return;
     }
 
-  clutter_event_source_free (source);
-  priv->event_sources = g_slist_remove (priv->event_sources, source);
+  /* once the reader is out of the list the input thread will not
+   * read from it anymore, so after translating the events that are
+   * still inside the ring we can safely free it */
+  g_mutex_lock (&priv->readers_lock);
+  priv->readers = g_slist_remove (priv->readers, reader);
+  g_mutex_unlock (&priv->readers_lock);
+
+  /* stop the input thread from polling the file descriptor we are
+   * about to close */
+  wakeup_pipe_write (priv->control_pipe[1]);
+
+  clutter_device_manager_evdev_drain_ring (manager_evdev);
+
+  clutter_evdev_reader_free (reader);
 }
 
 static const GSList *
@@ -841,6 +1229,24 @@ clutter_device_manager_evdev_constructed (GObject *gobject)
 
   priv->udev_client = g_udev_client_new (subsystems);
 
+  if (!g_unix_open_pipe (priv->control_pipe, FD_CLOEXEC, NULL) ||
+      !g_unix_open_pipe (priv->wakeup_pipe, FD_CLOEXEC, NULL))
+    g_error ("Unable to create the pipes for the input thread: %s",
+             g_strerror (errno));
+
+  g_unix_set_fd_nonblocking (priv->control_pipe[0], TRUE, NULL);
+  g_unix_set_fd_nonblocking (priv->control_pipe[1], TRUE, NULL);
+  g_unix_set_fd_nonblocking (priv->wakeup_pipe[0], TRUE, NULL);
+  g_unix_set_fd_nonblocking (priv->wakeup_pipe[1], TRUE, NULL);
+
+  priv->ring = g_new0 (EventRing, 1);
+  priv->ring->needs_wakeup = TRUE;
+
+  priv->event_source = clutter_event_source_new (manager_evdev);
+  priv->input_thread = g_thread_new ("Clutter input",
+                                     input_thread_func,
+                                     priv);
+
   clutter_device_manager_evdev_probe_devices (manager_evdev);
 
   /* subcribe for events on input devices */
@@ -892,6 +1298,18 @@ clutter_device_manager_evdev_finalize (GObject *object)
 
   g_object_unref (priv->udev_client);
 
+  /* stop the input thread before freeing the readers */
+  g_atomic_int_set (&priv->quit_input_thread, TRUE);
+  wakeup_pipe_write (priv->control_pipe[1]);
+  g_thread_join (priv->input_thread);
+
+  g_source_destroy (priv->event_source);
+  g_source_unref (priv->event_source);
+
+  g_slist_free_full (priv->readers,
+                     (GDestroyNotify) clutter_evdev_reader_free);
+  g_mutex_clear (&priv->readers_lock);
+
   for (l = priv->devices; l; l = g_slist_next (l))
     {
       ClutterInputDevice *device = l->data;
@@ -900,13 +1318,12 @@ clutter_device_manager_evdev_finalize (GObject *object)
     }
   g_slist_free (priv->devices);
 
-  for (l = priv->event_sources; l; l = g_slist_next (l))
-    {
-      ClutterEventSource *source = l->data;
+  g_free (priv->ring);
 
-      clutter_event_source_free (source);
-    }
-  g_slist_free (priv->event_sources);
+  close (priv->control_pipe[0]);
+  close (priv->control_pipe[1]);
+  close (priv->wakeup_pipe[0]);
+  close (priv->wakeup_pipe[1]);
 
   G_OBJECT_CLASS (clutter_device_manager_evdev_parent_class)->finalize (object);
 }
@@ -991,6 +1408,8 @@ clutter_device_manager_evdev_init (ClutterDeviceManagerEvdev *self)
 
   priv = self->priv = CLUTTER_DEVICE_MANAGER_EVDEV_GET_PRIVATE (self);
 
+  g_mutex_init (&priv->readers_lock);
+
   priv->stage_manager = clutter_stage_manager_get_default ();
   g_object_ref (priv->stage_manager);
 
@@ -294,7 +294,7 @@ clutter_gdk_handle_event (GdkEvent *gdk_event)
       event->any.stage = stage;
 
       if (gdk_event->any.send_event)
-	event->any.flags = CLUTTER_EVENT_FLAG_SYNTHETIC;
+	event->any.flags |= CLUTTER_EVENT_FLAG_SYNTHETIC;
 
       _clutter_event_push (event, FALSE);
 
@@ -309,8 +309,7 @@ clutter_gdk_handle_event (GdkEvent *gdk_event)
       while (spin > 0 && (event = clutter_event_get ()))
 	{
 	  /* forward the event into clutter for emission etc. */
-	  clutter_do_event (event);
-	  clutter_event_free (event);
+	  _clutter_do_event_take (event);
 	  --spin;
 	}
 
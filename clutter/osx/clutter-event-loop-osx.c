@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include "clutter-debug.h"
+#include "clutter-event-private.h"
 #include "clutter-private.h"
 
 /* 
@@ -712,8 +713,7 @@ clutter_event_dispatch (GSource     *source,
   if (event)
     {
       /* forward the event into clutter for emission etc. */
-      clutter_do_event (event);
-      clutter_event_free (event);
+      _clutter_do_event_take (event);
     }
 
   _clutter_threads_release_lock ();
@@ -548,6 +548,9 @@ clutter_backend_x11_finalize (GObject *gobject)
   clutter_x11_remove_filter (xsettings_filter, backend_x11);
   _clutter_xsettings_client_destroy (backend_x11->xsettings);
 
+  if (backend_x11->window_filters != NULL)
+    g_hash_table_destroy (backend_x11->window_filters);
+
   XCloseDisplay (backend_x11->xdpy);
 
   G_OBJECT_CLASS (clutter_backend_x11_parent_class)->finalize (gobject);
@@ -638,6 +641,40 @@ update_last_event_time (ClutterBackendX11 *backend_x11,
     backend_x11->last_event_time = current_time;
 }
 
+static gboolean
+run_event_filters (GSList       *node,
+                   XEvent       *xevent,
+                   ClutterEvent *event,
+                   gboolean     *retval)
+{
+  while (node != NULL)
+    {
+      ClutterX11EventFilter *filter = node->data;
+
+      /* the filter might remove itself */
+      node = node->next;
+
+      switch (filter->func (xevent, event, filter->data))
+        {
+        case CLUTTER_X11_FILTER_CONTINUE:
+          break;
+
+        case CLUTTER_X11_FILTER_TRANSLATE:
+          *retval = TRUE;
+          return TRUE;
+
+        case CLUTTER_X11_FILTER_REMOVE:
+          *retval = FALSE;
+          return TRUE;
+
+        default:
+          break;
+        }
+    }
+
+  return FALSE;
+}
+
 static gboolean
 clutter_backend_x11_translate_event (ClutterBackend *backend,
                                      gpointer        native,
@@ -646,33 +683,23 @@ clutter_backend_x11_translate_event (ClutterBackend *backend,
   ClutterBackendX11 *backend_x11 = CLUTTER_BACKEND_X11 (backend);
   ClutterBackendClass *parent_class;
   XEvent *xevent = native;
+  gboolean retval;
 
   /* X11 filter functions have a higher priority */
-  if (backend_x11->event_filters != NULL)
-    {
-      GSList *node = backend_x11->event_filters;
-
-      while (node != NULL)
-        {
-          ClutterX11EventFilter *filter = node->data;
-
-          switch (filter->func (xevent, event, filter->data))
-            {
-            case CLUTTER_X11_FILTER_CONTINUE:
-              break;
-
-            case CLUTTER_X11_FILTER_TRANSLATE:
-              return TRUE;
+  if (run_event_filters (backend_x11->event_filters, xevent, event, &retval))
+    return retval;
 
-            case CLUTTER_X11_FILTER_REMOVE:
-              return FALSE;
-
-            default:
-              break;
-            }
+  /* the filters of a window only see the events of that window; for
+   * XDamageNotify events the window is the damaged drawable
+   */
+  if (backend_x11->window_filters != NULL && xevent->type != GenericEvent)
+    {
+      GSList *filters;
 
-          node = node->next;
-        }
+      filters = g_hash_table_lookup (backend_x11->window_filters,
+                                     GUINT_TO_POINTER (xevent->xany.window));
+      if (run_event_filters (filters, xevent, event, &retval))
+        return retval;
     }
 
   /* we update the event time only for events that can
@@ -1092,6 +1119,111 @@ clutter_x11_add_filter (ClutterX11FilterFunc func,
   return;
 }
 
+static void
+window_filters_free (gpointer data)
+{
+  g_slist_free_full (data, g_free);
+}
+
+/*< private >
+ * _clutter_x11_add_window_filter:
+ * @xwindow: the XID of a window or a drawable
+ * @func: a filter function
+ * @data: user data to be passed to the filter function, or %NULL
+ *
+ * Adds an event filter function that is only called for the events
+ * whose window is @xwindow; this is cheaper than adding a filter with
+ * clutter_x11_add_filter() and discarding the events of other windows
+ * inside @func.
+ *
+ * Filters added with this function are called after the ones added
+ * with clutter_x11_add_filter().
+ */
+void
+_clutter_x11_add_window_filter (Window               xwindow,
+                                ClutterX11FilterFunc func,
+                                gpointer             data)
+{
+  ClutterBackend *backend = clutter_get_default_backend ();
+  ClutterBackendX11 *backend_x11;
+  ClutterX11EventFilter *filter;
+  GSList *filters;
+
+  g_return_if_fail (func != NULL);
+  g_return_if_fail (CLUTTER_IS_BACKEND_X11 (backend));
+
+  backend_x11 = CLUTTER_BACKEND_X11 (backend);
+
+  if (backend_x11->window_filters == NULL)
+    backend_x11->window_filters =
+      g_hash_table_new_full (NULL, NULL, NULL, window_filters_free);
+
+  filter = g_new0 (ClutterX11EventFilter, 1);
+  filter->func = func;
+  filter->data = data;
+
+  /* steal the list, so that replacing it does not free it */
+  filters = g_hash_table_lookup (backend_x11->window_filters,
+                                 GUINT_TO_POINTER (xwindow));
+  g_hash_table_steal (backend_x11->window_filters,
+                      GUINT_TO_POINTER (xwindow));
+
+  filters = g_slist_append (filters, filter);
+  g_hash_table_insert (backend_x11->window_filters,
+                       GUINT_TO_POINTER (xwindow),
+                       filters);
+}
+
+/*< private >
+ * _clutter_x11_remove_window_filter:
+ * @xwindow: the XID of a window or a drawable
+ * @func: a filter function
+ * @data: user data to be passed to the filter function, or %NULL
+ *
+ * Removes a filter function added with _clutter_x11_add_window_filter().
+ */
+void
+_clutter_x11_remove_window_filter (Window               xwindow,
+                                   ClutterX11FilterFunc func,
+                                   gpointer             data)
+{
+  ClutterBackend *backend = clutter_get_default_backend ();
+  ClutterBackendX11 *backend_x11;
+  GSList *filters, *l;
+
+  g_return_if_fail (func != NULL);
+  g_return_if_fail (CLUTTER_IS_BACKEND_X11 (backend));
+
+  backend_x11 = CLUTTER_BACKEND_X11 (backend);
+
+  if (backend_x11->window_filters == NULL)
+    return;
+
+  filters = g_hash_table_lookup (backend_x11->window_filters,
+                                 GUINT_TO_POINTER (xwindow));
+
+  for (l = filters; l != NULL; l = l->next)
+    {
+      ClutterX11EventFilter *filter = l->data;
+
+      if (filter->func == func && filter->data == data)
+        {
+          g_hash_table_steal (backend_x11->window_filters,
+                              GUINT_TO_POINTER (xwindow));
+
+          filters = g_slist_delete_link (filters, l);
+          g_free (filter);
+
+          if (filters != NULL)
+            g_hash_table_insert (backend_x11->window_filters,
+                                 GUINT_TO_POINTER (xwindow),
+                                 filters);
+
+          return;
+        }
+    }
+}
+
 /**
  * clutter_x11_remove_filter: (skip)
  * @func: a filter function
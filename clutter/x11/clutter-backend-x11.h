@@ -83,6 +83,11 @@ struct _ClutterBackendX11
   GSource *event_source;
   GSList  *event_filters;
 
+  /* filters only interested in the events of a given window or
+   * drawable; maps the XID to a GSList of ClutterX11EventFilter
+   */
+  GHashTable *window_filters;
+
   /* props */
   Atom atom_NET_WM_PID;
   Atom atom_NET_WM_PING;
@@ -127,6 +132,13 @@ XVisualInfo *   _clutter_backend_x11_get_visual_info (ClutterBackendX11 *backend
 
 void            _clutter_x11_select_events (Window xwin);
 
+void            _clutter_x11_add_window_filter          (Window               xwindow,
+                                                         ClutterX11FilterFunc func,
+                                                         gpointer             data);
+void            _clutter_x11_remove_window_filter       (Window               xwindow,
+                                                         ClutterX11FilterFunc func,
+                                                         gpointer             data);
+
 ClutterEventX11 *       _clutter_event_x11_new          (void);
 ClutterEventX11 *       _clutter_event_x11_copy         (ClutterEventX11 *event_x11);
 void                    _clutter_event_x11_free         (ClutterEventX11 *event_x11);
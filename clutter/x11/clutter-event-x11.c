@@ -39,6 +39,11 @@
 
 #include <glib.h>
 
+/* the maximum time spent delivering events in a single dispatch,
+ * in microseconds
+ */
+#define EVENT_DISPATCH_BUDGET           (4 * 1000)
+
 #if 0
 /* XEMBED protocol support for toolkit embedding */
 #define XEMBED_MAPPED                   (1 << 0)
@@ -220,8 +225,7 @@ clutter_x11_handle_event (XEvent *xevent)
   while (spin > 0 && (event = clutter_event_get ()))
     {
       /* forward the event into clutter for emission etc. */
-      clutter_do_event (event);
-      clutter_event_free (event);
+      _clutter_do_event_take (event);
       --spin;
     }
 
@@ -308,22 +312,33 @@ clutter_event_dispatch (GSource     *source,
 {
   ClutterBackendX11 *backend = ((ClutterEventSource *) source)->backend;
   ClutterEvent *event;
+  gint64 start_time;
 
   _clutter_threads_acquire_lock ();
 
-  /*  Grab the event(s), translate and figure out double click.
-   *  The push onto queue (stack) if valid.
-  */
-  events_queue (backend);
+  start_time = g_get_monotonic_time ();
 
-  /* Pop an event off the queue if any */
-  event = clutter_event_get ();
-  if (event != NULL)
+  /* we deliver all the pending events in a single dispatch, instead
+   * of one event per main loop iteration, so that input does not
+   * back up behind painting; if delivering them takes too long, the
+   * remaining events are left for the next dispatch
+   */
+  do
     {
+      /*  Grab the event(s), translate and figure out double click.
+       *  The push onto queue (stack) if valid.
+      */
+      events_queue (backend);
+
+      /* Pop an event off the queue if any */
+      event = clutter_event_get ();
+      if (event == NULL)
+        break;
+
       /* forward the event into clutter for emission etc. */
-      clutter_do_event (event);
-      clutter_event_free (event);
+      _clutter_do_event_take (event);
     }
+  while (g_get_monotonic_time () - start_time < EVENT_DISPATCH_BUDGET);
 
   _clutter_threads_release_lock ();
 
@@ -120,6 +120,7 @@ struct _ClutterX11TexturePixmapPrivate
   guint         depth;
 
   Damage        damage;
+  Drawable      damage_drawable;
 
   gint          window_x, window_y;
   gint          window_width, window_height;
@@ -299,7 +300,11 @@ create_damage_resources (ClutterX11TexturePixmap *texture)
 
   if (priv->damage)
     {
-      clutter_x11_add_filter (on_x_event_filter, (gpointer)texture);
+      /* the XDamageNotify events are routed using the drawable */
+      priv->damage_drawable = priv->pixmap;
+      _clutter_x11_add_window_filter (priv->damage_drawable,
+                                      on_x_event_filter,
+                                      (gpointer)texture);
 
       update_pixmap_damage_object (texture);
     }
@@ -322,7 +327,10 @@ free_damage_resources (ClutterX11TexturePixmap *texture)
       clutter_x11_untrap_x_errors ();
       priv->damage = None;
 
-      clutter_x11_remove_filter (on_x_event_filter, (gpointer)texture);
+      _clutter_x11_remove_window_filter (priv->damage_drawable,
+                                         on_x_event_filter,
+                                         (gpointer)texture);
+      priv->damage_drawable = None;
 
       update_pixmap_damage_object (texture);
     }
@@ -398,6 +406,7 @@ clutter_x11_texture_pixmap_init (ClutterX11TexturePixmap *self)
 
   self->priv->automatic_updates = FALSE;
   self->priv->damage = None;
+  self->priv->damage_drawable = None;
   self->priv->window = None;
   self->priv->pixmap = None;
   self->priv->pixmap_height = 0;
@@ -417,7 +426,10 @@ clutter_x11_texture_pixmap_dispose (GObject *object)
 
   free_damage_resources (texture);
 
-  clutter_x11_remove_filter (on_x_event_filter_too, (gpointer)texture);
+  if (texture->priv->window)
+    _clutter_x11_remove_window_filter (texture->priv->window,
+                                       on_x_event_filter_too,
+                                       (gpointer)texture);
   clutter_x11_texture_pixmap_set_pixmap (texture, None);
 
   G_OBJECT_CLASS (clutter_x11_texture_pixmap_parent_class)->dispose (object);
@@ -971,7 +983,9 @@ clutter_x11_texture_pixmap_set_window (ClutterX11TexturePixmap *texture,
 
   if (priv->window)
     {
-      clutter_x11_remove_filter (on_x_event_filter_too, (gpointer)texture);
+      _clutter_x11_remove_window_filter (priv->window,
+                                         on_x_event_filter_too,
+                                         (gpointer)texture);
       clutter_x11_trap_x_errors ();
       XCompositeUnredirectWindow(clutter_x11_get_default_display (),
                                   priv->window,
@@ -1014,7 +1028,9 @@ clutter_x11_texture_pixmap_set_window (ClutterX11TexturePixmap *texture,
 
   XSelectInput (dpy, priv->window,
                 attr.your_event_mask | StructureNotifyMask);
-  clutter_x11_add_filter (on_x_event_filter_too, (gpointer)texture);
+  _clutter_x11_add_window_filter (priv->window,
+                                  on_x_event_filter_too,
+                                  (gpointer)texture);
 
   g_object_ref (texture);
   g_object_notify (G_OBJECT (texture), "window");
@@ -387,6 +387,94 @@ actor_remove_all (TestConformSimpleFixture *fixture,
   g_object_unref (actor);
 }
 
+static void
+check_children_index (ClutterActor *actor)
+{
+  ClutterActor *iter;
+  gint i;
+
+  for (iter = clutter_actor_get_first_child (actor), i = 0;
+       iter != NULL;
+       iter = clutter_actor_get_next_sibling (iter), i += 1)
+    g_assert (clutter_actor_get_child_at_index (actor, i) == iter);
+
+  g_assert_cmpint (i, ==, clutter_actor_get_n_children (actor));
+  g_assert (clutter_actor_get_child_at_index (actor, i) == NULL);
+}
+
+void
+actor_many_children (TestConformSimpleFixture *fixture,
+                     gconstpointer dummy)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterActor *child, *iter;
+  gint i;
+
+  g_object_ref_sink (actor);
+
+  /* enough children for the actor to index them */
+  for (i = 0; i < 200; i++)
+    {
+      child = clutter_actor_new ();
+      clutter_actor_set_z_position (child, i % 10);
+      clutter_actor_add_child (actor, child);
+    }
+
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 200);
+  check_children_index (actor);
+
+  /* children are added after the ones at the same depth */
+  for (iter = clutter_actor_get_first_child (actor);
+       clutter_actor_get_next_sibling (iter) != NULL;
+       iter = clutter_actor_get_next_sibling (iter))
+    g_assert_cmpfloat (clutter_actor_get_z_position (iter), <=,
+                       clutter_actor_get_z_position (clutter_actor_get_next_sibling (iter)));
+
+  child = clutter_actor_new ();
+  clutter_actor_insert_child_at_index (actor, child, 50);
+  g_assert (clutter_actor_get_child_at_index (actor, 50) == child);
+  check_children_index (actor);
+
+  /* the child inserted at index 50 breaks the depth ordering, so the
+   * next depth-sorted insertion has to find the first deeper child
+   */
+  for (iter = clutter_actor_get_first_child (actor);
+       iter != NULL;
+       iter = clutter_actor_get_next_sibling (iter))
+    {
+      if (clutter_actor_get_z_position (iter) > 3.f)
+        break;
+    }
+
+  child = clutter_actor_new ();
+  clutter_actor_set_z_position (child, 3.f);
+  clutter_actor_add_child (actor, child);
+  g_assert (clutter_actor_get_next_sibling (child) == iter);
+  check_children_index (actor);
+
+  /* restoring the depth ordering allows bisecting the children again */
+  clutter_actor_set_z_position (clutter_actor_get_child_at_index (actor, 50), 2.f);
+  clutter_actor_remove_child (actor, clutter_actor_get_child_at_index (actor, 50));
+
+  child = clutter_actor_new ();
+  clutter_actor_set_z_position (child, 7.f);
+  clutter_actor_add_child (actor, child);
+  g_assert_cmpfloat (clutter_actor_get_z_position (clutter_actor_get_previous_sibling (child)), ==, 7.f);
+  g_assert_cmpfloat (clutter_actor_get_z_position (clutter_actor_get_next_sibling (child)), ==, 8.f);
+  check_children_index (actor);
+
+  while (clutter_actor_get_n_children (actor) > 10)
+    clutter_actor_remove_child (actor, clutter_actor_get_child_at_index (actor, 5));
+
+  check_children_index (actor);
+
+  clutter_actor_remove_all_children (actor);
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 0);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (actor);
+}
+
 static void
 actor_added (ClutterContainer *container,
              ClutterActor     *child,
@@ -209,3 +209,72 @@ actor_fixed_size (void)
   clutter_actor_destroy (rect);
   g_object_unref (rect);
 }
+
+static void
+on_queue_relayout (ClutterActor *actor,
+                   guint        *n_relayouts)
+{
+  *n_relayouts += 1;
+}
+
+void
+actor_relayout_root (void)
+{
+  ClutterActor *stage, *parent, *root, *child;
+  guint n_relayouts = 0;
+  ClutterActorBox box;
+
+  stage = clutter_stage_new ();
+
+  parent = clutter_actor_new ();
+  clutter_actor_add_child (stage, parent);
+
+  root = clutter_actor_new ();
+  clutter_actor_set_size (root, 200, 200);
+  clutter_actor_add_child (parent, root);
+
+  child = g_object_new (TEST_TYPE_ACTOR, NULL);
+  clutter_actor_add_child (root, child);
+
+  /* force the initial allocation */
+  clutter_actor_get_allocation_box (child, &box);
+
+  g_signal_connect (parent, "queue-relayout",
+                    G_CALLBACK (on_queue_relayout),
+                    &n_relayouts);
+
+  if (g_test_verbose ())
+    g_print ("Relayout queued below a fixed size actor\n");
+
+  ((TestActor *) child)->preferred_width_called = FALSE;
+
+  clutter_actor_queue_relayout (child);
+  g_assert_cmpuint (n_relayouts, ==, 0);
+
+  clutter_actor_get_allocation_box (child, &box);
+  g_assert (((TestActor *) child)->preferred_width_called);
+  g_assert_cmpfloat (box.x2 - box.x1, ==, 100);
+  g_assert_cmpfloat (box.y2 - box.y1, ==, 100);
+
+  if (g_test_verbose ())
+    g_print ("Relayout queued below a resizable actor\n");
+
+  clutter_actor_set_size (root, -1, -1);
+  clutter_actor_get_allocation_box (root, &box);
+
+  n_relayouts = 0;
+  clutter_actor_queue_relayout (child);
+  g_assert_cmpuint (n_relayouts, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("Relayout queued below an explicit relayout root\n");
+
+  clutter_actor_get_allocation_box (root, &box);
+  clutter_actor_set_relayout_root (root, TRUE);
+
+  n_relayouts = 0;
+  clutter_actor_queue_relayout (child);
+  g_assert_cmpuint (n_relayouts, ==, 0);
+
+  clutter_actor_destroy (stage);
+}
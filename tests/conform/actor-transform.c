@@ -0,0 +1,189 @@
+#include <math.h>
+
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define TEST_TYPE_OFFSET_ACTOR  (test_offset_actor_get_type ())
+
+typedef struct _TestOffsetActor         TestOffsetActor;
+typedef struct _ClutterActorClass       TestOffsetActorClass;
+
+/* an actor adding an offset to its transformation, without notifying
+ * the changes of the offset */
+struct _TestOffsetActor
+{
+  ClutterActor parent_instance;
+
+  gfloat offset_x;
+  gfloat offset_y;
+};
+
+G_DEFINE_TYPE (TestOffsetActor, test_offset_actor, CLUTTER_TYPE_ACTOR);
+
+static void
+test_offset_actor_apply_transform (ClutterActor  *actor,
+                                   ClutterMatrix *matrix)
+{
+  TestOffsetActor *self = (TestOffsetActor *) actor;
+
+  CLUTTER_ACTOR_CLASS (test_offset_actor_parent_class)->apply_transform (actor, matrix);
+
+  cogl_matrix_translate (matrix, self->offset_x, self->offset_y, 0.f);
+}
+
+static void
+test_offset_actor_class_init (TestOffsetActorClass *klass)
+{
+  klass->apply_transform = test_offset_actor_apply_transform;
+}
+
+static void
+test_offset_actor_init (TestOffsetActor *self)
+{
+}
+
+static void
+assert_position (ClutterActor *actor,
+                 ClutterActor *ancestor,
+                 gfloat        x,
+                 gfloat        y)
+{
+  ClutterActor *stage = clutter_actor_get_stage (actor);
+  ClutterVertex point = CLUTTER_VERTEX_INIT_ZERO;
+  ClutterVertex vertex;
+  ClutterActorBox box;
+  gfloat stage_x, stage_y;
+
+  /* make sure that the allocations are up to date */
+  clutter_actor_get_allocation_box (stage, &box);
+
+  clutter_actor_apply_relative_transform_to_point (actor, ancestor,
+                                                   &point,
+                                                   &vertex);
+
+  if (g_test_verbose ())
+    g_print ("Relative position of '%s': { %.2f, %.2f }, expected: { %.2f, %.2f }\n",
+             clutter_actor_get_name (actor),
+             vertex.x, vertex.y,
+             x, y);
+
+  g_assert_cmpfloat (vertex.x, ==, x);
+  g_assert_cmpfloat (vertex.y, ==, y);
+
+  if (ancestor != NULL)
+    return;
+
+  /* the transformed position goes through the projection of the stage */
+  clutter_actor_get_transformed_position (actor, &stage_x, &stage_y);
+
+  if (g_test_verbose ())
+    g_print ("Transformed position of '%s': { %.2f, %.2f }\n",
+             clutter_actor_get_name (actor),
+             stage_x, stage_y);
+
+  g_assert_cmpfloat (fabsf (stage_x - x), <, 0.01f);
+  g_assert_cmpfloat (fabsf (stage_y - y), <, 0.01f);
+}
+
+void
+actor_transform_cache (TestConformSimpleFixture *fixture,
+                       gconstpointer             dummy)
+{
+  ClutterActor *stage, *grandparent, *parent, *child;
+  ClutterMatrix transform;
+
+  stage = clutter_stage_new ();
+
+  grandparent = clutter_actor_new ();
+  clutter_actor_set_name (grandparent, "grandparent");
+  clutter_actor_set_position (grandparent, 100, 50);
+  clutter_actor_set_size (grandparent, 300, 300);
+  clutter_actor_add_child (stage, grandparent);
+
+  parent = clutter_actor_new ();
+  clutter_actor_set_name (parent, "parent");
+  clutter_actor_set_position (parent, 10, 20);
+  clutter_actor_set_size (parent, 100, 100);
+  clutter_actor_add_child (grandparent, parent);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_name (child, "child");
+  clutter_actor_set_position (child, 5, 5);
+  clutter_actor_set_size (child, 10, 10);
+  clutter_actor_add_child (parent, child);
+
+  /* the first query fills the cache, the second one uses it */
+  assert_position (child, NULL, 115, 75);
+  assert_position (child, NULL, 115, 75);
+  assert_position (child, grandparent, 15, 25);
+
+  if (g_test_verbose ())
+    g_print ("Moving an ancestor\n");
+
+  clutter_actor_set_position (grandparent, 200, 60);
+  assert_position (child, NULL, 215, 85);
+  assert_position (parent, NULL, 210, 80);
+  assert_position (child, grandparent, 15, 25);
+
+  if (g_test_verbose ())
+    g_print ("Changing the child transformation of the parent\n");
+
+  clutter_matrix_init_identity (&transform);
+  cogl_matrix_translate (&transform, 30.f, 0.f, 0.f);
+  clutter_actor_set_child_transform (parent, &transform);
+  assert_position (child, NULL, 245, 85);
+  assert_position (child, parent, 35, 5);
+  assert_position (parent, NULL, 210, 80);
+
+  clutter_actor_set_child_transform (parent, NULL);
+  assert_position (child, NULL, 215, 85);
+
+  if (g_test_verbose ())
+    g_print ("Reparenting the actor\n");
+
+  g_object_ref (child);
+  clutter_actor_remove_child (parent, child);
+  clutter_actor_add_child (grandparent, child);
+  g_object_unref (child);
+
+  assert_position (child, NULL, 205, 65);
+  assert_position (child, grandparent, 5, 5);
+
+  clutter_actor_destroy (stage);
+}
+
+void
+actor_transform_override (TestConformSimpleFixture *fixture,
+                          gconstpointer             dummy)
+{
+  ClutterActor *stage, *offset, *child;
+
+  stage = clutter_stage_new ();
+
+  offset = g_object_new (TEST_TYPE_OFFSET_ACTOR, NULL);
+  clutter_actor_set_name (offset, "offset");
+  clutter_actor_set_position (offset, 100, 50);
+  clutter_actor_set_size (offset, 100, 100);
+  clutter_actor_add_child (stage, offset);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_name (child, "child");
+  clutter_actor_set_position (child, 5, 5);
+  clutter_actor_set_size (child, 10, 10);
+  clutter_actor_add_child (offset, child);
+
+  assert_position (offset, NULL, 100, 50);
+  assert_position (child, NULL, 105, 55);
+
+  /* the overridden apply_transform() does not invalidate anything, so
+   * the transformations depending on it cannot be cached */
+  ((TestOffsetActor *) offset)->offset_x = 20;
+  ((TestOffsetActor *) offset)->offset_y = 10;
+
+  assert_position (offset, NULL, 120, 60);
+  assert_position (child, NULL, 125, 65);
+  assert_position (child, offset, 5, 5);
+
+  clutter_actor_destroy (stage);
+}
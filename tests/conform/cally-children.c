@@ -0,0 +1,148 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define N_CHILDREN      5000
+
+typedef struct {
+  gint n_added;
+  gint n_removed;
+  gint last_index;
+  gpointer last_child;
+} ChildrenState;
+
+static void
+on_children_added (AtkObject     *accessible,
+                   guint          index_,
+                   gpointer       child,
+                   ChildrenState *state)
+{
+  state->n_added += 1;
+  state->last_index = index_;
+  state->last_child = child;
+}
+
+static void
+on_children_removed (AtkObject     *accessible,
+                     guint          index_,
+                     gpointer       child,
+                     ChildrenState *state)
+{
+  state->n_removed += 1;
+  state->last_index = index_;
+  state->last_child = child;
+}
+
+static void
+assert_index_in_parent (ClutterActor *child,
+                        gint          index_)
+{
+  AtkObject *accessible = clutter_actor_get_accessible (child);
+
+  g_assert_cmpint (atk_object_get_index_in_parent (accessible), ==, index_);
+}
+
+void
+cally_children (TestConformSimpleFixture *fixture,
+                gconstpointer             dummy)
+{
+  ClutterActor *stage, *container, *child, *first;
+  ClutterActor **children;
+  ChildrenState state = { 0, };
+  AtkObject *accessible, *atk_child;
+  gint i;
+
+  if (!clutter_get_accessibility_enabled ())
+    {
+      if (g_test_verbose ())
+        g_print ("Accessibility is disabled, skipping\n");
+
+      return;
+    }
+
+  stage = clutter_stage_new ();
+
+  container = clutter_actor_new ();
+  clutter_actor_add_child (stage, container);
+
+  accessible = clutter_actor_get_accessible (container);
+  g_assert (accessible != NULL);
+
+  g_signal_connect (accessible, "children-changed::add",
+                    G_CALLBACK (on_children_added),
+                    &state);
+  g_signal_connect (accessible, "children-changed::remove",
+                    G_CALLBACK (on_children_removed),
+                    &state);
+
+  children = g_new (ClutterActor *, N_CHILDREN);
+
+  /* the accessibles of the children are not created when adding them,
+   * so the signals only carry their index */
+  for (i = 0; i < N_CHILDREN; i++)
+    {
+      children[i] = clutter_actor_new ();
+      clutter_actor_add_child (container, children[i]);
+
+      g_assert_cmpint (state.n_added, ==, i + 1);
+      g_assert_cmpint (state.last_index, ==, i);
+      g_assert (state.last_child == NULL);
+    }
+
+  g_assert_cmpint (atk_object_get_n_accessible_children (accessible), ==, N_CHILDREN);
+
+  for (i = 0; i < N_CHILDREN; i++)
+    assert_index_in_parent (children[i], i);
+
+  atk_child = atk_object_ref_accessible_child (accessible, N_CHILDREN / 2);
+  g_assert (atk_child == clutter_actor_get_accessible (children[N_CHILDREN / 2]));
+  g_object_unref (atk_child);
+
+  if (g_test_verbose ())
+    g_print ("Inserting a child at the beginning\n");
+
+  first = clutter_actor_new ();
+  clutter_actor_insert_child_at_index (container, first, 0);
+
+  g_assert_cmpint (state.last_index, ==, 0);
+  g_assert (state.last_child == NULL);
+
+  assert_index_in_parent (children[0], 1);
+  assert_index_in_parent (children[N_CHILDREN - 1], N_CHILDREN);
+
+  if (g_test_verbose ())
+    g_print ("Removing a child in the middle\n");
+
+  /* the accessible of the removed child exists, so it is passed along */
+  child = children[N_CHILDREN / 2];
+  atk_child = clutter_actor_get_accessible (child);
+
+  g_object_ref (child);
+  clutter_actor_remove_child (container, child);
+
+  g_assert_cmpint (state.n_removed, ==, 1);
+  g_assert_cmpint (state.last_index, ==, N_CHILDREN / 2 + 1);
+  g_assert (state.last_child == atk_child);
+
+  g_object_unref (child);
+
+  assert_index_in_parent (children[N_CHILDREN / 2 - 1], N_CHILDREN / 2);
+  assert_index_in_parent (children[N_CHILDREN / 2 + 1], N_CHILDREN / 2 + 1);
+  assert_index_in_parent (children[N_CHILDREN - 1], N_CHILDREN - 1);
+
+  if (g_test_verbose ())
+    g_print ("Removing a child without an accessible\n");
+
+  clutter_actor_remove_child (container, first);
+
+  g_assert_cmpint (state.n_removed, ==, 2);
+  g_assert_cmpint (state.last_index, ==, 0);
+  g_assert (state.last_child == NULL);
+
+  assert_index_in_parent (children[0], 0);
+  assert_index_in_parent (children[N_CHILDREN - 1], N_CHILDREN - 2);
+
+  g_free (children);
+
+  clutter_actor_destroy (stage);
+}
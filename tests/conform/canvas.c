@@ -0,0 +1,208 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+typedef struct _DrawData
+{
+  GThread *main_thread;
+
+  volatile gint n_draws;
+  volatile gint n_draws_in_thread;
+  volatile gint last_width;
+  volatile gint last_height;
+} DrawData;
+
+typedef struct _ClipData
+{
+  guint n_draws;
+
+  double x1, y1, x2, y2;
+} ClipData;
+
+static gboolean
+on_clipped_draw (ClutterCanvas *canvas,
+                 cairo_t       *cr,
+                 int            width,
+                 int            height,
+                 ClipData      *data)
+{
+  g_assert_cmpint (width, ==, 16);
+  g_assert_cmpint (height, ==, 16);
+
+  cairo_clip_extents (cr, &data->x1, &data->y1, &data->x2, &data->y2);
+
+  cairo_set_source_rgb (cr, 0.0, 0.0, 1.0);
+  cairo_paint (cr);
+
+  data->n_draws += 1;
+
+  return TRUE;
+}
+
+static void
+assert_clip (const ClipData *data,
+             double          x1,
+             double          y1,
+             double          x2,
+             double          y2)
+{
+  g_assert_cmpfloat (data->x1, ==, x1);
+  g_assert_cmpfloat (data->y1, ==, y1);
+  g_assert_cmpfloat (data->x2, ==, x2);
+  g_assert_cmpfloat (data->y2, ==, y2);
+}
+
+void
+canvas_invalidate_rect (TestConformSimpleFixture *fixture,
+                        gconstpointer             dummy)
+{
+  cairo_rectangle_int_t rect;
+  ClutterContent *canvas;
+  ClipData data = { 0, };
+
+  canvas = clutter_canvas_new ();
+  g_signal_connect (canvas, "draw", G_CALLBACK (on_clipped_draw), &data);
+
+  /* nothing is drawn before the canvas has a size */
+  rect.x = 0;
+  rect.y = 0;
+  rect.width = 8;
+  rect.height = 8;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (canvas), &rect);
+  g_assert_cmpuint (data.n_draws, ==, 0);
+
+  /* the first draw covers the whole canvas */
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), 16, 16);
+  g_assert_cmpuint (data.n_draws, ==, 1);
+  assert_clip (&data, 0, 0, 16, 16);
+
+  rect.x = 4;
+  rect.y = 2;
+  rect.width = 8;
+  rect.height = 6;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (canvas), &rect);
+  g_assert_cmpuint (data.n_draws, ==, 2);
+  assert_clip (&data, 4, 2, 12, 8);
+
+  /* the area is clamped to the size of the canvas */
+  rect.x = -4;
+  rect.y = 12;
+  rect.width = 8;
+  rect.height = 8;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (canvas), &rect);
+  g_assert_cmpuint (data.n_draws, ==, 3);
+  assert_clip (&data, 0, 12, 4, 16);
+
+  /* areas outside of the canvas are ignored */
+  rect.x = 16;
+  rect.y = 0;
+  rect.width = 8;
+  rect.height = 8;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (canvas), &rect);
+  g_assert_cmpuint (data.n_draws, ==, 3);
+
+  /* invalidating the content draws the whole canvas again */
+  clutter_content_invalidate (canvas);
+  g_assert_cmpuint (data.n_draws, ==, 4);
+  assert_clip (&data, 0, 0, 16, 16);
+
+  g_object_unref (canvas);
+}
+
+static gboolean
+on_async_draw (ClutterCanvas *canvas,
+               cairo_t       *cr,
+               int            width,
+               int            height,
+               DrawData      *data)
+{
+  if (g_thread_self () != data->main_thread)
+    g_atomic_int_inc (&data->n_draws_in_thread);
+
+  g_atomic_int_set (&data->last_width, width);
+  g_atomic_int_set (&data->last_height, height);
+
+  cairo_set_source_rgb (cr, 1.0, 0.0, 0.0);
+  cairo_paint (cr);
+
+  g_atomic_int_inc (&data->n_draws);
+
+  return TRUE;
+}
+
+static void
+wait_for_draws (ClutterCanvas *canvas,
+                guint          n_draws)
+{
+  ClutterCanvasDrawStats stats;
+  gint64 end_time;
+
+  end_time = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+
+  do
+    {
+      g_main_context_iteration (NULL, FALSE);
+      clutter_canvas_get_draw_stats (canvas, &stats);
+
+      if (g_get_monotonic_time () > end_time)
+        g_error ("Timed out waiting for the canvas to be drawn");
+    }
+  while (stats.n_draws < n_draws);
+}
+
+void
+canvas_async_draw (TestConformSimpleFixture *fixture,
+                   gconstpointer             dummy)
+{
+  ClutterCanvasDrawStats stats;
+  ClutterContent *canvas;
+  DrawData data = { NULL, };
+
+  data.main_thread = g_thread_self ();
+
+  canvas = clutter_canvas_new ();
+  g_signal_connect (canvas, "draw", G_CALLBACK (on_async_draw), &data);
+
+  clutter_canvas_set_async_draw (CLUTTER_CANVAS (canvas), TRUE);
+  g_assert (clutter_canvas_get_async_draw (CLUTTER_CANVAS (canvas)));
+
+  /* the first draw is queued, and the second one is coalesced until
+   * the first one is done; since the size changed meanwhile, the
+   * result of the first draw is discarded */
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), 64, 64);
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), 32, 32);
+
+  clutter_canvas_get_draw_stats (CLUTTER_CANVAS (canvas), &stats);
+  g_assert_cmpuint (stats.n_draws, ==, 0);
+
+  wait_for_draws (CLUTTER_CANVAS (canvas), 1);
+
+  g_assert_cmpint (g_atomic_int_get (&data.n_draws), ==, 2);
+  g_assert_cmpint (g_atomic_int_get (&data.n_draws_in_thread), ==, 2);
+  g_assert_cmpint (g_atomic_int_get (&data.last_width), ==, 32);
+  g_assert_cmpint (g_atomic_int_get (&data.last_height), ==, 32);
+
+  clutter_canvas_get_draw_stats (CLUTTER_CANVAS (canvas), &stats);
+  g_assert_cmpuint (stats.n_draws, ==, 1);
+  g_assert_cmpuint (stats.n_dropped_draws, ==, 1);
+  g_assert_cmpint (stats.last_latency, >=, 0);
+  g_assert_cmpint (stats.max_latency, >=, stats.last_latency);
+  g_assert_cmpint (stats.total_latency, ==, stats.last_latency);
+
+  /* invalidating draws the canvas again */
+  clutter_content_invalidate (canvas);
+  wait_for_draws (CLUTTER_CANVAS (canvas), 2);
+
+  clutter_canvas_get_draw_stats (CLUTTER_CANVAS (canvas), &stats);
+  g_assert_cmpuint (stats.n_draws, ==, 2);
+  g_assert_cmpuint (stats.n_dropped_draws, ==, 1);
+  g_assert_cmpint (stats.total_latency, >=, stats.max_latency);
+
+  clutter_canvas_reset_draw_stats (CLUTTER_CANVAS (canvas));
+  clutter_canvas_get_draw_stats (CLUTTER_CANVAS (canvas), &stats);
+  g_assert_cmpuint (stats.n_draws, ==, 0);
+  g_assert_cmpuint (stats.n_dropped_draws, ==, 0);
+  g_assert_cmpint (stats.max_latency, ==, 0);
+
+  g_object_unref (canvas);
+}
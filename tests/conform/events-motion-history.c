@@ -0,0 +1,207 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define N_MOTIONS       4
+
+typedef struct {
+  guint n_motions;
+  guint n_samples;
+  gfloat last_x;
+  gfloat samples_x[N_MOTIONS];
+  guint32 samples_time[N_MOTIONS];
+} MotionState;
+
+static gboolean
+on_captured_event (ClutterActor *stage,
+                   ClutterEvent *event,
+                   MotionState  *state)
+{
+  const ClutterMotionSample *history;
+  guint i, n_samples;
+
+  if (clutter_event_type (event) != CLUTTER_MOTION)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  state->n_motions += 1;
+
+  history = clutter_event_get_motion_history (event, &n_samples);
+  state->n_samples = n_samples;
+
+  for (i = 0; i < n_samples && i < N_MOTIONS; i++)
+    {
+      state->samples_x[i] = history[i].x;
+      state->samples_time[i] = history[i].time;
+    }
+
+  clutter_event_get_coords (event, &state->last_x, NULL);
+
+  clutter_main_quit ();
+
+  return CLUTTER_EVENT_STOP;
+}
+
+void
+events_motion_history (void)
+{
+  ClutterActor *stage;
+  MotionState state = { 0, };
+  gint i;
+
+  stage = clutter_stage_new ();
+
+  /* deliver the motion events to the stage, without picking */
+  clutter_stage_set_motion_events_enabled (CLUTTER_STAGE (stage), FALSE);
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (stage), TRUE);
+
+  g_signal_connect (stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    &state);
+
+  clutter_actor_show (stage);
+
+  /* all the events are queued before the next frame, so they should
+   * be coalesced into the last one */
+  for (i = 0; i < N_MOTIONS; i++)
+    {
+      ClutterEvent *event = clutter_event_new (CLUTTER_MOTION);
+
+      clutter_event_set_stage (event, CLUTTER_STAGE (stage));
+      clutter_event_set_time (event, 10 * (i + 1));
+      clutter_event_set_coords (event, 10.f * (i + 1), 10.f);
+
+      clutter_do_event (event);
+      clutter_event_free (event);
+    }
+
+  clutter_main ();
+
+  if (g_test_verbose ())
+    g_print ("motions: %u, samples: %u\n", state.n_motions, state.n_samples);
+
+  g_assert_cmpuint (state.n_motions, ==, 1);
+  g_assert_cmpuint (state.n_samples, ==, N_MOTIONS - 1);
+  g_assert_cmpfloat (state.last_x, ==, 10.f * N_MOTIONS);
+
+  for (i = 0; i < N_MOTIONS - 1; i++)
+    {
+      g_assert_cmpfloat (state.samples_x[i], ==, 10.f * (i + 1));
+      g_assert_cmpuint (state.samples_time[i], ==, 10 * (i + 1));
+    }
+
+  clutter_actor_destroy (stage);
+}
+
+#define N_SEQUENCES     2
+
+typedef struct {
+  ClutterEventSequence *sequence;
+  guint n_updates;
+  guint n_samples;
+  gfloat last_x;
+  gfloat samples_x[N_MOTIONS];
+} TouchState;
+
+static gboolean
+on_captured_touch_event (ClutterActor *stage,
+                         ClutterEvent *event,
+                         TouchState   *states)
+{
+  const ClutterMotionSample *history;
+  TouchState *state = NULL;
+  guint i, n_samples;
+
+  if (clutter_event_type (event) != CLUTTER_TOUCH_UPDATE)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  for (i = 0; i < N_SEQUENCES; i++)
+    {
+      if (states[i].sequence == clutter_event_get_event_sequence (event))
+        state = &states[i];
+    }
+
+  g_assert (state != NULL);
+
+  state->n_updates += 1;
+
+  history = clutter_event_get_motion_history (event, &n_samples);
+  state->n_samples = n_samples;
+
+  for (i = 0; i < n_samples && i < N_MOTIONS; i++)
+    state->samples_x[i] = history[i].x;
+
+  clutter_event_get_coords (event, &state->last_x, NULL);
+
+  /* all the queued events are delivered before returning to the
+   * main loop */
+  clutter_main_quit ();
+
+  return CLUTTER_EVENT_STOP;
+}
+
+void
+events_motion_history_touch (void)
+{
+  ClutterDeviceManager *manager;
+  ClutterInputDevice *device;
+  ClutterActor *stage;
+  TouchState states[N_SEQUENCES] = { { 0, }, };
+  gint i, j;
+
+  manager = clutter_device_manager_get_default ();
+  device = clutter_device_manager_get_core_device (manager,
+                                                   CLUTTER_POINTER_DEVICE);
+
+  stage = clutter_stage_new ();
+
+  clutter_stage_set_motion_events_enabled (CLUTTER_STAGE (stage), FALSE);
+  clutter_stage_set_throttle_motion_events (CLUTTER_STAGE (stage), TRUE);
+
+  g_signal_connect (stage, "captured-event",
+                    G_CALLBACK (on_captured_touch_event),
+                    states);
+
+  clutter_actor_show (stage);
+
+  for (j = 0; j < N_SEQUENCES; j++)
+    states[j].sequence = GINT_TO_POINTER (j + 1);
+
+  /* the updates of the touch points are interleaved, so each update
+   * is followed by an update of the other sequence */
+  for (i = 0; i < N_MOTIONS; i++)
+    {
+      for (j = 0; j < N_SEQUENCES; j++)
+        {
+          ClutterEvent *event = clutter_event_new (CLUTTER_TOUCH_UPDATE);
+
+          clutter_event_set_stage (event, CLUTTER_STAGE (stage));
+          clutter_event_set_device (event, device);
+          clutter_event_set_time (event, 10 * (i + 1));
+          clutter_event_set_coords (event, 100.f * j + 10.f * (i + 1), 10.f);
+          event->touch.sequence = states[j].sequence;
+
+          clutter_do_event (event);
+          clutter_event_free (event);
+        }
+    }
+
+  clutter_main ();
+
+  for (j = 0; j < N_SEQUENCES; j++)
+    {
+      if (g_test_verbose ())
+        g_print ("sequence %d: updates: %u, samples: %u\n",
+                 j + 1,
+                 states[j].n_updates,
+                 states[j].n_samples);
+
+      g_assert_cmpuint (states[j].n_updates, ==, 1);
+      g_assert_cmpuint (states[j].n_samples, ==, N_MOTIONS - 1);
+      g_assert_cmpfloat (states[j].last_x, ==, 100.f * j + 10.f * N_MOTIONS);
+
+      for (i = 0; i < N_MOTIONS - 1; i++)
+        g_assert_cmpfloat (states[j].samples_x[i], ==, 100.f * j + 10.f * (i + 1));
+    }
+
+  clutter_actor_destroy (stage);
+}
@@ -0,0 +1,141 @@
+#include <clutter/clutter.h>
+#include <json-glib/json-glib.h>
+
+#include "test-conform-common.h"
+
+#define N_FRAMES        3
+
+static gboolean
+queue_redraw (gpointer data)
+{
+  clutter_actor_queue_redraw (data);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+wait_for_frames (ClutterActor *stage,
+                 guint         n_frames)
+{
+  gint64 end_time;
+  guint redraw_id;
+
+  end_time = g_get_monotonic_time () + 10 * G_USEC_PER_SEC;
+  redraw_id = g_timeout_add (16, queue_redraw, stage);
+
+  while (clutter_frame_timings_get_n_records () < n_frames)
+    {
+      g_main_context_iteration (NULL, TRUE);
+
+      if (g_get_monotonic_time () > end_time)
+        g_error ("Timed out waiting for %u frames", n_frames);
+    }
+
+  g_source_remove (redraw_id);
+}
+
+static guint
+get_json_array_length (const gchar *data,
+                       gsize        length,
+                       const gchar *member)
+{
+  JsonParser *parser;
+  JsonObject *root;
+  GError *error = NULL;
+  guint retval;
+
+  parser = json_parser_new ();
+  json_parser_load_from_data (parser, data, length, &error);
+  g_assert_no_error (error);
+
+  g_assert (JSON_NODE_HOLDS_OBJECT (json_parser_get_root (parser)));
+  root = json_node_get_object (json_parser_get_root (parser));
+
+  g_assert (json_object_has_member (root, member));
+  retval = json_array_get_length (json_object_get_array_member (root, member));
+
+  g_object_unref (parser);
+
+  return retval;
+}
+
+void
+frame_timings_records (TestConformSimpleFixture *fixture,
+                       gconstpointer             dummy)
+{
+  ClutterFrameRecord records[N_FRAMES + 1];
+  ClutterFrameRecord last;
+  ClutterActor *stage;
+  gboolean was_enabled;
+  gchar *data;
+  gsize length;
+  guint i, n_records;
+
+  was_enabled = clutter_frame_timings_get_enabled ();
+
+  clutter_frame_timings_set_enabled (TRUE);
+  g_assert (clutter_frame_timings_get_enabled ());
+
+  clutter_frame_timings_reset ();
+  g_assert_cmpuint (clutter_frame_timings_get_n_records (), ==, 0);
+  g_assert_cmpuint (clutter_frame_timings_get_records (records, N_FRAMES), ==, 0);
+
+  stage = clutter_stage_new ();
+  clutter_actor_show (stage);
+
+  wait_for_frames (stage, N_FRAMES);
+
+  /* the records are returned from the oldest to the newest */
+  n_records = clutter_frame_timings_get_n_records ();
+  g_assert_cmpuint (clutter_frame_timings_get_records (records, N_FRAMES), ==, N_FRAMES);
+
+  for (i = 0; i < N_FRAMES; i++)
+    {
+      const ClutterFrameRecord *record = &records[i];
+
+      g_assert_cmpint (record->frame_time, >, 0);
+      g_assert_cmpint (record->total_time, >=, 0);
+      g_assert_cmpint (record->events_time, >=, 0);
+      g_assert_cmpint (record->timelines_time, >=, 0);
+      g_assert_cmpint (record->relayout_time, >=, 0);
+      g_assert_cmpint (record->paint_time, >=, 0);
+      g_assert_cmpint (record->swap_wait_time, >=, 0);
+      g_assert_cmpint (record->paint_time +
+                       record->swap_wait_time, <=, record->total_time);
+
+      if (i > 0)
+        g_assert_cmpint (records[i - 1].frame_time, <=, record->frame_time);
+    }
+
+  /* asking for fewer records returns the most recent ones */
+  g_assert_cmpuint (clutter_frame_timings_get_records (&last, 1), ==, 1);
+  g_assert_cmpint (last.frame_time, ==, records[N_FRAMES - 1].frame_time);
+
+  /* asking for more records than recorded returns all of them */
+  g_assert_cmpuint (clutter_frame_timings_get_records (records, N_FRAMES + 1),
+                    ==,
+                    MIN (n_records, N_FRAMES + 1));
+
+  /* the serialized forms contain one entry for each frame */
+  data = clutter_frame_timings_to_json (&length);
+  g_assert (data != NULL);
+  g_assert_cmpuint (get_json_array_length (data, length, "frames"), ==, n_records);
+  g_free (data);
+
+  data = clutter_frame_timings_to_trace (&length);
+  g_assert (data != NULL);
+  g_assert_cmpuint (get_json_array_length (data, length, "traceEvents"), >=, n_records);
+  g_free (data);
+
+  /* disabling the frame timings keeps the records */
+  clutter_frame_timings_set_enabled (FALSE);
+  g_assert (!clutter_frame_timings_get_enabled ());
+  g_assert_cmpuint (clutter_frame_timings_get_n_records (), ==, n_records);
+
+  clutter_frame_timings_reset ();
+  g_assert_cmpuint (clutter_frame_timings_get_n_records (), ==, 0);
+
+  clutter_actor_destroy (stage);
+
+  clutter_frame_timings_set_enabled (was_enabled);
+}
@@ -0,0 +1,264 @@
+#include <string.h>
+#include <gio/gio.h>
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+typedef struct _LoadData
+{
+  GMainLoop *main_loop;
+
+  guint n_pending;
+
+  gboolean first_res;
+  GError *first_error;
+
+  gboolean second_res;
+  GError *second_error;
+} LoadData;
+
+static GInputStream *
+open_test_image (void)
+{
+  GInputStream *stream;
+  GError *error = NULL;
+  GFile *file;
+
+  file = g_file_new_for_path (TESTS_DATADIR G_DIR_SEPARATOR_S "redhand.png");
+  stream = G_INPUT_STREAM (g_file_read (file, NULL, &error));
+  g_assert_no_error (error);
+
+  g_object_unref (file);
+
+  return stream;
+}
+
+static void
+load_done (LoadData *data)
+{
+  data->n_pending -= 1;
+
+  if (data->n_pending == 0)
+    g_main_loop_quit (data->main_loop);
+}
+
+static void
+on_first_load (GObject      *gobject,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+  LoadData *data = user_data;
+
+  data->first_res = clutter_image_load_finish (CLUTTER_IMAGE (gobject),
+                                               result,
+                                               &data->first_error);
+  load_done (data);
+}
+
+static void
+on_second_load (GObject      *gobject,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+  LoadData *data = user_data;
+
+  data->second_res = clutter_image_load_finish (CLUTTER_IMAGE (gobject),
+                                                result,
+                                                &data->second_error);
+  load_done (data);
+}
+
+static gboolean
+on_timeout (gpointer user_data)
+{
+  g_error ("Timed out waiting for the image to be loaded");
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+run_loads (LoadData *data)
+{
+  guint timeout_id;
+
+  timeout_id = g_timeout_add_seconds (10, on_timeout, NULL);
+  g_main_loop_run (data->main_loop);
+  g_source_remove (timeout_id);
+}
+
+static void
+load_data_init (LoadData *data,
+                guint     n_pending)
+{
+  memset (data, 0, sizeof (LoadData));
+
+  data->main_loop = g_main_loop_new (NULL, FALSE);
+  data->n_pending = n_pending;
+}
+
+static void
+load_data_clear (LoadData *data)
+{
+  g_main_loop_unref (data->main_loop);
+  g_clear_error (&data->first_error);
+  g_clear_error (&data->second_error);
+}
+
+void
+image_load_async (TestConformSimpleFixture *fixture,
+                  gconstpointer             dummy)
+{
+  ClutterActor *stage;
+  ClutterContent *image;
+  GInputStream *stream;
+  LoadData data;
+  gfloat width, height;
+
+  /* the image data is uploaded over multiple frames */
+  stage = clutter_stage_new ();
+  clutter_actor_show (stage);
+
+  image = clutter_image_new ();
+  g_assert (!clutter_content_get_preferred_size (image, NULL, NULL));
+
+  /* the image is scaled down while decoding, keeping its aspect ratio */
+  load_data_init (&data, 1);
+  stream = open_test_image ();
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, 100, 100,
+                            NULL,
+                            on_first_load,
+                            &data);
+  g_object_unref (stream);
+
+  run_loads (&data);
+
+  g_assert_no_error (data.first_error);
+  g_assert (data.first_res);
+
+  g_assert (clutter_content_get_preferred_size (image, &width, &height));
+  g_assert_cmpfloat (width, ==, 94);
+  g_assert_cmpfloat (height, ==, 100);
+
+  load_data_clear (&data);
+
+  /* without limits, the image is loaded at its own size */
+  load_data_init (&data, 1);
+  stream = open_test_image ();
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, -1, -1,
+                            NULL,
+                            on_first_load,
+                            &data);
+  g_object_unref (stream);
+
+  run_loads (&data);
+
+  g_assert_no_error (data.first_error);
+  g_assert (data.first_res);
+
+  g_assert (clutter_content_get_preferred_size (image, &width, &height));
+  g_assert_cmpfloat (width, ==, 200);
+  g_assert_cmpfloat (height, ==, 213);
+
+  load_data_clear (&data);
+
+  g_object_unref (image);
+  clutter_actor_destroy (stage);
+}
+
+void
+image_load_async_cancel (TestConformSimpleFixture *fixture,
+                         gconstpointer             dummy)
+{
+  GCancellable *cancellable;
+  ClutterActor *stage;
+  ClutterContent *image;
+  GInputStream *stream;
+  LoadData data;
+
+  stage = clutter_stage_new ();
+  clutter_actor_show (stage);
+
+  image = clutter_image_new ();
+
+  /* cancelling a load */
+  load_data_init (&data, 1);
+  cancellable = g_cancellable_new ();
+  stream = open_test_image ();
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, -1, -1,
+                            cancellable,
+                            on_first_load,
+                            &data);
+  g_cancellable_cancel (cancellable);
+  g_object_unref (stream);
+
+  run_loads (&data);
+
+  g_assert (!data.first_res);
+  g_assert_error (data.first_error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_assert (!clutter_content_get_preferred_size (image, NULL, NULL));
+
+  g_object_unref (cancellable);
+  load_data_clear (&data);
+
+  /* starting a new load cancels the pending one */
+  load_data_init (&data, 2);
+  stream = open_test_image ();
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, -1, -1,
+                            NULL,
+                            on_first_load,
+                            &data);
+  g_object_unref (stream);
+
+  stream = open_test_image ();
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, 50, 50,
+                            NULL,
+                            on_second_load,
+                            &data);
+  g_object_unref (stream);
+
+  run_loads (&data);
+
+  g_assert (!data.first_res);
+  g_assert_error (data.first_error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+
+  g_assert_no_error (data.second_error);
+  g_assert (data.second_res);
+  g_assert (clutter_content_get_preferred_size (image, NULL, NULL));
+
+  load_data_clear (&data);
+
+  g_object_unref (image);
+  clutter_actor_destroy (stage);
+}
+
+void
+image_load_async_invalid (TestConformSimpleFixture *fixture,
+                          gconstpointer             dummy)
+{
+  static const char invalid_data[] = "this is not an image";
+  ClutterContent *image;
+  GInputStream *stream;
+  LoadData data;
+
+  image = clutter_image_new ();
+
+  load_data_init (&data, 1);
+  stream = g_memory_input_stream_new_from_data (invalid_data,
+                                                sizeof (invalid_data),
+                                                NULL);
+  clutter_image_load_async (CLUTTER_IMAGE (image), stream, -1, -1,
+                            NULL,
+                            on_first_load,
+                            &data);
+  g_object_unref (stream);
+
+  run_loads (&data);
+
+  g_assert (!data.first_res);
+  g_assert (data.first_error != NULL);
+  g_assert (!clutter_content_get_preferred_size (image, NULL, NULL));
+
+  load_data_clear (&data);
+
+  g_object_unref (image);
+}
@@ -0,0 +1,502 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+enum
+{
+  COLUMN_SCORE,   /* G_TYPE_INT */
+  COLUMN_NAME,    /* G_TYPE_STRING */
+
+  N_COLUMNS
+};
+
+typedef struct _RowsData
+{
+  ClutterModel *model;
+
+  guint n_row_added;
+  guint n_row_changed;
+  guint n_row_removed;
+
+  guint n_rows_changed;
+  guint first_row;
+  guint n_rows;
+} RowsData;
+
+static void
+on_row_added (ClutterModel     *model,
+              ClutterModelIter *iter,
+              RowsData         *data)
+{
+  data->n_row_added += 1;
+}
+
+static void
+on_row_changed (ClutterModel     *model,
+                ClutterModelIter *iter,
+                RowsData         *data)
+{
+  data->n_row_changed += 1;
+}
+
+static void
+on_row_removed (ClutterModel     *model,
+                ClutterModelIter *iter,
+                RowsData         *data)
+{
+  data->n_row_removed += 1;
+}
+
+static void
+on_rows_changed (ClutterModel *model,
+                 guint         first_row,
+                 guint         n_rows,
+                 RowsData     *data)
+{
+  data->n_rows_changed += 1;
+  data->first_row = first_row;
+  data->n_rows = n_rows;
+}
+
+static void
+rows_data_init (RowsData *data)
+{
+  data->model = clutter_list_model_new (N_COLUMNS,
+                                        G_TYPE_INT, "Score",
+                                        G_TYPE_STRING, "Name");
+
+  data->n_row_added = 0;
+  data->n_row_changed = 0;
+  data->n_row_removed = 0;
+  data->n_rows_changed = 0;
+  data->first_row = 0;
+  data->n_rows = 0;
+
+  g_signal_connect (data->model, "row-added",
+                    G_CALLBACK (on_row_added),
+                    data);
+  g_signal_connect (data->model, "row-changed",
+                    G_CALLBACK (on_row_changed),
+                    data);
+  g_signal_connect (data->model, "row-removed",
+                    G_CALLBACK (on_row_removed),
+                    data);
+  g_signal_connect (data->model, "rows-changed",
+                    G_CALLBACK (on_rows_changed),
+                    data);
+}
+
+static gint
+get_score (ClutterModel *model,
+           guint         row)
+{
+  ClutterModelIter *iter;
+  gint score;
+
+  iter = clutter_model_get_iter_at_row (model, row);
+  g_assert (iter != NULL);
+
+  clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+  g_object_unref (iter);
+
+  return score;
+}
+
+static gint
+compare_scores (ClutterModel *model,
+                const GValue *a,
+                const GValue *b,
+                gpointer      dummy)
+{
+  return g_value_get_int (a) - g_value_get_int (b);
+}
+
+static gboolean
+filter_even_scores (ClutterModel     *model,
+                    ClutterModelIter *iter,
+                    gpointer          dummy)
+{
+  gint score;
+
+  clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+
+  return (score % 2) == 0;
+}
+
+static gboolean
+filter_above_threshold (ClutterModel     *model,
+                        ClutterModelIter *iter,
+                        gpointer          data)
+{
+  gint score;
+
+  clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+
+  return score > *((gint *) data);
+}
+
+static gint
+get_iter_score (ClutterModelIter *iter)
+{
+  gint score;
+
+  clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+
+  return score;
+}
+
+static void
+assert_sorted (ClutterModel *model)
+{
+  guint i, n_rows;
+
+  n_rows = clutter_model_get_n_rows (model);
+  for (i = 1; i < n_rows; i++)
+    g_assert_cmpint (get_score (model, i - 1), <=, get_score (model, i));
+}
+
+void
+model_rows_freeze_thaw (TestConformSimpleFixture *fixture,
+                        gconstpointer             dummy)
+{
+  ClutterModelIter *iter;
+  RowsData data;
+  gint i;
+
+  rows_data_init (&data);
+
+  for (i = 0; i < 3; i++)
+    clutter_model_append (data.model, COLUMN_SCORE, i, COLUMN_NAME, "foo", -1);
+
+  g_assert_cmpuint (data.n_row_added, ==, 3);
+  g_assert_cmpuint (data.n_rows_changed, ==, 0);
+
+  data.n_row_added = 0;
+
+  clutter_model_freeze_rows (data.model);
+
+  /* nested freezes are allowed */
+  clutter_model_freeze_rows (data.model);
+
+  for (i = 3; i < 8; i++)
+    clutter_model_append (data.model, COLUMN_SCORE, i, COLUMN_NAME, "bar", -1);
+
+  clutter_model_thaw_rows (data.model);
+
+  g_assert_cmpuint (data.n_rows_changed, ==, 0);
+
+  iter = clutter_model_get_iter_at_row (data.model, 1);
+  clutter_model_iter_set (iter, COLUMN_NAME, "baz", -1);
+  g_object_unref (iter);
+
+  g_assert_cmpuint (data.n_row_added, ==, 0);
+  g_assert_cmpuint (data.n_row_changed, ==, 0);
+  g_assert_cmpuint (data.n_rows_changed, ==, 0);
+
+  clutter_model_thaw_rows (data.model);
+
+  /* a single emission, from the changed row to the end of the model */
+  g_assert_cmpuint (data.n_row_added, ==, 0);
+  g_assert_cmpuint (data.n_row_changed, ==, 0);
+  g_assert_cmpuint (data.n_rows_changed, ==, 1);
+  g_assert_cmpuint (data.first_row, ==, 1);
+  g_assert_cmpuint (data.n_rows, ==, 7);
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 8);
+
+  /* thawing without changes does not emit ::rows-changed */
+  clutter_model_freeze_rows (data.model);
+  clutter_model_thaw_rows (data.model);
+
+  g_assert_cmpuint (data.n_rows_changed, ==, 1);
+
+  g_object_unref (data.model);
+}
+
+void
+model_rows_remove_frozen (TestConformSimpleFixture *fixture,
+                          gconstpointer             dummy)
+{
+  RowsData data;
+  gint i;
+
+  rows_data_init (&data);
+
+  for (i = 0; i < 2; i++)
+    clutter_model_append (data.model, COLUMN_SCORE, i, COLUMN_NAME, "foo", -1);
+
+  clutter_model_freeze_rows (data.model);
+
+  for (i = 2; i < 6; i++)
+    clutter_model_append (data.model, COLUMN_SCORE, i, COLUMN_NAME, "bar", -1);
+
+  /* ::row-removed is still emitted while the rows are frozen, and the
+   * rows added after the removed one are shifted */
+  clutter_model_remove (data.model, 0);
+
+  g_assert_cmpuint (data.n_row_removed, ==, 1);
+  g_assert_cmpuint (data.n_rows_changed, ==, 0);
+
+  clutter_model_thaw_rows (data.model);
+
+  g_assert_cmpuint (data.n_rows_changed, ==, 1);
+  g_assert_cmpuint (data.first_row, ==, 1);
+  g_assert_cmpuint (data.n_rows, ==, 4);
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 5);
+  g_assert_cmpint (get_score (data.model, 1), ==, 2);
+
+  g_object_unref (data.model);
+}
+
+static void
+on_sorted_row_added (ClutterModel     *model,
+                     ClutterModelIter *iter,
+                     RowsData         *data)
+{
+  guint row = clutter_model_iter_get_row (iter);
+  gint score;
+
+  clutter_model_iter_get (iter, COLUMN_SCORE, &score, -1);
+
+  /* the row is already in its sorted position */
+  g_assert_cmpint (get_score (model, row), ==, score);
+  assert_sorted (model);
+}
+
+void
+model_rows_resort_row (TestConformSimpleFixture *fixture,
+                       gconstpointer             dummy)
+{
+  static const gint scores[] = { 50, 10, 40, 20, 30 };
+  ClutterModelIter *iter;
+  RowsData data;
+  guint i;
+
+  rows_data_init (&data);
+
+  clutter_model_set_sort (data.model, COLUMN_SCORE,
+                          compare_scores,
+                          NULL, NULL);
+
+  g_signal_connect (data.model, "row-added",
+                    G_CALLBACK (on_sorted_row_added),
+                    &data);
+
+  for (i = 0; i < G_N_ELEMENTS (scores); i++)
+    clutter_model_append (data.model,
+                          COLUMN_SCORE, scores[i],
+                          COLUMN_NAME, "foo",
+                          -1);
+
+  g_assert_cmpuint (data.n_row_added, ==, G_N_ELEMENTS (scores));
+  assert_sorted (data.model);
+
+  /* changing the sorting column moves the row, and its iterator */
+  iter = clutter_model_get_iter_at_row (data.model, 0);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 35, -1);
+
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 2);
+  g_assert_cmpint (get_score (data.model, 2), ==, 35);
+  assert_sorted (data.model);
+
+  g_object_unref (iter);
+
+  /* rows added while frozen are sorted once thawed */
+  clutter_model_freeze_rows (data.model);
+
+  clutter_model_append (data.model, COLUMN_SCORE, 5, COLUMN_NAME, "bar", -1);
+  clutter_model_append (data.model, COLUMN_SCORE, 45, COLUMN_NAME, "bar", -1);
+
+  clutter_model_thaw_rows (data.model);
+
+  g_assert_cmpuint (data.n_rows_changed, ==, 1);
+  g_assert_cmpuint (data.first_row, ==, 0);
+  g_assert_cmpuint (data.n_rows, ==, 7);
+  g_assert_cmpint (get_score (data.model, 0), ==, 5);
+  assert_sorted (data.model);
+
+  g_object_unref (data.model);
+}
+
+void
+model_rows_resort_row_filtered (TestConformSimpleFixture *fixture,
+                                gconstpointer             dummy)
+{
+  static const gint scores[] = { 8, 3, 6, 5, 4, 2 };
+  ClutterModelIter *iter;
+  RowsData data;
+  guint i;
+
+  rows_data_init (&data);
+
+  clutter_model_set_sort (data.model, COLUMN_SCORE,
+                          compare_scores,
+                          NULL, NULL);
+  clutter_model_set_filter (data.model,
+                            filter_even_scores,
+                            NULL, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (scores); i++)
+    clutter_model_append (data.model,
+                          COLUMN_SCORE, scores[i],
+                          COLUMN_NAME, "foo",
+                          -1);
+
+  /* 2, 4, 6, 8 */
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 4);
+  g_assert_cmpint (get_score (data.model, 0), ==, 2);
+
+  /* the row of the iterator is the position among the filtered rows,
+   * not among all the rows */
+  iter = clutter_model_get_iter_at_row (data.model, 0);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 10, -1);
+
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 3);
+  g_assert_cmpint (get_score (data.model, 3), ==, 10);
+  assert_sorted (data.model);
+
+  g_object_unref (iter);
+
+  /* 4, 6, 8, 10; a row that is filtered out takes the position of the
+   * first valid row following it */
+  iter = clutter_model_get_iter_at_row (data.model, 0);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 9, -1);
+
+  /* 6, 8, [9], 10 */
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 3);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 2);
+
+  /* resorting a row that is already filtered out updates it as well */
+  clutter_model_iter_set (iter, COLUMN_SCORE, 1, -1);
+
+  /* [1], 6, 8, 10 */
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 0);
+  g_assert (clutter_model_iter_is_first (iter));
+
+  clutter_model_iter_next (iter);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 0);
+  g_assert_cmpint (get_score (data.model, 0), ==, 6);
+  assert_sorted (data.model);
+
+  g_object_unref (iter);
+  g_object_unref (data.model);
+}
+
+void
+model_rows_filter (TestConformSimpleFixture *fixture,
+                   gconstpointer             dummy)
+{
+  ClutterModelIter *iter, *copy;
+  RowsData data;
+  gint threshold;
+  guint i;
+
+  rows_data_init (&data);
+
+  for (i = 1; i < 10; i++)
+    clutter_model_append (data.model,
+                          COLUMN_SCORE, i,
+                          COLUMN_NAME, "foo",
+                          -1);
+
+  /* 2, 4, 6, 8 */
+  clutter_model_set_filter (data.model, filter_even_scores, NULL, NULL);
+
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 4);
+  for (i = 0; i < 4; i++)
+    g_assert_cmpint (get_score (data.model, i), ==, 2 * (i + 1));
+
+  g_assert (clutter_model_get_iter_at_row (data.model, 4) == NULL);
+
+  if (g_test_verbose ())
+    g_print ("Filtering out a row...\n");
+
+  /* 2, [5], 6, 8; a row that is filtered out takes the position of
+   * the first valid row following it */
+  iter = clutter_model_get_iter_at_row (data.model, 1);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 5, -1);
+
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 3);
+  g_assert_cmpint (get_score (data.model, 1), ==, 6);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 1);
+  g_assert (!clutter_model_iter_is_first (iter));
+  g_assert (!clutter_model_iter_is_last (iter));
+
+  copy = clutter_model_iter_next (clutter_model_iter_copy (iter));
+  g_assert_cmpuint (clutter_model_iter_get_row (copy), ==, 1);
+  g_assert_cmpint (get_iter_score (copy), ==, 6);
+  g_object_unref (copy);
+
+  copy = clutter_model_iter_prev (clutter_model_iter_copy (iter));
+  g_assert_cmpuint (clutter_model_iter_get_row (copy), ==, 0);
+  g_assert_cmpint (get_iter_score (copy), ==, 2);
+  g_object_unref (copy);
+
+  if (g_test_verbose ())
+    g_print ("Making the row valid again...\n");
+
+  /* 2, 4, 6, 8; the row goes back to its place among the valid rows */
+  clutter_model_iter_set (iter, COLUMN_SCORE, 4, -1);
+
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 4);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 1);
+  for (i = 0; i < 4; i++)
+    g_assert_cmpint (get_score (data.model, i), ==, 2 * (i + 1));
+
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Filtering out the last row...\n");
+
+  /* 2, 4, 6, [9] */
+  iter = clutter_model_get_iter_at_row (data.model, 3);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 9, -1);
+
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 3);
+  g_assert (clutter_model_iter_is_last (iter));
+  g_assert (!clutter_model_iter_is_first (iter));
+
+  clutter_model_iter_prev (iter);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 2);
+  g_assert_cmpint (get_iter_score (iter), ==, 6);
+  g_assert (!clutter_model_iter_is_last (iter));
+
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Filtering out the first row...\n");
+
+  /* [1], 4, 6 */
+  iter = clutter_model_get_iter_at_row (data.model, 0);
+  clutter_model_iter_set (iter, COLUMN_SCORE, 1, -1);
+
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 2);
+  g_assert (clutter_model_iter_is_first (iter));
+  g_assert (!clutter_model_iter_is_last (iter));
+
+  clutter_model_iter_next (iter);
+  g_assert_cmpuint (clutter_model_iter_get_row (iter), ==, 0);
+  g_assert_cmpint (get_iter_score (iter), ==, 4);
+
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Filtering with outside state...\n");
+
+  /* the scores are now 1, 1, 3, 4, 5, 6, 7, 9, 9 */
+  threshold = 5;
+  clutter_model_set_filter (data.model, filter_above_threshold, &threshold, NULL);
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 4);
+
+  /* the result of the filter is cached until it is set again */
+  threshold = 8;
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 4);
+
+  clutter_model_set_filter (data.model, filter_above_threshold, &threshold, NULL);
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 2);
+  g_assert_cmpint (get_score (data.model, 0), ==, 9);
+
+  clutter_model_set_filter (data.model, NULL, NULL, NULL);
+  g_assert_cmpuint (clutter_model_get_n_rows (data.model), ==, 9);
+
+  g_object_unref (data.model);
+}
@@ -0,0 +1,158 @@
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+typedef struct _TestTiles       TestTiles;
+typedef struct _TestTilesClass  TestTilesClass;
+
+struct _TestTiles
+{
+  ClutterActor parent_instance;
+
+  CoglPipeline *red;
+  CoglPipeline *blue;
+};
+
+struct _TestTilesClass
+{
+  ClutterActorClass parent_class;
+};
+
+GType test_tiles_get_type (void);
+
+G_DEFINE_TYPE (TestTiles, test_tiles, CLUTTER_TYPE_ACTOR)
+
+static void
+add_tile (ClutterPaintNode *root,
+          CoglPipeline     *pipeline,
+          float             x1,
+          float             y1,
+          float             x2,
+          float             y2)
+{
+  ClutterActorBox box = { x1, y1, x2, y2 };
+  ClutterPaintNode *node;
+
+  node = clutter_pipeline_node_new (pipeline);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static void
+test_tiles_paint_node (ClutterActor     *actor,
+                       ClutterPaintNode *root)
+{
+  TestTiles *self = (TestTiles *) actor;
+  int i;
+
+  /* a run of sibling nodes sharing the same pipeline */
+  for (i = 0; i < 4; i++)
+    add_tile (root, self->red, i * 10, 0, i * 10 + 10, 10);
+
+  /* the order of the nodes is preserved around a different pipeline */
+  add_tile (root, self->blue, 0, 10, 20, 20);
+  add_tile (root, self->red, 0, 10, 5, 20);
+  add_tile (root, self->red, 30, 10, 40, 20);
+}
+
+static void
+test_tiles_finalize (GObject *gobject)
+{
+  TestTiles *self = (TestTiles *) gobject;
+
+  cogl_object_unref (self->red);
+  cogl_object_unref (self->blue);
+
+  G_OBJECT_CLASS (test_tiles_parent_class)->finalize (gobject);
+}
+
+static void
+test_tiles_class_init (TestTilesClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  gobject_class->finalize = test_tiles_finalize;
+  actor_class->paint_node = test_tiles_paint_node;
+}
+
+static void
+test_tiles_init (TestTiles *self)
+{
+  CoglContext *ctx;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  self->red = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_color4ub (self->red, 0xff, 0x00, 0x00, 0xff);
+
+  self->blue = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_color4ub (self->blue, 0x00, 0x00, 0xff, 0xff);
+}
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+on_paint (ClutterActor *stage,
+          gboolean     *was_painted)
+{
+  /* the run of red tiles */
+  g_assert_cmpint (get_pixel (5, 5), ==, 0xff0000);
+  g_assert_cmpint (get_pixel (35, 5), ==, 0xff0000);
+  g_assert_cmpint (get_pixel (45, 5), ==, 0x000000);
+
+  /* the red tile painted after the blue one is on top of it */
+  g_assert_cmpint (get_pixel (2, 15), ==, 0xff0000);
+  g_assert_cmpint (get_pixel (15, 15), ==, 0x0000ff);
+  g_assert_cmpint (get_pixel (25, 15), ==, 0x000000);
+  g_assert_cmpint (get_pixel (35, 15), ==, 0xff0000);
+
+  *was_painted = TRUE;
+}
+
+void
+paint_nodes_pipeline_siblings (TestConformSimpleFixture *fixture,
+                               gconstpointer             dummy)
+{
+  ClutterActor *stage, *tiles;
+  gboolean was_painted = FALSE;
+  gint64 end_time;
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+
+  tiles = g_object_new (test_tiles_get_type (), NULL);
+  clutter_actor_set_size (tiles, 50, 20);
+  clutter_actor_add_child (stage, tiles);
+
+  g_signal_connect_after (stage, "paint", G_CALLBACK (on_paint), &was_painted);
+
+  clutter_actor_show (stage);
+
+  end_time = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (!was_painted)
+    {
+      g_main_context_iteration (NULL, TRUE);
+
+      if (g_get_monotonic_time () > end_time)
+        g_error ("Timed out waiting for the stage to be painted");
+    }
+
+  clutter_actor_destroy (stage);
+}
@@ -0,0 +1,130 @@
+#include <string.h>
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+static const gchar *test_ui_definition =
+"["
+"  {"
+"    \"id\" : \"test-actor\","
+"    \"type\" : \"ClutterActor\","
+"    \"x-align\" : \"center\","
+"    \"background-color\" : \"#ff0000ff\","
+"    \"layout-manager\" : {"
+"      \"type\" : \"ClutterBoxLayout\","
+"      \"spacing\" : 12"
+"    },"
+"    \"children\" : ["
+"      {"
+"        \"id\" : \"first-child\","
+"        \"type\" : \"ClutterActor\","
+"        \"width\" : 100"
+"      },"
+"      {"
+"        \"type\" : \"ClutterActor\","
+"        \"constraints\" : ["
+"          {"
+"            \"type\" : \"ClutterAlignConstraint\","
+"            \"name\" : \"y-align\","
+"            \"align-axis\" : \"y-axis\","
+"            \"source\" : \"test-actor\""
+"          }"
+"        ]"
+"      }"
+"    ]"
+"  }"
+"]";
+
+void
+script_compiled_load (TestConformSimpleFixture *fixture,
+                      gconstpointer dummy)
+{
+  ClutterScript *script;
+  ClutterLayoutManager *manager;
+  ClutterActor *actor, *child;
+  ClutterActorMeta *constraint;
+  ClutterColor color;
+  GError *error = NULL;
+  GBytes *compiled;
+  guint merge_id;
+
+  compiled = clutter_script_compile_data (test_ui_definition, -1, &error);
+  g_assert_no_error (error);
+  g_assert (compiled != NULL);
+
+  script = clutter_script_new ();
+  merge_id = clutter_script_load_from_data (script,
+                                            g_bytes_get_data (compiled, NULL),
+                                            g_bytes_get_size (compiled),
+                                            &error);
+  if (g_test_verbose () && error != NULL)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+  g_assert_cmpuint (merge_id, ==, 1);
+
+  actor = CLUTTER_ACTOR (clutter_script_get_object (script, "test-actor"));
+  g_assert (CLUTTER_IS_ACTOR (actor));
+
+  g_assert_cmpint (clutter_actor_get_x_align (actor), ==, CLUTTER_ACTOR_ALIGN_CENTER);
+
+  clutter_actor_get_background_color (actor, &color);
+  g_assert_cmpint (color.red, ==, 255);
+  g_assert_cmpint (color.green, ==, 0);
+  g_assert_cmpint (color.blue, ==, 0);
+  g_assert_cmpint (color.alpha, ==, 255);
+
+  manager = clutter_actor_get_layout_manager (actor);
+  g_assert (CLUTTER_IS_BOX_LAYOUT (manager));
+  g_assert_cmpuint (clutter_box_layout_get_spacing (CLUTTER_BOX_LAYOUT (manager)), ==, 12);
+
+  /* the children are constructed together with their parent */
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 2);
+
+  child = clutter_actor_get_first_child (actor);
+  g_assert_cmpstr (clutter_get_script_id (G_OBJECT (child)), ==, "first-child");
+  g_assert (clutter_script_get_object (script, "first-child") == G_OBJECT (child));
+  g_assert_cmpfloat (clutter_actor_get_width (child), ==, 100.f);
+
+  child = clutter_actor_get_last_child (actor);
+  constraint = CLUTTER_ACTOR_META (clutter_actor_get_constraint (child, "y-align"));
+  g_assert (CLUTTER_IS_ALIGN_CONSTRAINT (constraint));
+  g_assert_cmpint (clutter_align_constraint_get_align_axis (CLUTTER_ALIGN_CONSTRAINT (constraint)),
+                   ==,
+                   CLUTTER_ALIGN_Y_AXIS);
+  g_assert (clutter_align_constraint_get_source (CLUTTER_ALIGN_CONSTRAINT (constraint)) == actor);
+
+  g_object_unref (script);
+  g_bytes_unref (compiled);
+}
+
+void
+script_compiled_invalid (TestConformSimpleFixture *fixture,
+                         gconstpointer dummy)
+{
+  ClutterScript *script;
+  GError *error = NULL;
+  GBytes *compiled;
+  gchar *data;
+  gsize size;
+  guint merge_id;
+
+  compiled = clutter_script_compile_data (test_ui_definition, -1, &error);
+  g_assert_no_error (error);
+
+  /* corrupt the version of the format, right after the magic */
+  size = g_bytes_get_size (compiled);
+  data = g_memdup (g_bytes_get_data (compiled, NULL), size);
+  memset (data + 8, 0xff, 4);
+
+  script = clutter_script_new ();
+  merge_id = clutter_script_load_from_data (script, data, size, &error);
+  g_assert_error (error, CLUTTER_SCRIPT_ERROR, CLUTTER_SCRIPT_ERROR_INVALID_VALUE);
+  g_assert_cmpuint (merge_id, ==, 0);
+  g_assert (clutter_script_get_object (script, "test-actor") == NULL);
+
+  g_error_free (error);
+  g_object_unref (script);
+  g_free (data);
+  g_bytes_unref (compiled);
+}
@@ -136,9 +136,11 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/actor", actor_replace_child);
   TEST_CONFORM_SIMPLE ("/actor", actor_remove_child);
   TEST_CONFORM_SIMPLE ("/actor", actor_remove_all);
+  TEST_CONFORM_SIMPLE ("/actor", actor_many_children);
   TEST_CONFORM_SIMPLE ("/actor", actor_container_signals);
   TEST_CONFORM_SIMPLE ("/actor", actor_fixed_size);
   TEST_CONFORM_SIMPLE ("/actor", actor_preferred_size);
+  TEST_CONFORM_SIMPLE ("/actor", actor_relayout_root);
 
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_children);
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_remove);
@@ -155,6 +157,9 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/actor/invariants", actor_contains);
   TEST_CONFORM_SIMPLE ("/actor/invariants", actor_pivot_transformation);
 
+  TEST_CONFORM_SIMPLE ("/actor/transform", actor_transform_cache);
+  TEST_CONFORM_SIMPLE ("/actor/transform", actor_transform_override);
+
   TEST_CONFORM_SIMPLE ("/text", text_utf8_validation);
   TEST_CONFORM_SIMPLE ("/text", text_set_empty);
   TEST_CONFORM_SIMPLE ("/text", text_set_text);
@@ -172,10 +177,15 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/interval", interval_initial_state);
   TEST_CONFORM_SIMPLE ("/interval", interval_transform);
 
+  TEST_CONFORM_SIMPLE ("/paint-nodes", paint_nodes_pipeline_siblings);
+
   TEST_CONFORM_SIMPLE ("/path", path_base);
 
   TEST_CONFORM_SIMPLE ("/binding-pool", binding_pool);
 
+  TEST_CONFORM_SIMPLE ("/canvas", canvas_invalidate_rect);
+  TEST_CONFORM_SIMPLE ("/canvas", canvas_async_draw);
+
   TEST_CONFORM_SIMPLE ("/color", color_from_string_valid);
   TEST_CONFORM_SIMPLE ("/color", color_from_string_invalid);
   TEST_CONFORM_SIMPLE ("/color", color_to_string);
@@ -186,6 +196,21 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/units", units_string);
   TEST_CONFORM_SIMPLE ("/units", units_cache);
 
+  TEST_CONFORM_SIMPLE ("/frame-timings", frame_timings_records);
+
+  TEST_CONFORM_SIMPLE ("/image", image_load_async);
+  TEST_CONFORM_SIMPLE ("/image", image_load_async_cancel);
+  TEST_CONFORM_SIMPLE ("/image", image_load_async_invalid);
+
+  TEST_CONFORM_SIMPLE ("/model", model_rows_freeze_thaw);
+  TEST_CONFORM_SIMPLE ("/model", model_rows_remove_frozen);
+  TEST_CONFORM_SIMPLE ("/model", model_rows_resort_row);
+  TEST_CONFORM_SIMPLE ("/model", model_rows_resort_row_filtered);
+  TEST_CONFORM_SIMPLE ("/model", model_rows_filter);
+
+  TEST_CONFORM_SIMPLE ("/script", script_compiled_load);
+  TEST_CONFORM_SIMPLE ("/script", script_compiled_invalid);
+
   TEST_CONFORM_SIMPLE ("/timeline", timeline_base);
   TEST_CONFORM_SIMPLE ("/timeline", timeline_markers_from_script);
   TEST_CONFORM_SKIP (g_test_slow (), "/timeline", timeline_interpolation);
@@ -194,6 +219,10 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/timeline", timeline_progress_step);
 
   TEST_CONFORM_SIMPLE ("/events", events_touch);
+  TEST_CONFORM_SIMPLE ("/events", events_motion_history);
+  TEST_CONFORM_SIMPLE ("/events", events_motion_history_touch);
+
+  TEST_CONFORM_SIMPLE ("/cally", cally_children);
 
   /* FIXME - see bug https://bugzilla.gnome.org/show_bug.cgi?id=655588 */
   TEST_CONFORM_TODO ("/cally", cally_text);
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_CHILDREN      100000
+
+static gint n_children = N_CHILDREN;
+static gboolean use_depth = FALSE;
+
+static GOptionEntry entries[] = {
+  {
+    "num-children", 'n',
+    0,
+    G_OPTION_ARG_INT, &n_children,
+    "Number of children", "CHILDREN"
+  },
+  {
+    "depth", 'd',
+    0,
+    G_OPTION_ARG_NONE, &use_depth,
+    "Give the children different depths", NULL
+  },
+  { NULL }
+};
+
+static void
+print_time (const char *operation,
+            gint64      start_time)
+{
+  gint64 elapsed = g_get_monotonic_time () - start_time;
+
+  printf ("%-24s %8.3f ms, %8.1f ns per child\n",
+          operation,
+          elapsed / 1000.0,
+          elapsed * 1000.0 / n_children);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *actor;
+  GError *error = NULL;
+  gint64 start_time;
+  gint i;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Children performance test with %d children\n", n_children);
+
+  actor = clutter_actor_new ();
+  g_object_ref_sink (actor);
+
+  start_time = g_get_monotonic_time ();
+  for (i = 0; i < n_children; i++)
+    {
+      ClutterActor *child = clutter_actor_new ();
+
+      if (use_depth)
+        clutter_actor_set_z_position (child, g_random_int_range (0, 100));
+
+      clutter_actor_add_child (actor, child);
+    }
+  print_time ("add_child", start_time);
+
+  start_time = g_get_monotonic_time ();
+  for (i = 0; i < n_children; i++)
+    clutter_actor_get_child_at_index (actor, g_random_int_range (0, n_children));
+  print_time ("get_child_at_index", start_time);
+
+  start_time = g_get_monotonic_time ();
+  for (i = 0; i < n_children; i++)
+    {
+      ClutterActor *child;
+
+      child = clutter_actor_get_child_at_index (actor, g_random_int_range (0, n_children));
+      clutter_actor_set_child_at_index (actor, child, g_random_int_range (0, n_children));
+    }
+  print_time ("set_child_at_index", start_time);
+
+  start_time = g_get_monotonic_time ();
+  while (clutter_actor_get_n_children (actor) > 0)
+    {
+      gint n = clutter_actor_get_n_children (actor);
+
+      clutter_actor_remove_child (actor,
+                                  clutter_actor_get_child_at_index (actor, n / 2));
+    }
+  print_time ("remove_child", start_time);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (actor);
+
+  return EXIT_SUCCESS;
+}
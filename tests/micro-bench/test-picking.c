@@ -1,5 +1,6 @@
 
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <clutter/clutter.h>
 
@@ -9,6 +10,12 @@
 static gint n_actors = N_ACTORS;
 static gint n_events = N_EVENTS;
 
+static GTimer *pick_timer = NULL;
+static gdouble pixel_pick_time = 0.0;
+static gdouble geometric_pick_time = 0.0;
+static gint n_frames = 0;
+static gint n_mismatches = 0;
+
 static GOptionEntry entries[] = {
   {
     "num-actors", 'a',
@@ -31,6 +38,31 @@ motion_event_cb (ClutterActor *actor, ClutterEvent *event, gpointer user_data)
   return FALSE;
 }
 
+static ClutterActor *
+do_pick (ClutterActor *stage,
+         gboolean      geometric,
+         gint          x,
+         gint          y,
+         gdouble      *elapsed)
+{
+  ClutterActor *actor;
+
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (stage), geometric);
+
+  g_timer_start (pick_timer);
+
+  /* If we synthesized events, they would be motion compressed;
+   * calling get_actor_at_position() doesn't have that problem
+   */
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          x, y);
+
+  *elapsed += g_timer_elapsed (pick_timer, NULL);
+
+  return actor;
+}
+
 static void
 do_events (ClutterActor *stage)
 {
@@ -39,17 +71,33 @@ do_events (ClutterActor *stage)
 
   for (i = 0; i < n_events; i++)
     {
+      ClutterActor *pixel_actor, *geometric_actor;
+      gint x, y;
+
       angle += (2.0 * G_PI) / (gdouble)n_actors;
       while (angle > G_PI * 2.0)
         angle -= G_PI * 2.0;
 
-      /* If we synthesized events, they would be motion compressed;
-       * calling get_actor_at_position() doesn't have that problem
-       */
-      clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
-				      CLUTTER_PICK_REACTIVE,
-				      256.0 + 206.0 * cos (angle),
-				      256.0 + 206.0 * sin (angle));
+      x = 256.0 + 206.0 * cos (angle);
+      y = 256.0 + 206.0 * sin (angle);
+
+      pixel_actor = do_pick (stage, FALSE, x, y, &pixel_pick_time);
+      geometric_actor = do_pick (stage, TRUE, x, y, &geometric_pick_time);
+
+      if (pixel_actor != geometric_actor)
+        n_mismatches++;
+    }
+
+  if (++n_frames % 100 == 0)
+    {
+      gdouble n_picks = n_frames * n_events;
+
+      printf ("pixel pick: %.3f ms, geometric pick: %.3f ms "
+              "(average over %d picks, %d mismatches)\n",
+              pixel_pick_time * 1000.0 / n_picks,
+              geometric_pick_time * 1000.0 / n_picks,
+              (int) n_picks,
+              n_mismatches);
     }
 }
 
@@ -89,7 +137,7 @@ main (int argc, char **argv)
 
   stage = clutter_stage_new ();
   clutter_actor_set_size (stage, 512, 512);
-  clutter_stage_set_color (CLUTTER_STAGE (stage), CLUTTER_COLOR_Black);
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
   clutter_stage_set_title (CLUTTER_STAGE (stage), "Picking");
 
   printf ("Picking performance test with "
@@ -110,10 +158,10 @@ main (int argc, char **argv)
                    fmod ((i + (n_actors/3.0)), n_actors)))) /
                    (gdouble)(n_actors/4.0) - 1.0)) * 255.0;
 
-      rect = clutter_rectangle_new_with_color (&color);
+      rect = clutter_actor_new ();
+      clutter_actor_set_background_color (rect, &color);
       clutter_actor_set_size (rect, 100, 100);
-      clutter_actor_set_anchor_point_from_gravity (rect,
-                                                   CLUTTER_GRAVITY_CENTER);
+      clutter_actor_set_translation (rect, -50.f, -50.f, 0.f);
       clutter_actor_set_position (rect,
                                   256 + 206 * cos (angle),
                                   256 + 206 * sin (angle));
@@ -121,9 +169,11 @@ main (int argc, char **argv)
       g_signal_connect (rect, "motion-event",
                         G_CALLBACK (motion_event_cb), NULL);
 
-      clutter_container_add_actor (CLUTTER_CONTAINER (stage), rect);
+      clutter_actor_add_child (stage, rect);
     }
 
+  pick_timer = g_timer_new ();
+
   clutter_actor_show (stage);
 
   clutter_threads_add_idle (queue_redraw, stage);
@@ -134,6 +184,8 @@ main (int argc, char **argv)
 
   clutter_actor_destroy (stage);
 
+  g_timer_destroy (pick_timer);
+
   return 0;
 }
 
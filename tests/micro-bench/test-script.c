@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include <clutter/clutter.h>
+
+#define N_ACTORS        10000
+#define N_ITERATIONS    10
+
+static gint n_actors = N_ACTORS;
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-actors", 'n',
+    0,
+    G_OPTION_ARG_INT, &n_actors,
+    "Number of actors in the UI definition", "ACTORS"
+  },
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of times each definition is loaded", "ITERATIONS"
+  },
+  { NULL }
+};
+
+static const char *colors[] = {
+  "red", "#00ff00", "#0000ffc0", "#ffffff"
+};
+
+static gchar *
+build_definition (void)
+{
+  GString *str = g_string_new (NULL);
+  gint i;
+
+  g_string_append (str,
+                   "[\n"
+                   "  {\n"
+                   "    \"id\" : \"root\",\n"
+                   "    \"type\" : \"ClutterActor\",\n"
+                   "    \"children\" : [\n");
+
+  for (i = 0; i < n_actors; i++)
+    {
+      g_string_append_printf (str,
+                              "      {\n"
+                              "        \"id\" : \"actor-%d\",\n"
+                              "        \"type\" : \"ClutterActor\",\n"
+                              "        \"x\" : %d, \"y\" : %d,\n"
+                              "        \"width\" : 32, \"height\" : 32,\n"
+                              "        \"background-color\" : \"%s\",\n"
+                              "        \"request-mode\" : \"height-for-width\",\n"
+                              "        \"reactive\" : %s\n"
+                              "      }%s\n",
+                              i,
+                              (i % 100) * 32, (i / 100) * 32,
+                              colors[i % G_N_ELEMENTS (colors)],
+                              (i % 2) == 0 ? "true" : "false",
+                              i < n_actors - 1 ? "," : "");
+    }
+
+  g_string_append (str,
+                   "    ]\n"
+                   "  }\n"
+                   "]\n");
+
+  return g_string_free (str, FALSE);
+}
+
+static gchar *
+write_temp_file (const char    *template,
+                 gconstpointer  data,
+                 gsize          length)
+{
+  GError *error = NULL;
+  gchar *filename;
+  gint fd;
+
+  fd = g_file_open_tmp (template, &filename, &error);
+  if (fd < 0)
+    g_error ("Unable to create a temporary file: %s", error->message);
+
+  close (fd);
+
+  if (!g_file_set_contents (filename, data, length, &error))
+    g_error ("Unable to write '%s': %s", filename, error->message);
+
+  return filename;
+}
+
+static void
+load_definition (const char *operation,
+                 const char *filename)
+{
+  gint64 elapsed = 0;
+  gint i;
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      ClutterScript *script = clutter_script_new ();
+      GError *error = NULL;
+      GObject *root;
+      gint64 start_time;
+
+      start_time = g_get_monotonic_time ();
+
+      if (clutter_script_load_from_file (script, filename, &error) == 0)
+        g_error ("Unable to load '%s': %s", filename, error->message);
+
+      root = clutter_script_get_object (script, "root");
+
+      elapsed += g_get_monotonic_time () - start_time;
+
+      g_assert (CLUTTER_IS_ACTOR (root));
+      g_assert (clutter_actor_get_n_children (CLUTTER_ACTOR (root)) == n_actors);
+
+      clutter_actor_destroy (CLUTTER_ACTOR (root));
+      g_object_unref (script);
+    }
+
+  printf ("%-24s %8.3f ms, %8.1f ns per actor\n",
+          operation,
+          elapsed / 1000.0 / n_iterations,
+          elapsed * 1000.0 / n_iterations / n_actors);
+}
+
+int
+main (int argc, char **argv)
+{
+  gchar *definition, *json_file, *binary_file;
+  GError *error = NULL;
+  GBytes *compiled;
+  gint64 start_time;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Script loading test with %d actors, %d iterations\n",
+          n_actors,
+          n_iterations);
+
+  definition = build_definition ();
+  json_file = write_temp_file ("test-script-XXXXXX.json",
+                               definition,
+                               strlen (definition));
+
+  start_time = g_get_monotonic_time ();
+  compiled = clutter_script_compile_data (definition, -1, &error);
+  if (compiled == NULL)
+    g_error ("Unable to compile the definition: %s", error->message);
+
+  printf ("%-24s %8.3f ms\n",
+          "compile_data",
+          (g_get_monotonic_time () - start_time) / 1000.0);
+
+  binary_file = write_temp_file ("test-script-XXXXXX.bin",
+                                 g_bytes_get_data (compiled, NULL),
+                                 g_bytes_get_size (compiled));
+
+  printf ("%-24s %8.1f kB JSON, %8.1f kB binary\n",
+          "size",
+          strlen (definition) / 1024.0,
+          g_bytes_get_size (compiled) / 1024.0);
+
+  load_definition ("load_from_file (JSON)", json_file);
+  load_definition ("load_from_file (binary)", binary_file);
+
+  g_unlink (json_file);
+  g_unlink (binary_file);
+
+  g_free (json_file);
+  g_free (binary_file);
+  g_bytes_unref (compiled);
+  g_free (definition);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_TRANSITIONS   10000
+#define N_STEPS         4
+#define N_SECONDS       2
+
+static gint n_transitions = N_TRANSITIONS;
+static gint n_steps = N_STEPS;
+static gint n_seconds = N_SECONDS;
+static gboolean use_linear = FALSE;
+
+static gint n_running = 0;
+
+static GOptionEntry entries[] = {
+  {
+    "num-transitions", 'n',
+    0,
+    G_OPTION_ARG_INT, &n_transitions,
+    "Maximum number of transitions", "TRANSITIONS"
+  },
+  {
+    "num-steps", 't',
+    0,
+    G_OPTION_ARG_INT, &n_steps,
+    "Number of steps to reach the maximum number of transitions", "STEPS"
+  },
+  {
+    "seconds", 's',
+    0,
+    G_OPTION_ARG_INT, &n_seconds,
+    "Number of seconds to run each step", "SECONDS"
+  },
+  {
+    "linear", 'l',
+    0,
+    G_OPTION_ARG_NONE, &use_linear,
+    "Use a linear progress mode", NULL
+  },
+  { NULL }
+};
+
+static void
+add_transitions (gint n)
+{
+  gint i;
+
+  /* the actors are not added to the stage, as we only want to
+   * measure the cost of advancing the transitions
+   */
+  for (i = 0; i < n; i++)
+    {
+      ClutterActor *actor = clutter_actor_new ();
+      ClutterTransition *transition;
+
+      g_object_ref_sink (actor);
+
+      transition = clutter_property_transition_new ("opacity");
+      clutter_transition_set_from (transition, G_TYPE_UINT, 0);
+      clutter_transition_set_to (transition, G_TYPE_UINT, 255);
+      clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 2000);
+      clutter_timeline_set_repeat_count (CLUTTER_TIMELINE (transition), -1);
+      clutter_timeline_set_auto_reverse (CLUTTER_TIMELINE (transition), TRUE);
+      clutter_timeline_set_progress_mode (CLUTTER_TIMELINE (transition),
+                                          use_linear
+                                            ? CLUTTER_LINEAR
+                                            : CLUTTER_EASE_IN_OUT_CUBIC);
+
+      clutter_actor_add_transition (actor, "opacity-bench", transition);
+      g_object_unref (transition);
+    }
+
+  n_running += n;
+}
+
+static void
+print_results (void)
+{
+  ClutterFrameRecord *records;
+  guint n_records, i;
+  gint64 timelines_time = 0;
+  gdouble avg;
+
+  n_records = clutter_frame_timings_get_n_records ();
+  if (n_records == 0)
+    {
+      printf ("%6d transitions: no frames recorded\n", n_running);
+      return;
+    }
+
+  records = g_new (ClutterFrameRecord, n_records);
+  n_records = clutter_frame_timings_get_records (records, n_records);
+
+  for (i = 0; i < n_records; i++)
+    timelines_time += records[i].timelines_time;
+
+  avg = (gdouble) timelines_time / n_records;
+
+  printf ("%6d transitions: %8.3f ms per frame, %6.1f ns per transition "
+          "(average over %u frames)\n",
+          n_running,
+          avg / 1000.0,
+          avg * 1000.0 / n_running,
+          n_records);
+
+  g_free (records);
+}
+
+/* measures each step for the given number of seconds, then adds
+ * more transitions; the cost per transition should stay the same
+ * as the number of transitions grows
+ */
+static gboolean
+next_step (gpointer data G_GNUC_UNUSED)
+{
+  print_results ();
+
+  if (n_running >= n_transitions)
+    {
+      clutter_main_quit ();
+      return G_SOURCE_REMOVE;
+    }
+
+  add_transitions (n_transitions / n_steps);
+  clutter_frame_timings_reset ();
+
+  return G_SOURCE_CONTINUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage;
+  GError *error = NULL;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  n_steps = CLAMP (n_steps, 1, n_transitions);
+
+  stage = clutter_stage_new ();
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Timelines");
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+
+  printf ("Timelines performance test with up to %d transitions, "
+          "in %d steps of %d seconds\n",
+          n_transitions,
+          n_steps,
+          n_seconds);
+
+  add_transitions (n_transitions / n_steps);
+
+  clutter_actor_show (stage);
+
+  clutter_frame_timings_set_enabled (TRUE);
+
+  clutter_threads_add_timeout (n_seconds * 1000, next_step, NULL);
+
+  clutter_main ();
+
+  return EXIT_SUCCESS;
+}